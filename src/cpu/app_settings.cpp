@@ -56,7 +56,17 @@
 
 void AppSettings::save(std::filesystem::path const &filepath) {
     auto json = nlohmann::json{};
+    save_json(json);
+    auto f = std::ofstream(filepath);
+    f << std::setw(4) << json;
+}
 
+void AppSettings::load(std::filesystem::path const &filepath) {
+    clear();
+    load_json(nlohmann::json::parse(std::ifstream(filepath)));
+}
+
+void AppSettings::save_json(nlohmann::json &json) const {
     json["_version"] = 1;
     json["ui_scl"] = ui_scl;
     json["camera_fov"] = camera_fov;
@@ -69,6 +79,14 @@ void AppSettings::save(std::filesystem::path const &filepath) {
     json["show_help"] = show_help;
     json["autosave"] = autosave;
     json["battery_saving_mode"] = battery_saving_mode;
+    json["alias_transients"] = alias_transients;
+    json["dynamic_resolution"] = dynamic_resolution;
+    json["dynamic_resolution_target_fps"] = dynamic_resolution_target_fps;
+    json["dynamic_resolution_min_scale"] = dynamic_resolution_min_scale;
+    json["present_mode"] = present_mode;
+    json["fps_limit"] = fps_limit;
+    json["low_latency_input"] = low_latency_input;
+    json["late_latch_input"] = late_latch_input;
 
     json["sky_absorption_density_0_const_term"] = sky.absorption_density[0].const_term;
     json["sky_absorption_density_0_exp_scale"] = sky.absorption_density[0].exp_scale;
@@ -127,6 +145,8 @@ void AppSettings::save(std::filesystem::path const &filepath) {
     json["auto_exposure_speed"] = auto_exposure.speed;
     json["auto_exposure_ev_shift"] = auto_exposure.ev_shift;
 
+    tunables.save_json(json);
+
     for (auto [key_i, action_i] : keybinds) {
         auto str = fmt::format("key_{}", key_i);
         json[str] = action_i;
@@ -135,16 +155,10 @@ void AppSettings::save(std::filesystem::path const &filepath) {
         auto str = fmt::format("mouse_button_{}", mouse_button_i);
         json[str] = action_i;
     }
-
-    auto f = std::ofstream(filepath);
-    f << std::setw(4) << json;
 }
 
-void AppSettings::load(std::filesystem::path const &filepath) {
-    clear();
-
-    auto json = nlohmann::json::parse(std::ifstream(filepath));
-
+// Only overwrites the values present in `json`
+void AppSettings::load_json(nlohmann::json const &json) {
     auto grab_value = [&json](auto str, auto &val) {
         if (json.contains(str)) {
             val = json[str];
@@ -162,6 +176,14 @@ void AppSettings::load(std::filesystem::path const &filepath) {
     grab_value("show_help", show_help);
     grab_value("autosave", autosave);
     grab_value("battery_saving_mode", battery_saving_mode);
+    grab_value("alias_transients", alias_transients);
+    grab_value("dynamic_resolution", dynamic_resolution);
+    grab_value("dynamic_resolution_target_fps", dynamic_resolution_target_fps);
+    grab_value("dynamic_resolution_min_scale", dynamic_resolution_min_scale);
+    grab_value("present_mode", present_mode);
+    grab_value("fps_limit", fps_limit);
+    grab_value("low_latency_input", low_latency_input);
+    grab_value("late_latch_input", late_latch_input);
 
     grab_value("sky_absorption_density_0_const_term", sky.absorption_density[0].const_term);
     grab_value("sky_absorption_density_0_exp_scale", sky.absorption_density[0].exp_scale);
@@ -221,6 +243,8 @@ void AppSettings::load(std::filesystem::path const &filepath) {
     grab_value("auto_exposure_speed", auto_exposure.speed);
     grab_value("auto_exposure_ev_shift", auto_exposure.ev_shift);
 
+    tunables.load_json(json);
+
     for (daxa_i32 key_i = 0; key_i < GLFW_KEY_LAST + 1; ++key_i) {
         auto str = fmt::format("key_{}", key_i);
         if (json.contains(str)) {
@@ -248,12 +272,22 @@ void AppSettings::clear() {
     show_help = false;
     autosave = true;
     battery_saving_mode = false;
+    alias_transients = true;
+    dynamic_resolution = false;
+    dynamic_resolution_target_fps = 60.0f;
+    dynamic_resolution_min_scale = 0.5f;
+    present_mode = 0;
+    fps_limit = 0.0f;
+    low_latency_input = false;
+    late_latch_input = false;
 
     keybinds.clear();
     mouse_button_binds.clear();
 
     sky = {};
     recompute_sun_direction();
+
+    tunables = {};
 }
 
 void AppSettings::reset_default() {
@@ -4,8 +4,11 @@
 #include <filesystem>
 
 #include <GLFW/glfw3.h>
+#include <nlohmann/json_fwd.hpp>
 #include <shared/settings.inl>
 
+#include "tunables.hpp"
+
 enum struct RenderResScl {
     SCL_33_PCT,
     SCL_50_PCT,
@@ -29,14 +32,26 @@ struct AppSettings {
 
     AutoExposureSettings auto_exposure;
 
+    Tunables tunables;
+
     bool show_debug_info;
     bool show_console;
     bool show_help;
     bool autosave;
     bool battery_saving_mode;
+    bool alias_transients;
+    bool dynamic_resolution;
+    daxa_f32 dynamic_resolution_target_fps;
+    daxa_f32 dynamic_resolution_min_scale;
+    daxa_i32 present_mode;
+    daxa_f32 fps_limit;
+    bool low_latency_input;
+    bool late_latch_input;
 
     void save(std::filesystem::path const &filepath);
     void load(std::filesystem::path const &filepath);
+    void save_json(nlohmann::json &json) const;
+    void load_json(nlohmann::json const &json);
     void clear();
     void reset_default();
 
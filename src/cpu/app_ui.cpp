@@ -1,4 +1,6 @@
 #include "app_ui.hpp"
+#include "cpu_profiler.hpp"
+#include "startup_timer.hpp"
 
 #include <imgui_stdlib.h>
 #include <imgui_impl_glfw.h>
@@ -6,6 +8,10 @@
 #include <sago/platform_folders.h>
 #include <nfd.h>
 
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <optional>
 #include <vector>
 #include <iostream>
 
@@ -115,10 +121,146 @@ static void Strtrim(char *s) {
     *str_end = 0;
 }
 
+// Splits on whitespace. Double quotes group words, for paths with spaces in them.
+static auto tokenize_command(std::string_view line) -> std::vector<std::string> {
+    auto result = std::vector<std::string>{};
+    auto token = std::string{};
+    auto in_token = false;
+    auto in_quotes = false;
+    for (auto c : line) {
+        if (c == '"') {
+            in_quotes = !in_quotes;
+            in_token = true;
+        } else if (!in_quotes && (c == ' ' || c == '\t')) {
+            if (in_token) {
+                result.push_back(std::move(token));
+                token.clear();
+                in_token = false;
+            }
+        } else {
+            token += c;
+            in_token = true;
+        }
+    }
+    if (in_token) {
+        result.push_back(std::move(token));
+    }
+    return result;
+}
+
+static auto parse_command_arg(std::string const &token, AppUi::Console::CommandArg::Type type) -> std::optional<AppUi::Console::CommandArgValue> {
+    using Type = AppUi::Console::CommandArg::Type;
+    switch (type) {
+    case Type::INT: {
+        auto value = daxa_i32{};
+        auto [end, ec] = std::from_chars(token.data(), token.data() + token.size(), value);
+        if (ec != std::errc{} || end != token.data() + token.size()) {
+            return std::nullopt;
+        }
+        return value;
+    }
+    case Type::FLOAT: {
+        char *end = nullptr;
+        auto value = std::strtof(token.c_str(), &end);
+        if (token.empty() || end != token.c_str() + token.size()) {
+            return std::nullopt;
+        }
+        return value;
+    }
+    case Type::BOOL: {
+        if (token == "1" || token == "on" || token == "true") {
+            return true;
+        }
+        if (token == "0" || token == "off" || token == "false") {
+            return false;
+        }
+        return std::nullopt;
+    }
+    case Type::STRING: return token;
+    }
+    return std::nullopt;
+}
+
+static auto command_usage(AppUi::Console::Command const &command) -> std::string {
+    using Type = AppUi::Console::CommandArg::Type;
+    auto result = command.name;
+    for (auto const &arg : command.args) {
+        auto const *type_name = "string";
+        switch (arg.type) {
+        case Type::INT: type_name = "int"; break;
+        case Type::FLOAT: type_name = "float"; break;
+        case Type::BOOL: type_name = "on/off"; break;
+        case Type::STRING: break;
+        }
+        if (arg.is_optional) {
+            result += fmt::format(" [{}: {}]", arg.name, type_name);
+        } else {
+            result += fmt::format(" <{}: {}>", arg.name, type_name);
+        }
+    }
+    return result;
+}
+
 AppUi::Console::Console() {
     s_instance = this;
     clear_log();
     memset(input_buffer, 0, sizeof(input_buffer));
+
+    using Type = CommandArg::Type;
+    auto command_names = []() {
+        auto result = std::vector<std::string>{};
+        for (auto const &command : s_instance->commands) {
+            result.push_back(command.name);
+        }
+        return result;
+    };
+    add_command({
+        .name = "help",
+        .help = "Lists the commands, or describes one",
+        .args = {{.name = "command", .type = Type::STRING, .is_optional = true, .completions = command_names}},
+        .callback = [](Console &console, CommandArgs const &args) {
+            if (args.has(0)) {
+                auto const *command = console.find_command(args.get<std::string>(0));
+                if (command == nullptr) {
+                    Logger::log(LogLevel::ERR, "console", fmt::format("[error] Unknown command: '{}'", args.get<std::string>(0)));
+                    return;
+                }
+                console.add_log(fmt::format("{}\n    {}", command_usage(*command), command->help));
+                return;
+            }
+            for (auto const &command : console.commands) {
+                console.add_log(fmt::format("{} - {}", command_usage(command), command.help));
+            }
+        },
+    });
+    add_command({
+        .name = "clear",
+        .help = "Clears the log",
+        .callback = [](Console &console, CommandArgs const &) { console.clear_log(); },
+    });
+    add_command({
+        .name = "history",
+        .help = "Lists the previously entered commands",
+        .callback = [](Console &console, CommandArgs const &) {
+            for (auto const *line : console.history) {
+                console.add_log(fmt::format("- {}", line));
+            }
+        },
+    });
+    add_command({
+        .name = "exec",
+        .help = "Runs a script of commands, one per line",
+        .args = {{.name = "path", .type = Type::STRING}},
+        .callback = [](Console &console, CommandArgs const &args) { console.exec_script(args.get<std::string>(0)); },
+    });
+    add_command({
+        .name = "wait",
+        .help = "Pauses the script that runs it for a number of frames",
+        .args = {{.name = "frames", .type = Type::INT}},
+        .callback = [](Console &console, CommandArgs const &args) {
+            console.script_wait_frame_n = static_cast<daxa_u32>(std::max(args.get<daxa_i32>(0), 0));
+        },
+    });
 }
 
 AppUi::Console::~Console() {
@@ -142,16 +284,17 @@ AppUi::DebugDisplay::~DebugDisplay() {
 }
 
 void AppUi::Console::clear_log() {
-    auto lock = std::lock_guard{*items_mtx};
-    items.clear();
+    logger->clear_history();
 }
 
-void AppUi::Console::add_log(std::string const &str) {
-    {
-        auto lock = std::lock_guard{*items_mtx};
-        items.push_back(str);
+void AppUi::Console::add_log(std::string str) {
+    auto level = LogLevel::INFO;
+    if (str.find("[error]") != std::string::npos) {
+        level = LogLevel::ERR;
+    } else if (str.find("[warning]") != std::string::npos) {
+        level = LogLevel::WARN;
     }
-    std::cout << str << std::endl;
+    Logger::log(level, "app", std::move(str));
 }
 
 void AppUi::Console::draw(const char *title, bool *p_open) {
@@ -181,6 +324,9 @@ void AppUi::Console::draw(const char *title, bool *p_open) {
     }
     ImGui::SameLine();
     filter.Draw(R"(Filter ("incl,-excl") ("error"))", 180);
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(80);
+    ImGui::Combo("Level", &min_level, "trace\0info\0warn\0error\0");
     ImGui::Separator();
     const float footer_height_to_reserve = ImGui::GetStyle().ItemSpacing.y + ImGui::GetFrameHeightWithSpacing();
     ImGui::BeginChild("ScrollingRegion", ImVec2(0, -footer_height_to_reserve), false, ImGuiWindowFlags_HorizontalScrollbar);
@@ -195,27 +341,52 @@ void AppUi::Console::draw(const char *title, bool *p_open) {
         ImGui::LogToClipboard();
     }
     {
-        auto lock = std::lock_guard{*items_mtx};
-        for (auto const &item : items) {
-            if (!filter.PassFilter(item.c_str())) {
-                continue;
-            }
+        auto lock = std::lock_guard{logger->history_mtx};
+        auto draw_record = [](Logger::Record const &record) {
             ImVec4 color;
             bool has_color = false;
-            if (strstr(item.c_str(), "[error]") != nullptr) {
+            if (record.level == LogLevel::ERR) {
                 color = ImVec4(1.0f, 0.4f, 0.4f, 1.0f);
                 has_color = true;
-            } else if (strncmp(item.c_str(), "# ", 2) == 0) {
+            } else if (record.level == LogLevel::WARN) {
+                color = ImVec4(1.0f, 0.9f, 0.4f, 1.0f);
+                has_color = true;
+            } else if (strncmp(record.text.c_str(), "# ", 2) == 0) {
                 color = ImVec4(1.0f, 0.8f, 0.6f, 1.0f);
                 has_color = true;
             }
             if (has_color) {
                 ImGui::PushStyleColor(ImGuiCol_Text, color);
             }
-            ImGui::TextUnformatted(item.c_str());
+            if (strcmp(record.category, "app") == 0) {
+                ImGui::TextUnformatted(record.text.c_str());
+            } else {
+                ImGui::Text("[%s] %s", record.category, record.text.c_str());
+            }
             if (has_color) {
                 ImGui::PopStyleColor();
             }
+        };
+        // Only the visible part of the history is drawn, unless it's all being copied
+        auto visible_records = std::vector<Logger::Record const *>{};
+        visible_records.reserve(logger->history.size());
+        for (auto const &record : logger->history) {
+            if (static_cast<int>(record.level) >= min_level && filter.PassFilter(record.text.c_str())) {
+                visible_records.push_back(&record);
+            }
+        }
+        if (copy_to_clipboard) {
+            for (auto const *record : visible_records) {
+                draw_record(*record);
+            }
+        } else {
+            auto clipper = ImGuiListClipper{};
+            clipper.Begin(static_cast<int>(visible_records.size()));
+            while (clipper.Step()) {
+                for (auto i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                    draw_record(*visible_records[static_cast<size_t>(i)]);
+                }
+            }
         }
     }
     if (copy_to_clipboard) {
@@ -251,8 +422,24 @@ void AppUi::Console::draw(const char *title, bool *p_open) {
     ImGui::End();
 }
 
-void AppUi::Console::exec_command(const char *command_line) {
-    add_log(fmt::format("# {}\n", command_line));
+void AppUi::Console::add_command(Command command) {
+    if (auto *existing = find_command(command.name)) {
+        *existing = std::move(command);
+        return;
+    }
+    commands.push_back(std::move(command));
+}
+
+auto AppUi::Console::find_command(std::string_view name) -> Command * {
+    for (auto &command : commands) {
+        if (Stricmp(command.name.c_str(), std::string{name}.c_str()) == 0) {
+            return &command;
+        }
+    }
+    return nullptr;
+}
+
+auto AppUi::Console::exec_command(const char *command_line) -> bool {
     history_pos = -1;
     for (daxa_i32 i = static_cast<daxa_i32>(history.size()) - 1; i >= 0; i--) {
         if (Stricmp(history[static_cast<size_t>(i)], command_line) == 0) {
@@ -262,8 +449,76 @@ void AppUi::Console::exec_command(const char *command_line) {
         }
     }
     history.push_back(Strdup(command_line));
-    add_log(fmt::format("Unknown command: '{}'\n", command_line));
     scroll_to_bottom = true;
+    return run_command(command_line);
+}
+
+auto AppUi::Console::run_command(std::string_view command_line) -> bool {
+    add_log(fmt::format("# {}", command_line));
+    auto tokens = tokenize_command(command_line);
+    if (tokens.empty()) {
+        return false;
+    }
+    auto *command = find_command(tokens[0]);
+    if (command == nullptr) {
+        Logger::log(LogLevel::ERR, "console", fmt::format("[error] Unknown command: '{}'. Type 'help' for a list.", tokens[0]));
+        return false;
+    }
+    auto const arg_n = tokens.size() - 1;
+    auto const required_arg_n = static_cast<size_t>(std::count_if(command->args.begin(), command->args.end(), [](CommandArg const &arg) { return !arg.is_optional; }));
+    if (arg_n < required_arg_n || arg_n > command->args.size()) {
+        Logger::log(LogLevel::ERR, "console", fmt::format("[error] Usage: {}", command_usage(*command)));
+        return false;
+    }
+    auto args = CommandArgs{};
+    for (size_t i = 0; i < arg_n; ++i) {
+        auto value = parse_command_arg(tokens[i + 1], command->args[i].type);
+        if (!value.has_value()) {
+            Logger::log(LogLevel::ERR, "console", fmt::format("[error] Bad value '{}' for {}. Usage: {}", tokens[i + 1], command->args[i].name, command_usage(*command)));
+            return false;
+        }
+        args.values.push_back(std::move(*value));
+    }
+    // The callback may add commands, so it's copied out first
+    auto callback = command->callback;
+    callback(*this, args);
+    return true;
+}
+
+auto AppUi::Console::exec_script(std::filesystem::path const &path) -> bool {
+    auto file = std::ifstream(path);
+    if (!file.is_open()) {
+        Logger::log(LogLevel::ERR, "console", fmt::format("[error] Failed to open script '{}'", path.string()));
+        return false;
+    }
+    auto lines = std::vector<std::string>{};
+    for (auto line = std::string{}; std::getline(file, line);) {
+        lines.push_back(std::move(line));
+    }
+    // Queued in front of whatever is left, so a script run from another script finishes first
+    script_lines.insert(script_lines.begin(), lines.begin(), lines.end());
+    run_script();
+    return true;
+}
+
+void AppUi::Console::update_script() {
+    if (script_wait_frame_n > 0 && --script_wait_frame_n > 0) {
+        return;
+    }
+    run_script();
+}
+
+void AppUi::Console::run_script() {
+    while (script_wait_frame_n == 0 && !script_lines.empty()) {
+        auto line = std::move(script_lines.front());
+        script_lines.pop_front();
+        auto const first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+        auto const last = line.find_last_not_of(" \t\r");
+        run_command(std::string_view{line}.substr(first, last - first + 1));
+    }
 }
 
 auto AppUi::Console::on_text_edit(ImGuiInputTextCallbackData *data) -> int {
@@ -278,10 +533,28 @@ auto AppUi::Console::on_text_edit(ImGuiInputTextCallbackData *data) -> int {
             }
             word_start--;
         }
-        ImVector<const char *> candidates;
-        for (auto &command : commands) {
-            if (Strnicmp(command, word_start, static_cast<daxa_i32>(word_end - word_start)) == 0) {
-                candidates.push_back(command);
+        // The first word completes to a command name, and the rest to that command's arguments
+        auto const previous_tokens = tokenize_command(std::string_view{data->Buf, static_cast<size_t>(word_start - data->Buf)});
+        auto options = std::vector<std::string>{};
+        if (previous_tokens.empty()) {
+            for (auto const &command : commands) {
+                options.push_back(command.name);
+            }
+        } else if (auto const *command = find_command(previous_tokens[0])) {
+            auto const arg_i = previous_tokens.size() - 1;
+            if (arg_i < command->args.size()) {
+                auto const &arg = command->args[arg_i];
+                if (arg.completions) {
+                    options = arg.completions();
+                } else if (arg.type == CommandArg::Type::BOOL) {
+                    options = {"on", "off"};
+                }
+            }
+        }
+        auto candidates = std::vector<char const *>{};
+        for (auto const &option : options) {
+            if (Strnicmp(option.c_str(), word_start, static_cast<daxa_i32>(word_end - word_start)) == 0) {
+                candidates.push_back(option.c_str());
             }
         }
         if (candidates.empty()) {
@@ -295,7 +568,7 @@ auto AppUi::Console::on_text_edit(ImGuiInputTextCallbackData *data) -> int {
             for (;;) {
                 int c = 0;
                 bool all_candidates_matches = true;
-                for (int i = 0; i < candidates.size() && all_candidates_matches; i++) {
+                for (size_t i = 0; i < candidates.size() && all_candidates_matches; i++) {
                     if (i == 0) {
                         c = toupper(candidates[i][match_len]);
                     } else if (c == 0 || c != toupper(candidates[i][match_len])) {
@@ -430,23 +703,55 @@ AppUi::AppUi(GLFWwindow *glfw_window_ptr)
         std::filesystem::create_directory(data_directory);
     }
 
-    if (std::filesystem::exists(data_directory / "user_settings.json")) {
-        settings.load(data_directory / "user_settings.json");
-    } else {
-        settings.reset_default();
-        settings.save(data_directory / "user_settings.json");
+    settings_saver = std::make_shared<SettingsSaver>(data_directory / "user_settings.json");
+    {
+        auto const phase = StartupTimer::Scope{"settings load"};
+        if (std::filesystem::exists(data_directory / "user_settings.json")) {
+            settings.load(data_directory / "user_settings.json");
+        } else {
+            settings.reset_default();
+            settings_saver->request(user_settings());
+        }
     }
 
     rescale_ui();
 
-    ImGui_ImplGlfw_InitForVulkan(glfw_window_ptr, true);
+    if (glfw_window_ptr != nullptr) {
+        ImGui_ImplGlfw_InitForVulkan(glfw_window_ptr, true);
+    }
+}
+
+void AppUi::begin_temporary_settings() {
+    if (!user_settings_backup) {
+        user_settings_backup = settings;
+    }
+}
+
+void AppUi::end_temporary_settings() {
+    if (!user_settings_backup) {
+        return;
+    }
+    if (settings.world_seed_str != user_settings_backup->world_seed_str) {
+        should_upload_seed_data = true;
+    }
+    settings = std::move(*user_settings_backup);
+    user_settings_backup.reset();
+    rescale_ui();
+    should_record_task_graph = true;
+}
+
+auto AppUi::user_settings() const -> AppSettings const & {
+    return user_settings_backup ? *user_settings_backup : settings;
 }
 
 AppUi::~AppUi() {
     if ((settings.autosave || autosave_override) && needs_saving) {
-        settings.save(data_directory / "user_settings.json");
+        settings_saver->request(user_settings());
+    }
+    settings_saver->flush();
+    if (glfw_window_ptr != nullptr) {
+        ImGui_ImplGlfw_Shutdown();
     }
-    ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
 }
 
@@ -512,6 +817,23 @@ void AppUi::settings_ui() {
             if (ImGui::Checkbox("Battery Saving Mode", &settings.battery_saving_mode)) {
                 needs_saving = true;
             }
+            if (ImGui::Combo("Present Mode", &settings.present_mode, present_mode_options.data(), static_cast<int>(present_mode_options.size()))) {
+                needs_saving = true;
+                should_update_present_mode = true;
+            }
+            if (ImGui::SliderFloat("FPS Limit (0 = off)", &settings.fps_limit, 0.0f, 360.0f, "%.0f")) {
+                needs_saving = true;
+            }
+            if (ImGui::Checkbox("Low Latency Input", &settings.low_latency_input)) {
+                needs_saving = true;
+            }
+            if (ImGui::Checkbox("Late-latch Input", &settings.late_latch_input)) {
+                needs_saving = true;
+            }
+            if (ImGui::Checkbox("Alias Transient Memory", &settings.alias_transients)) {
+                needs_saving = true;
+                should_record_task_graph = true;
+            }
             if (ImGui::SliderFloat("Camera FOV", &settings.camera_fov, 0.01f, 170.0f)) {
                 needs_saving = true;
             }
@@ -520,6 +842,17 @@ void AppUi::settings_ui() {
                 settings.render_res_scl_id = static_cast<RenderResScl>(resolution_scale_id);
                 needs_saving = true;
             }
+            if (ImGui::Checkbox("Dynamic Resolution", &settings.dynamic_resolution)) {
+                needs_saving = true;
+            }
+            if (settings.dynamic_resolution) {
+                if (ImGui::SliderFloat("Target FPS", &settings.dynamic_resolution_target_fps, 20.0f, 240.0f)) {
+                    needs_saving = true;
+                }
+                if (ImGui::SliderFloat("Min Scale", &settings.dynamic_resolution_min_scale, 0.25f, 1.0f)) {
+                    needs_saving = true;
+                }
+            }
 
             if (ImGui::TreeNode("Auto Exposure")) {
                 if (ImGui::SliderFloat("EV Shift", &settings.auto_exposure.ev_shift, -5.0f, 5.0f)) {
@@ -550,6 +883,14 @@ void AppUi::settings_ui() {
                 sky_settings(settings.sky, needs_saving);
                 ImGui::TreePop();
             }
+
+            if (ImGui::TreeNode("Tunables")) {
+                // VoxelApp re-records the main task graph if the change needs it
+                if (settings.tunables.add_ui()) {
+                    needs_saving = true;
+                }
+                ImGui::TreePop();
+            }
             settings.recompute_sun_direction();
             ImGui::EndTabItem();
         }
@@ -594,13 +935,16 @@ void AppUi::settings_ui() {
     if (!settings.autosave) {
         ImGui::SameLine();
         if (ImGui::Button("Save")) {
-            settings.save(data_directory / "user_settings.json");
+            settings_saver->request(user_settings());
         }
         ImGui::SameLine();
         if (ImGui::Button("Load")) {
+            // Don't read the file while a save of it might still be on the way
+            settings_saver->flush();
             settings.load(data_directory / "user_settings.json");
             rescale_ui();
             needs_saving = true;
+            should_record_task_graph = true;
         }
     }
     ImGui::SameLine();
@@ -608,6 +952,7 @@ void AppUi::settings_ui() {
         settings.reset_default();
         rescale_ui();
         needs_saving = true;
+        should_record_task_graph = true;
     }
     ImGui::End();
 }
@@ -751,7 +1096,8 @@ void AppUi::settings_controls_ui() {
 void AppUi::settings_passes_ui() {
     for (uint32_t pass_i = 0; pass_i < debug_display.passes.size(); ++pass_i) {
         auto &pass = debug_display.passes[pass_i];
-        if (ImGui::Selectable(pass.name.c_str(), debug_display.selected_pass == pass_i)) {
+        auto label = pass.is_culled ? pass.name + " (culled)" : pass.name;
+        if (ImGui::Selectable(label.c_str(), debug_display.selected_pass == pass_i)) {
             if (debug_display.selected_pass_name != pass.name) {
                 debug_display.selected_pass = pass_i;
                 debug_display.selected_pass_name = pass.name;
@@ -790,6 +1136,11 @@ void AppUi::update(daxa_f32 delta_time, daxa_f32 cpu_delta_time) {
     full_frametimes[frametime_rotation_index] = delta_time;
     frametime_rotation_index = (frametime_rotation_index + 1) % full_frametimes.size();
     render_res_scl = resolution_scale_values[static_cast<size_t>(settings.render_res_scl_id)];
+    console.update_script();
+
+    if (glfw_window_ptr == nullptr) {
+        return;
+    }
 
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
@@ -921,13 +1272,15 @@ void AppUi::update(daxa_f32 delta_time, daxa_f32 cpu_delta_time) {
     }
 
     ImGui::PopFont();
-    ImGui::Render();
+    {
+        CPU_PROFILE_ZONE("ImGui::Render");
+        ImGui::Render();
+    }
 
-    // Auto-save
-    auto now = Clock::now();
-    using namespace std::chrono_literals;
-    if ((settings.autosave || autosave_override) && needs_saving && now - last_save_time > 0.1s) {
-        settings.save(data_directory / "user_settings.json");
+    // Auto-save. The saver debounces, so this only costs a copy of the settings.
+    if ((settings.autosave || autosave_override) && needs_saving) {
+        CPU_PROFILE_ZONE("SettingsSaver::request");
+        settings_saver->request(user_settings());
         needs_saving = false;
         autosave_override = false;
     }
@@ -4,11 +4,18 @@ struct GLFWwindow;
 struct ImFont;
 
 #include "app_settings.hpp"
+#include "logger.hpp"
+#include "settings_saver.hpp"
 #include <imgui.h>
 #include <chrono>
+#include <deque>
 #include <filesystem>
+#include <functional>
+#include <optional>
+#include <string_view>
 #include <thread>
 #include <mutex>
+#include <variant>
 #include <fmt/format.h>
 
 #include <gvox/gvox.h>
@@ -17,31 +24,81 @@ struct ImFont;
 
 struct AppUi {
     struct Console {
+        struct CommandArg {
+            enum struct Type {
+                INT,
+                FLOAT,
+                BOOL,
+                STRING,
+            };
+            std::string name;
+            Type type = Type::STRING;
+            bool is_optional = false;
+            // Offered by tab completion. Bools complete to on/off without this.
+            std::function<std::vector<std::string>()> completions{};
+        };
+        using CommandArgValue = std::variant<daxa_i32, daxa_f32, bool, std::string>;
+        struct CommandArgs {
+            std::vector<CommandArgValue> values;
+
+            auto has(size_t i) const -> bool { return i < values.size(); }
+            template <typename T>
+            auto get(size_t i) const -> T const & { return std::get<T>(values[i]); }
+        };
+        struct Command {
+            std::string name;
+            std::string help;
+            // Optional arguments must come last
+            std::vector<CommandArg> args;
+            // Takes the console, rather than capturing it, since AppUi gets copied around on creation
+            std::function<void(Console &, CommandArgs const &)> callback;
+        };
+
+        // Shared so that Console, and with it AppUi, stays copyable
+        std::shared_ptr<Logger> logger = std::make_shared<Logger>();
         char input_buffer[256]{};
-        std::vector<std::string> items;
-        std::vector<const char *> commands;
+        std::vector<Command> commands;
         std::vector<char *> history;
         int history_pos{-1};
         ImGuiTextFilter filter;
         bool auto_scroll{true};
         bool scroll_to_bottom{false};
-        std::shared_ptr<std::mutex> items_mtx = std::make_shared<std::mutex>();
+        int min_level{static_cast<int>(LogLevel::TRACE)};
         inline static Console *s_instance = nullptr;
 
+        // Lines still to be run from scripts, and how many frames to wait before running the next one
+        std::deque<std::string> script_lines;
+        daxa_u32 script_wait_frame_n = 0;
+
         Console();
         ~Console();
 
         void clear_log();
-        void add_log(std::string const &str);
+        // Logged under the "app" category. Messages containing "[error]" or "[warning]" get that level.
+        void add_log(std::string str);
         void draw(const char *title, bool *p_open);
-        void exec_command(const char *command_line);
+        // Replaces any command with the same name
+        void add_command(Command command);
+        auto find_command(std::string_view name) -> Command *;
+        // Runs a line typed by the user, adding it to the history. Returns whether the command ran.
+        auto exec_command(const char *command_line) -> bool;
+        // Runs `path` one command per line. Lines starting with '#' are comments, and `wait <frames>`
+        // pauses the script, which is then resumed by `update_script`.
+        auto exec_script(std::filesystem::path const &path) -> bool;
+        // Must be called once per frame
+        void update_script();
         int on_text_edit(ImGuiInputTextCallbackData *data);
+
+      private:
+        auto run_command(std::string_view command_line) -> bool;
+        void run_script();
     };
 
     struct Pass {
         std::string name;
         daxa::TaskImageView task_image_id;
         daxa_u32 type;
+        bool is_culled = false;
     };
 
     struct DebugDisplayProvider {
@@ -69,6 +126,7 @@ struct AppUi {
 
     using Clock = std::chrono::high_resolution_clock;
 
+    // A null `glfw_window_ptr` runs without any UI, for headless mode
     AppUi(GLFWwindow *glfw_window_ptr);
     ~AppUi();
 
@@ -86,7 +144,10 @@ struct AppUi {
     char const *debug_gpu_name{};
 
     bool needs_saving = false;
-    Clock::time_point last_save_time{};
+    // Shared so that AppUi stays copyable
+    std::shared_ptr<SettingsSaver> settings_saver;
+    // The user's own settings, while `settings` hold temporary overrides (such as a benchmark's)
+    std::optional<AppSettings> user_settings_backup;
     Console console{};
     DebugDisplay debug_display{};
 
@@ -106,6 +167,14 @@ struct AppUi {
     bool should_regenerate_sky = true;
 
     bool should_record_task_graph = false;
+    bool should_update_present_mode = false;
+
+    static inline constexpr std::array<char const *, 4> present_mode_options = {
+        "Immediate",
+        "Mailbox",
+        "FIFO (V-Sync)",
+        "FIFO Relaxed",
+    };
 
     static inline constexpr std::array<char const *, 5> resolution_scale_options = {
         "33%",
@@ -139,6 +208,12 @@ struct AppUi {
     void rescale_ui();
     void update(daxa_f32 delta_time, daxa_f32 cpu_delta_time);
 
+    // Changes to `settings` after this aren't saved, until `end_temporary_settings` restores the user's
+    void begin_temporary_settings();
+    void end_temporary_settings();
+    // What gets written to user_settings.json
+    auto user_settings() const -> AppSettings const &;
+
     void toggle_pause();
     void toggle_debug();
     void toggle_help();
@@ -26,7 +26,11 @@ struct AppWindow {
     bool minimized = false;
     bool mouse_captured = false;
 
-    AppWindow(char const *window_name, daxa_u32vec2 a_size = daxa_u32vec2{800, 600}) : window_size{a_size} {
+    // A headless window has a size, but no GLFW window behind it
+    AppWindow(char const *window_name, daxa_u32vec2 a_size = daxa_u32vec2{800, 600}, bool headless = false) : glfw_window_ptr{nullptr}, window_size{a_size} {
+        if (headless) {
+            return;
+        }
         glfwInit();
         glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
         glfw_window_ptr = glfwCreateWindow(static_cast<daxa_i32>(window_size.x), static_cast<daxa_i32>(window_size.y), window_name, nullptr, nullptr);
@@ -121,6 +125,9 @@ struct AppWindow {
     }
 
     ~AppWindow() {
+        if (glfw_window_ptr == nullptr) {
+            return;
+        }
         glfwDestroyWindow(glfw_window_ptr);
         glfwTerminate();
     }
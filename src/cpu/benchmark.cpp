@@ -0,0 +1,303 @@
+#include "benchmark.hpp"
+#include "app_ui.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+
+namespace {
+    auto to_vec2(nlohmann::json const &json) -> daxa_f32vec2 {
+        return {json.at(0).get<daxa_f32>(), json.at(1).get<daxa_f32>()};
+    }
+    auto to_vec3(nlohmann::json const &json) -> daxa_f32vec3 {
+        return {json.at(0).get<daxa_f32>(), json.at(1).get<daxa_f32>(), json.at(2).get<daxa_f32>()};
+    }
+
+    auto summarize(std::vector<daxa_f32> values) -> nlohmann::json {
+        if (values.empty()) {
+            return {};
+        }
+        std::sort(values.begin(), values.end());
+        auto mean = 0.0;
+        for (auto value : values) {
+            mean += static_cast<double>(value);
+        }
+        mean /= static_cast<double>(values.size());
+        auto percentile = [&values](double p) {
+            auto const index = static_cast<size_t>(p * static_cast<double>(values.size() - 1) + 0.5);
+            return values[index];
+        };
+        return {
+            {"mean", mean},
+            {"min", values.front()},
+            {"p50", percentile(0.50)},
+            {"p95", percentile(0.95)},
+            {"p99", percentile(0.99)},
+            {"max", values.back()},
+        };
+    }
+} // namespace
+
+auto BenchmarkScenario::load(std::filesystem::path const &path) -> std::optional<BenchmarkScenario> {
+    auto file = std::ifstream(path);
+    if (!file.is_open()) {
+        AppUi::Console::s_instance->add_log(fmt::format("Failed to open benchmark scenario '{}'", path.string()));
+        return std::nullopt;
+    }
+    auto const json = nlohmann::json::parse(file, nullptr, false);
+    if (json.is_discarded() || !json.is_object()) {
+        AppUi::Console::s_instance->add_log(fmt::format("Failed to parse benchmark scenario '{}'", path.string()));
+        return std::nullopt;
+    }
+
+    // Keys of the wrong type or shape throw, and a bad scenario file shouldn't take the app down
+    try {
+        auto result = BenchmarkScenario{};
+        result.name = json.value("name", path.stem().string());
+        result.seed = json.value("seed", result.seed);
+        if (json.contains("settings")) {
+            result.settings = json["settings"];
+            // Only applied once the benchmark starts, so check now that they load
+            AppSettings{}.load_json(result.settings);
+        }
+        result.model_path = json.value("model", result.model_path);
+        result.delta_time = json.value("delta_time", result.delta_time);
+        result.settle_frame_n = json.value("settle_frames", result.settle_frame_n);
+        result.max_warmup_frame_n = json.value("max_warmup_frames", result.max_warmup_frame_n);
+        result.frame_n = json.value("frames", result.frame_n);
+
+        for (auto const &key : json.value("camera", nlohmann::json::array())) {
+            result.camera_path.push_back({
+                .time = key.value("time", 0.0f),
+                .pos = to_vec3(key.at("pos")),
+                .rot = to_vec3(key.at("rot")),
+            });
+        }
+        std::sort(result.camera_path.begin(), result.camera_path.end(), [](auto const &a, auto const &b) { return a.time < b.time; });
+
+        for (auto const &edit : json.value("brush_edits", nlohmann::json::array())) {
+            result.brush_edits.push_back({
+                .frame = edit.value("frame", 0u),
+                .frame_n = edit.value("frames", 1u),
+                .action = edit.value("brush", std::string{"a"}) == "b" ? GAME_ACTION_BRUSH_B : GAME_ACTION_BRUSH_A,
+                .screen_uv = edit.contains("screen_uv") ? to_vec2(edit["screen_uv"]) : daxa_f32vec2{0.5f, 0.5f},
+            });
+        }
+
+        for (auto const &model_load : json.value("model_loads", nlohmann::json::array())) {
+            result.model_loads.push_back({
+                .frame = model_load.value("frame", 0u),
+                .path = model_load.at("path").get<std::string>(),
+            });
+        }
+
+        return result;
+    } catch (nlohmann::json::exception const &e) {
+        AppUi::Console::s_instance->add_log(fmt::format("Failed to load benchmark scenario '{}': {}", path.string(), e.what()));
+        return std::nullopt;
+    }
+}
+
+// Catmull-Rom through the camera keys, clamped to the first and last key
+auto BenchmarkScenario::camera_at(daxa_f32 time) const -> CameraKey {
+    if (camera_path.empty()) {
+        return {};
+    }
+    if (time <= camera_path.front().time) {
+        return camera_path.front();
+    }
+    if (time >= camera_path.back().time) {
+        return camera_path.back();
+    }
+    auto next = std::upper_bound(camera_path.begin(), camera_path.end(), time, [](daxa_f32 t, auto const &key) { return t < key.time; });
+    auto const i1 = static_cast<size_t>(next - camera_path.begin()) - 1;
+    auto const i0 = i1 == 0 ? i1 : i1 - 1;
+    auto const i2 = i1 + 1;
+    auto const i3 = std::min(i2 + 1, camera_path.size() - 1);
+    auto const &k0 = camera_path[i0];
+    auto const &k1 = camera_path[i1];
+    auto const &k2 = camera_path[i2];
+    auto const &k3 = camera_path[i3];
+    auto const t = (time - k1.time) / std::max(k2.time - k1.time, 1e-6f);
+    auto spline = [t](daxa_f32 p0, daxa_f32 p1, daxa_f32 p2, daxa_f32 p3) {
+        auto const t2 = t * t;
+        auto const t3 = t2 * t;
+        return 0.5f * ((2.0f * p1) + (-p0 + p2) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 + (-p0 + 3.0f * p1 - 3.0f * p2 + p3) * t3);
+    };
+    auto spline3 = [&spline](daxa_f32vec3 const &p0, daxa_f32vec3 const &p1, daxa_f32vec3 const &p2, daxa_f32vec3 const &p3) {
+        return daxa_f32vec3{spline(p0.x, p1.x, p2.x, p3.x), spline(p0.y, p1.y, p2.y, p3.y), spline(p0.z, p1.z, p2.z, p3.z)};
+    };
+    return {
+        .time = time,
+        .pos = spline3(k0.pos, k1.pos, k2.pos, k3.pos),
+        .rot = spline3(k0.rot, k1.rot, k2.rot, k3.rot),
+    };
+}
+
+void Benchmark::apply_settings(AppSettings &settings) const {
+    auto json = nlohmann::json{};
+    settings.save_json(json);
+    json.update(scenario.settings);
+    json["world_seed_str"] = scenario.seed;
+    settings.load_json(json);
+}
+
+auto Benchmark::begin_frame(GpuInput &gpu_input) -> std::optional<std::string> {
+    gpu_input.delta_time = scenario.delta_time;
+    gpu_input.time = sim_time;
+    sim_time += scenario.delta_time;
+
+    auto const measure_frame_i = phase == Phase::MEASURE ? frame_i : 0u;
+
+    gpu_input.flags &= ~GAME_FLAG_BITS_SCRIPTED_CAMERA;
+    if (!scenario.camera_path.empty()) {
+        auto const key = scenario.camera_at(static_cast<daxa_f32>(measure_frame_i) * scenario.delta_time);
+        gpu_input.flags |= GAME_FLAG_BITS_SCRIPTED_CAMERA;
+        gpu_input.scripted_cam_pos = key.pos;
+        gpu_input.scripted_cam_rot = key.rot;
+        gpu_input.mouse.pos_delta = {0.0f, 0.0f};
+    }
+
+    gpu_input.actions[GAME_ACTION_BRUSH_A] = 0;
+    gpu_input.actions[GAME_ACTION_BRUSH_B] = 0;
+    if (phase != Phase::MEASURE) {
+        return std::nullopt;
+    }
+    for (auto const &edit : scenario.brush_edits) {
+        if (measure_frame_i >= edit.frame && measure_frame_i < edit.frame + edit.frame_n) {
+            gpu_input.actions[static_cast<size_t>(edit.action)] = 1;
+            gpu_input.mouse.pos = {
+                edit.screen_uv.x * static_cast<daxa_f32>(gpu_input.frame_dim.x),
+                edit.screen_uv.y * static_cast<daxa_f32>(gpu_input.frame_dim.y),
+            };
+        }
+    }
+    for (auto const &model_load : scenario.model_loads) {
+        if (model_load.frame == measure_frame_i) {
+            return model_load.path;
+        }
+    }
+    return std::nullopt;
+}
+
+void Benchmark::end_frame(BenchmarkFrameStats const &stats) {
+    switch (phase) {
+    case Phase::WARMUP:
+        ++frame_i;
+        warmup_time += stats.frame_time;
+        if (frame_i <= output_latency_frame_n) {
+            break;
+        }
+        if (stats.visible_chunk_update_n != 0) {
+            has_seen_visible_updates = true;
+        } else if (has_seen_visible_updates && !visible_complete_frame_n) {
+            visible_complete_frame_n = frame_i;
+            visible_complete_time = warmup_time;
+            AppUi::Console::s_instance->add_log(fmt::format("benchmark: chunks in view done after {} frames ({:.2f} s)", frame_i, visible_complete_time));
+        }
+        settled_frame_n = stats.chunk_update_n == 0 ? settled_frame_n + 1 : 0;
+        is_settled = settled_frame_n >= scenario.settle_frame_n;
+        if (is_settled || frame_i >= scenario.max_warmup_frame_n) {
+            warmup_frame_n = frame_i;
+            frame_i = 0;
+            phase = Phase::MEASURE;
+            AppUi::Console::s_instance->add_log(fmt::format("benchmark: warm-up {} after {} frames", is_settled ? "settled" : "timed out", warmup_frame_n));
+        }
+        break;
+    case Phase::MEASURE:
+        frames.push_back(stats);
+        ++frame_i;
+        if (frame_i >= scenario.frame_n) {
+            phase = Phase::DONE;
+        }
+        break;
+    case Phase::DONE: break;
+    }
+}
+
+auto Benchmark::write_report(std::filesystem::path const &path, nlohmann::json const &environment) const -> bool {
+    auto json = nlohmann::json{};
+    json["scenario"] = scenario.name;
+    json["scenario_path"] = scenario_path.string();
+    json["environment"] = environment;
+    json["warmup"] = {
+        {"frames", warmup_frame_n},
+        {"settled", is_settled},
+        {"time", warmup_time},
+        {"visible_complete_frames", visible_complete_frame_n ? nlohmann::json(*visible_complete_frame_n) : nlohmann::json(nullptr)},
+        {"visible_complete_time", visible_complete_frame_n ? nlohmann::json(visible_complete_time) : nlohmann::json(nullptr)},
+    };
+
+    auto frame_times = std::vector<daxa_f32>{};
+    auto cpu_times = std::vector<daxa_f32>{};
+    auto gpu_times = std::vector<daxa_f32>{};
+    auto pass_times = std::map<std::string, std::vector<daxa_f32>>{};
+    auto gpu_missing_frame_n = daxa_u32{0};
+    auto peak_vram_usage = daxa_u64{0};
+    auto peak_render_target_pool_size = daxa_u64{0};
+    auto peak_voxel_heap_usage = daxa_u64{0};
+    auto total_chunk_update_n = daxa_u64{0};
+    // Streaks of frames with chunks in view still waiting for an update, such as after a camera cut
+    auto visible_pending_frame_n = daxa_u32{0};
+    auto visible_pending_time = 0.0f;
+    auto max_visible_pending_time = 0.0f;
+    auto frames_json = nlohmann::json::array();
+    for (auto const &frame : frames) {
+        frame_times.push_back(frame.frame_time);
+        cpu_times.push_back(frame.cpu_time);
+        if (frame.gpu_time) {
+            gpu_times.push_back(*frame.gpu_time);
+        } else {
+            ++gpu_missing_frame_n;
+        }
+        for (auto const &[name, time] : frame.pass_times) {
+            pass_times[name].push_back(time);
+        }
+        peak_vram_usage = std::max(peak_vram_usage, frame.vram_usage);
+        peak_render_target_pool_size = std::max(peak_render_target_pool_size, frame.render_target_pool_size);
+        peak_voxel_heap_usage = std::max(peak_voxel_heap_usage, frame.voxel_heap_usage);
+        total_chunk_update_n += frame.chunk_update_n;
+        if (frame.visible_chunk_update_n != 0) {
+            ++visible_pending_frame_n;
+            visible_pending_time += frame.frame_time;
+            max_visible_pending_time = std::max(max_visible_pending_time, visible_pending_time);
+        } else {
+            visible_pending_time = 0.0f;
+        }
+        frames_json.push_back({
+            {"frame_time", frame.frame_time},
+            {"cpu_time", frame.cpu_time},
+            {"gpu_time", frame.gpu_time ? nlohmann::json(*frame.gpu_time) : nlohmann::json(nullptr)},
+            {"chunk_update_n", frame.chunk_update_n},
+            {"visible_chunk_update_n", frame.visible_chunk_update_n},
+            {"voxel_heap_usage", frame.voxel_heap_usage},
+            {"voxel_page_count", frame.voxel_page_count},
+        });
+    }
+    auto passes_json = nlohmann::json::object();
+    for (auto &[name, times] : pass_times) {
+        passes_json[name] = summarize(std::move(times));
+    }
+    json["summary"] = {
+        {"frames", frames.size()},
+        {"frame_time", summarize(std::move(frame_times))},
+        {"cpu_time", summarize(std::move(cpu_times))},
+        {"gpu_time", summarize(std::move(gpu_times))},
+        {"gpu_missing_frames", gpu_missing_frame_n},
+        {"passes", std::move(passes_json)},
+        {"total_chunk_update_n", total_chunk_update_n},
+        {"visible_pending_frames", visible_pending_frame_n},
+        {"max_visible_pending_time", max_visible_pending_time},
+        {"peak_vram_usage", peak_vram_usage},
+        {"peak_render_target_pool_size", peak_render_target_pool_size},
+        {"peak_voxel_heap_usage", peak_voxel_heap_usage},
+    };
+    json["frames"] = std::move(frames_json);
+
+    auto file = std::ofstream(path);
+    file << std::setw(4) << json;
+    return file.good();
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "app_settings.hpp"
+
+#include <shared/input.inl>
+
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A scripted run that's meant to be repeatable. The world seed, settings, simulation time step, camera
+// path, brush edits and model loads all come from the scenario file rather than from the user.
+struct BenchmarkScenario {
+    struct CameraKey {
+        daxa_f32 time;
+        daxa_f32vec3 pos;
+        daxa_f32vec3 rot; // yaw, pitch, roll
+    };
+    struct BrushEdit {
+        daxa_u32 frame;
+        daxa_u32 frame_n;
+        daxa_i32 action;
+        daxa_f32vec2 screen_uv;
+    };
+    struct ModelLoad {
+        daxa_u32 frame;
+        std::string path;
+    };
+
+    std::string name;
+    std::string seed = "gvox";
+    // Overrides for the user settings, using the same keys as user_settings.json
+    nlohmann::json settings = nlohmann::json::object();
+    // Loaded before the warm-up, so the world has settled by the time measuring starts
+    std::string model_path;
+    daxa_f32 delta_time = 1.0f / 60.0f;
+    // Warm-up ends once no chunk updates were requested for `settle_frame_n` frames in a row,
+    // or after `max_warmup_frame_n` frames
+    daxa_u32 settle_frame_n = 30;
+    daxa_u32 max_warmup_frame_n = 3000;
+    daxa_u32 frame_n = 600;
+    // Camera keys are timed in seconds of measured simulation time
+    std::vector<CameraKey> camera_path;
+    // Edits and model loads are timed in measured frames
+    std::vector<BrushEdit> brush_edits;
+    std::vector<ModelLoad> model_loads;
+
+    static auto load(std::filesystem::path const &path) -> std::optional<BenchmarkScenario>;
+    auto camera_at(daxa_f32 time) const -> CameraKey;
+};
+
+struct BenchmarkFrameStats {
+    daxa_f32 frame_time;
+    daxa_f32 cpu_time;
+    daxa_u32 chunk_update_n;
+    // Chunk updates requested for chunks in view, which show up as pop-in until they're done
+    daxa_u32 visible_chunk_update_n;
+    daxa_u64 voxel_heap_usage;
+    daxa_u64 voxel_page_count;
+    daxa_u64 vram_usage;
+    daxa_u64 render_target_pool_size;
+    // From the GpuProfiler, so these trail the rest of the stats by a few frames. Missing (and no
+    // pass times) on frames where the profiler resolved nothing new.
+    std::optional<daxa_f32> gpu_time;
+    std::vector<std::pair<std::string, daxa_f32>> pass_times;
+};
+
+struct Benchmark {
+    enum struct Phase {
+        WARMUP,
+        MEASURE,
+        DONE,
+    };
+
+    BenchmarkScenario scenario;
+    std::filesystem::path scenario_path;
+    Phase phase = Phase::WARMUP;
+    // Counts frames within the current phase
+    daxa_u32 frame_i = 0;
+    daxa_u32 settled_frame_n = 0;
+    daxa_u32 warmup_frame_n = 0;
+    bool is_settled = false;
+    // The GpuOutput read back at the end of a frame is this many frames old, so the stats of the
+    // first frames still come from before the run (or from the zeroed buffer) and are ignored
+    daxa_u32 output_latency_frame_n = 0;
+    // How long the warm-up took to finish every chunk in view, which is what the player sees of loading.
+    // Only measured once some visible chunk updates have been reported, since the world loads gradually.
+    daxa_f32 warmup_time = 0.0f;
+    bool has_seen_visible_updates = false;
+    std::optional<daxa_u32> visible_complete_frame_n;
+    daxa_f32 visible_complete_time = 0.0f;
+    daxa_f32 sim_time = 0.0f;
+    std::vector<BenchmarkFrameStats> frames;
+
+    // Overrides `settings` with the scenario's. VoxelApp keeps the user's aside (see AppUi::begin_temporary_settings).
+    void apply_settings(AppSettings &settings) const;
+    // Fills in the scripted parts of the GpuInput. Returns the path of a model to load this frame, if any.
+    auto begin_frame(GpuInput &gpu_input) -> std::optional<std::string>;
+    void end_frame(BenchmarkFrameStats const &stats);
+    auto write_report(std::filesystem::path const &path, nlohmann::json const &environment) const -> bool;
+};
@@ -2,20 +2,252 @@
 
 #include <memory>
 #include <thread>
+#include <mutex>
+#include <bit>
+#include <algorithm>
+#include <cmath>
 #include <functional>
+#include <optional>
 #include <unordered_map>
+#include <set>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <variant>
+#include <span>
+#include <iomanip>
 
 #include <daxa/daxa.hpp>
 #include <daxa/utils/pipeline_manager.hpp>
 #include <daxa/utils/imgui.hpp>
 #include <daxa/utils/task_graph.hpp>
 
+#include <nlohmann/json.hpp>
+
 #include <cpu/app_ui.hpp>
+#include <cpu/cpu_profiler.hpp>
+#include <cpu/tunables.hpp>
 
 using BDA = daxa::DeviceAddress;
 
 static inline constexpr size_t FRAMES_IN_FLIGHT = 1;
 
+// Covers the formats the renderer creates images with. Anything else is logged once and counts as 0
+// bytes, which the memory reports show as unknown rather than guessing.
+inline auto format_to_pixel_size(daxa::Format format) -> daxa_u32 {
+    switch (format) {
+    case daxa::Format::R8_UNORM: return 1;
+    case daxa::Format::R16_SFLOAT: return 2;
+    case daxa::Format::R32_SFLOAT:
+    case daxa::Format::R32_UINT:
+    case daxa::Format::D32_SFLOAT:
+    case daxa::Format::R16G16_SFLOAT:
+    case daxa::Format::R8G8B8A8_SNORM:
+    case daxa::Format::R8G8B8A8_UNORM:
+    case daxa::Format::R8G8B8A8_SRGB:
+    case daxa::Format::B8G8R8A8_UNORM:
+    case daxa::Format::B8G8R8A8_SRGB:
+    case daxa::Format::B10G11R11_UFLOAT_PACK32:
+    case daxa::Format::A2B10G10R10_UNORM_PACK32: return 4;
+    case daxa::Format::R16G16B16_SFLOAT: return 6;
+    case daxa::Format::R16G16B16A16_SFLOAT: return 8;
+    case daxa::Format::R32G32B32_SFLOAT: return 12;
+    case daxa::Format::R32G32B32A32_UINT:
+    case daxa::Format::R32G32B32A32_SFLOAT: return 16;
+    default: {
+        static auto logged_formats = std::set<daxa::Format>{};
+        static auto logged_formats_mtx = std::mutex{};
+        auto lock = std::lock_guard{logged_formats_mtx};
+        if (logged_formats.insert(format).second) {
+            Logger::log(LogLevel::WARN, "memory", fmt::format("No pixel size known for image format {}, its memory is reported as unknown", static_cast<daxa_i32>(format)));
+        }
+        return 0;
+    }
+    }
+}
+
+inline auto image_size_estimate(daxa::ImageInfo const &info) -> size_t {
+    auto size = size_t{format_to_pixel_size(info.format)} * info.size.x * info.size.y * info.size.z * info.array_layer_count;
+    // The full mip chain adds at most a third on top of the base level
+    if (info.mip_level_count > 1) {
+        size = size * 4 / 3;
+    }
+    return size;
+}
+
+// Scales the render resolution every frame to keep the frame time near a target. Render targets stay
+// allocated at the full render resolution, so no re-record is needed; render-resolution passes only
+// dispatch over the active sub-rect, which `gpu_input.frame_dim` and `render_res_scl` describe to the shaders.
+struct DynamicResolution {
+    bool enabled = false;
+    daxa_f32 target_frame_time = 1.0f / 60.0f;
+    daxa_f32 min_scale = 0.5f;
+    daxa_f32 max_scale = 1.0f;
+    daxa_f32 scale = 1.0f;
+    daxa_f32 smoothed_frame_time = 0.0f;
+
+    inline static DynamicResolution *s_instance = nullptr;
+
+    DynamicResolution() {
+        s_instance = this;
+    }
+    ~DynamicResolution() {
+        if (s_instance == this) {
+            s_instance = nullptr;
+        }
+    }
+    DynamicResolution(DynamicResolution const &) = delete;
+    DynamicResolution(DynamicResolution &&) = delete;
+    auto operator=(DynamicResolution const &) -> DynamicResolution & = delete;
+    auto operator=(DynamicResolution &&) -> DynamicResolution & = delete;
+
+    // `gpu_frame_time` is the GPU busy time of a recent frame, in seconds. Wall time would include
+    // the frame pacer's sleeps and vsync waits, and shrink the scale whenever the frame rate is capped.
+    // Without a new measurement, the scale is held.
+    void update(std::optional<daxa_f32> gpu_frame_time) {
+        if (!enabled) {
+            scale = 1.0f;
+            return;
+        }
+        if (!gpu_frame_time.has_value()) {
+            return;
+        }
+        smoothed_frame_time += (gpu_frame_time.value() - smoothed_frame_time) * 0.1f;
+        // The cost of the render-resolution passes is roughly proportional to the pixel count
+        auto const ratio = target_frame_time / std::max(smoothed_frame_time, 0.0001f);
+        auto const desired = std::clamp(scale * std::sqrt(ratio), min_scale, max_scale);
+        // Dead band and limited steps, so the temporal passes aren't fed a constantly changing rect
+        if (std::abs(desired - scale) > 0.02f) {
+            scale += std::clamp(desired - scale, -0.05f, 0.05f);
+        }
+    }
+};
+
+// The part of a render-resolution image that is active this frame
+inline auto active_render_extent(auto const &image_size) -> daxa_u32vec2 {
+    auto const scale = DynamicResolution::s_instance != nullptr ? DynamicResolution::s_instance->scale : 1.0f;
+    return {
+        std::min(image_size.x, static_cast<daxa_u32>(std::ceil(static_cast<daxa_f32>(image_size.x) * scale))),
+        std::min(image_size.y, static_cast<daxa_u32>(std::ceil(static_cast<daxa_f32>(image_size.y) * scale))),
+    };
+}
+
+// Recycles render target images across task graph re-records and resizes. Released images only
+// become available again once the frames that may still use them have retired, and the least
+// recently released ones are destroyed once the free images exceed the budget.
+struct RenderTargetPool {
+    static inline constexpr daxa_u64 RETIRE_FRAMES = FRAMES_IN_FLIGHT + 1;
+
+    struct Entry {
+        daxa::ImageId image;
+        daxa::ImageInfo info;
+        size_t size;
+        daxa_u64 frame;
+    };
+
+    std::vector<Entry> free_images;
+    std::vector<Entry> pending_images;
+    size_t budget = size_t{512} * 1024 * 1024;
+    daxa_u64 frame_index = 0;
+    size_t allocated_size = 0;
+    size_t free_size = 0;
+    daxa_u64 hit_n = 0;
+    daxa_u64 miss_n = 0;
+    daxa_u64 evict_n = 0;
+
+    inline static RenderTargetPool *s_instance = nullptr;
+
+    RenderTargetPool() {
+        s_instance = this;
+    }
+    ~RenderTargetPool() {
+        if (s_instance == this) {
+            s_instance = nullptr;
+        }
+    }
+    RenderTargetPool(RenderTargetPool const &) = delete;
+    RenderTargetPool(RenderTargetPool &&) = delete;
+    auto operator=(RenderTargetPool const &) -> RenderTargetPool & = delete;
+    auto operator=(RenderTargetPool &&) -> RenderTargetPool & = delete;
+
+    static auto matches(daxa::ImageInfo const &a, daxa::ImageInfo const &b) -> bool {
+        return a.dimensions == b.dimensions && a.format == b.format &&
+               a.size.x == b.size.x && a.size.y == b.size.y && a.size.z == b.size.z &&
+               a.mip_level_count == b.mip_level_count && a.array_layer_count == b.array_layer_count &&
+               a.sample_count == b.sample_count && a.usage == b.usage && a.flags == b.flags;
+    }
+
+    auto acquire(daxa::Device &device, daxa::ImageInfo const &info) -> daxa::ImageId {
+        auto iter = std::find_if(free_images.begin(), free_images.end(), [&info](Entry const &entry) { return matches(entry.info, info); });
+        if (iter != free_images.end()) {
+            auto image = iter->image;
+            free_size -= iter->size;
+            free_images.erase(iter);
+            ++hit_n;
+            return image;
+        }
+        ++miss_n;
+        allocated_size += image_size_estimate(info);
+        return device.create_image(info);
+    }
+
+    void release(daxa::Device &device, daxa::ImageId image) {
+        auto info = device.info_image(image).value();
+        pending_images.push_back({.image = image, .info = info, .size = image_size_estimate(info), .frame = frame_index});
+    }
+
+    void next_frame(daxa::Device &device) {
+        ++frame_index;
+        auto retired_end = std::partition(pending_images.begin(), pending_images.end(), [this](Entry const &entry) { return frame_index - entry.frame < RETIRE_FRAMES; });
+        for (auto iter = retired_end; iter != pending_images.end(); ++iter) {
+            iter->frame = frame_index;
+            free_size += iter->size;
+            free_images.push_back(*iter);
+        }
+        pending_images.erase(retired_end, pending_images.end());
+        // free_images is in release order, so the front holds the least recently used images
+        while (free_size > budget && !free_images.empty()) {
+            auto const &entry = free_images.front();
+            device.destroy_image(entry.image);
+            allocated_size -= entry.size;
+            free_size -= entry.size;
+            ++evict_n;
+            free_images.erase(free_images.begin());
+        }
+    }
+
+    // Destroys every free image, regardless of the budget. Returns the size freed.
+    auto trim(daxa::Device &device) -> size_t {
+        auto const trimmed_size = free_size;
+        for (auto const &entry : free_images) {
+            device.destroy_image(entry.image);
+            allocated_size -= entry.size;
+            ++evict_n;
+        }
+        free_images.clear();
+        free_size = 0;
+        return trimmed_size;
+    }
+
+    void destroy(daxa::Device &device) {
+        for (auto const &entry : free_images) {
+            device.destroy_image(entry.image);
+        }
+        for (auto const &entry : pending_images) {
+            device.destroy_image(entry.image);
+        }
+        free_images.clear();
+        pending_images.clear();
+        allocated_size = 0;
+        free_size = 0;
+        // Anything released after this point is destroyed directly
+        if (s_instance == this) {
+            s_instance = nullptr;
+        }
+    }
+};
+
 struct PingPongImage_impl {
     using ResourceType = daxa::ImageId;
     using ResourceInfoType = daxa::ImageInfo;
@@ -23,14 +255,27 @@ struct PingPongImage_impl {
     using TaskResourceInfoType = daxa::TaskImageInfo;
 
     static auto create(daxa::Device &device, ResourceInfoType const &info) -> ResourceType {
+        if (RenderTargetPool::s_instance != nullptr) {
+            return RenderTargetPool::s_instance->acquire(device, info);
+        }
         return device.create_image(info);
     }
     static void destroy(daxa::Device &device, ResourceType rsrc_id) {
+        if (RenderTargetPool::s_instance != nullptr) {
+            RenderTargetPool::s_instance->release(device, rsrc_id);
+            return;
+        }
         device.destroy_image(rsrc_id);
     }
     static auto create_task_resource(ResourceType rsrc_id, std::string const &name) -> TaskResourceType {
         return TaskResourceType(TaskResourceInfoType{.initial_images = {std::array{rsrc_id}}, .name = name});
     }
+    static auto is_compatible(ResourceInfoType const &a, ResourceInfoType const &b) -> bool {
+        return a.format == b.format &&
+               a.size.x == b.size.x && a.size.y == b.size.y && a.size.z == b.size.z &&
+               a.mip_level_count == b.mip_level_count && a.array_layer_count == b.array_layer_count &&
+               a.usage == b.usage;
+    }
 };
 
 struct PingPongBuffer_impl {
@@ -48,6 +293,9 @@ struct PingPongBuffer_impl {
     static auto create_task_resource(ResourceType rsrc_id, std::string const &name) -> TaskResourceType {
         return TaskResourceType(TaskResourceInfoType{.initial_buffers = {std::array{rsrc_id}}, .name = name});
     }
+    static auto is_compatible(ResourceInfoType const &a, ResourceInfoType const &b) -> bool {
+        return a.size == b.size;
+    }
 };
 
 template <typename Impl>
@@ -86,13 +334,22 @@ struct PingPongResource {
     };
     Resources resources;
     TaskResources task_resources;
+    ResourceInfoType current_info{};
+    // Set by `get` when the resources had to be (re)created, meaning their contents are undefined
+    bool was_recreated = false;
 
+    // The resources persist across task graph records, and are only recreated when `a_info` no longer matches
     auto get(daxa::Device a_device, ResourceInfoType const &a_info) -> std::pair<TaskResourceType &, TaskResourceType &> {
+        if (!resources.resource_a.is_empty() && !Impl::is_compatible(current_info, a_info)) {
+            resources = Resources{};
+        }
         if (!resources.device.is_valid()) {
             resources.device = a_device;
         }
         // assert(resources.device == a_device);
-        if (resources.resource_a.is_empty()) {
+        was_recreated = resources.resource_a.is_empty();
+        if (was_recreated) {
+            current_info = a_info;
             auto info_a = a_info;
             auto info_b = a_info;
             info_a.name = std::string(info_a.name.view()) + "_a";
@@ -109,6 +366,383 @@ struct PingPongResource {
 using PingPongImage = PingPongResource<PingPongImage_impl>;
 using PingPongBuffer = PingPongResource<PingPongBuffer_impl>;
 
+// Host-visible staging memory for one-shot uploads. Blocks are rounded up to a power-of-two
+// size class and only handed out again once the frames that may still read them have retired.
+struct StagingBufferPool {
+    static inline constexpr daxa_u32 MIN_SIZE_CLASS_LOG2 = 16;
+    static inline constexpr daxa_u32 MAX_SIZE_CLASS_LOG2 = 30;
+    static inline constexpr daxa_u32 SIZE_CLASS_N = MAX_SIZE_CLASS_LOG2 - MIN_SIZE_CLASS_LOG2 + 1;
+    static inline constexpr daxa_u64 RETIRE_FRAMES = FRAMES_IN_FLIGHT + 1;
+    static inline constexpr daxa_u64 TRIM_IDLE_FRAMES = 600;
+
+    struct Block {
+        daxa::BufferId buffer{};
+        size_t size{};
+        // frame of release while pending, frame of last use while free
+        daxa_u64 frame{};
+    };
+    struct Allocation {
+        daxa::BufferId buffer{};
+        uint8_t *ptr{};
+        size_t size{};
+    };
+
+    std::array<std::vector<Block>, SIZE_CLASS_N> free_blocks;
+    std::vector<Block> pending_blocks;
+    std::unique_ptr<std::mutex> mtx = std::make_unique<std::mutex>();
+
+    // free memory above this is trimmed, largest blocks first
+    size_t budget = size_t{256} << 20;
+    daxa_u64 frame_index = 0;
+    size_t allocated_size = 0;
+    size_t free_size = 0;
+    size_t high_water_size = 0;
+    daxa_u64 hit_n = 0;
+    daxa_u64 miss_n = 0;
+
+    static auto size_class_log2(size_t size) -> daxa_u32 {
+        return std::max(MIN_SIZE_CLASS_LOG2, static_cast<daxa_u32>(std::bit_width(std::max<size_t>(size, 1) - 1)));
+    }
+
+    auto acquire(daxa::Device &device, size_t size) -> Allocation {
+        auto lock = std::lock_guard{*mtx};
+        auto block = Block{};
+        auto class_log2 = size_class_log2(size);
+        if (class_log2 <= MAX_SIZE_CLASS_LOG2) {
+            auto &blocks = free_blocks[class_log2 - MIN_SIZE_CLASS_LOG2];
+            if (!blocks.empty()) {
+                block = blocks.back();
+                blocks.pop_back();
+                free_size -= block.size;
+                ++hit_n;
+            } else {
+                block.size = size_t{1} << class_log2;
+            }
+        } else {
+            block.size = size;
+        }
+        if (block.buffer.is_empty()) {
+            block.buffer = device.create_buffer({
+                .size = static_cast<daxa_u64>(block.size),
+                .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+                .name = "staging_pool_block",
+            });
+            allocated_size += block.size;
+            high_water_size = std::max(high_water_size, allocated_size);
+            ++miss_n;
+        }
+        return {
+            .buffer = block.buffer,
+            .ptr = device.get_host_address_as<uint8_t>(block.buffer).value(),
+            .size = block.size,
+        };
+    }
+
+    // The block stays untouched until `RETIRE_FRAMES` calls of `next_frame` have passed
+    void release(Allocation const &allocation) {
+        auto lock = std::lock_guard{*mtx};
+        pending_blocks.push_back({.buffer = allocation.buffer, .size = allocation.size, .frame = frame_index});
+    }
+
+    void next_frame(daxa::Device &device) {
+        auto lock = std::lock_guard{*mtx};
+        ++frame_index;
+        auto destroy_block = [&](Block const &block) {
+            device.destroy_buffer(block.buffer);
+            allocated_size -= block.size;
+        };
+        std::erase_if(pending_blocks, [&](Block const &block) {
+            if (block.frame + RETIRE_FRAMES > frame_index) {
+                return false;
+            }
+            auto class_log2 = size_class_log2(block.size);
+            if (class_log2 > MAX_SIZE_CLASS_LOG2) {
+                destroy_block(block);
+            } else {
+                free_blocks[class_log2 - MIN_SIZE_CLASS_LOG2].push_back({.buffer = block.buffer, .size = block.size, .frame = frame_index});
+                free_size += block.size;
+            }
+            return true;
+        });
+        for (auto &blocks : free_blocks) {
+            std::erase_if(blocks, [&](Block const &block) {
+                if (block.frame + TRIM_IDLE_FRAMES > frame_index) {
+                    return false;
+                }
+                destroy_block(block);
+                free_size -= block.size;
+                return true;
+            });
+        }
+        for (auto class_i = SIZE_CLASS_N; class_i > 0 && free_size > budget; --class_i) {
+            auto &blocks = free_blocks[class_i - 1];
+            while (!blocks.empty() && free_size > budget) {
+                destroy_block(blocks.back());
+                free_size -= blocks.back().size;
+                blocks.pop_back();
+            }
+        }
+    }
+
+    // Destroys every free block, regardless of the budget. Returns the size freed.
+    auto trim(daxa::Device &device) -> size_t {
+        auto lock = std::lock_guard{*mtx};
+        auto const trimmed_size = free_size;
+        for (auto &blocks : free_blocks) {
+            for (auto const &block : blocks) {
+                device.destroy_buffer(block.buffer);
+                allocated_size -= block.size;
+            }
+            blocks.clear();
+        }
+        free_size = 0;
+        return trimmed_size;
+    }
+
+    void destroy(daxa::Device &device) {
+        auto lock = std::lock_guard{*mtx};
+        for (auto &blocks : free_blocks) {
+            for (auto const &block : blocks) {
+                device.destroy_buffer(block.buffer);
+            }
+            blocks.clear();
+        }
+        for (auto const &block : pending_blocks) {
+            device.destroy_buffer(block.buffer);
+        }
+        pending_blocks.clear();
+        allocated_size = 0;
+        free_size = 0;
+    }
+};
+
+// Keeps objects that may still be referenced by in-flight frames (such as old task graphs) alive
+// until the GPU can no longer be using them, instead of stalling the device to free them early.
+struct RetiredObjects {
+    static inline constexpr daxa_u64 RETIRE_FRAMES = FRAMES_IN_FLIGHT + 1;
+
+    struct Entry {
+        std::shared_ptr<void> object;
+        daxa_u64 frame;
+    };
+    std::vector<Entry> entries;
+    daxa_u64 frame_index = 0;
+
+    template <typename T>
+    void retire(T &&object) {
+        entries.push_back({.object = std::make_shared<std::decay_t<T>>(std::forward<T>(object)), .frame = frame_index});
+    }
+
+    void next_frame() {
+        ++frame_index;
+        std::erase_if(entries, [this](Entry const &entry) { return frame_index - entry.frame >= RETIRE_FRAMES; });
+    }
+    void clear() {
+        entries.clear();
+    }
+};
+
+// Wraps recorded tasks in timestamp queries. Every zone gets a begin and end query, in one of
+// FRAME_SLOT_N sets of queries, so results are read back a couple of frames later without waiting
+// on the GPU. Zones are registered while recording the task graph, and re-registered on re-record.
+struct GpuProfiler {
+    static inline constexpr daxa_u32 MAX_ZONE_N = 512;
+    static inline constexpr daxa_u32 FRAME_SLOT_N = FRAMES_IN_FLIGHT + 2;
+    static inline constexpr daxa_u32 INVALID_ZONE = ~daxa_u32{0};
+    // One query past the frame slots, for `sync_clocks`
+    static inline constexpr daxa_u32 CLOCK_SYNC_QUERY = MAX_ZONE_N * 2 * FRAME_SLOT_N;
+
+    struct ZoneResult {
+        std::string name;
+        daxa_u32 zone_i;
+        // In milliseconds, relative to the earliest zone of the frame
+        daxa_f64 start;
+        daxa_f64 duration;
+    };
+
+    daxa::Device device;
+    daxa::TimelineQueryPool query_pool;
+    daxa_f64 timestamp_period = 1.0; // Nanoseconds per tick
+    std::vector<std::string> zone_names;
+    // Bumped whenever the zones are re-registered, so results from an older graph are ignored
+    daxa_u64 generation = 0;
+    std::array<daxa_u64, FRAME_SLOT_N> slot_generations{};
+    // When each slot's frame was recorded, to line the zones up with the CpuProfiler timeline
+    std::array<CpuProfiler::Clock::time_point, FRAME_SLOT_N> slot_cpu_times{};
+    daxa_u64 frame_index = 0;
+
+    std::vector<ZoneResult> zone_results;
+    daxa_f64 frame_time = 0.0; // From the first zone's start to the last zone's end, in milliseconds
+    // Whether the last `next_frame` resolved a frame, rather than leaving the previous results
+    bool has_new_results = false;
+    // Which frame (in `frame_index` terms) the results are from, and the tick its last zone ended at
+    daxa_u64 resolved_frame_index = 0;
+    daxa_u64 frame_end_tick = 0;
+
+    // A GPU tick and the CPU time it was written at, so ticks can be placed on the CPU clock
+    struct ClockSync {
+        daxa_u64 tick;
+        CpuProfiler::Clock::time_point cpu_time;
+        CpuProfiler::Clock::duration uncertainty;
+    };
+    std::optional<ClockSync> clock_sync;
+
+    inline static GpuProfiler *s_instance = nullptr;
+
+    void create(daxa::Device &a_device) {
+        device = a_device;
+        query_pool = device.create_timeline_query_pool({
+            .query_count = MAX_ZONE_N * 2 * FRAME_SLOT_N + 1,
+            .name = "gpu_profiler_query_pool",
+        });
+        timestamp_period = static_cast<daxa_f64>(device.properties().limits.timestamp_period);
+        s_instance = this;
+    }
+    void destroy() {
+        query_pool = {};
+        if (s_instance == this) {
+            s_instance = nullptr;
+        }
+    }
+
+    void reset_zones() {
+        zone_names.clear();
+        ++generation;
+    }
+    // The zone functions are static, so tasks recorded without a profiler aren't timed
+    static auto add_zone(std::string name) -> daxa_u32 {
+        if (s_instance == nullptr || s_instance->zone_names.size() >= MAX_ZONE_N) {
+            return INVALID_ZONE;
+        }
+        s_instance->zone_names.push_back(std::move(name));
+        return static_cast<daxa_u32>(s_instance->zone_names.size() - 1);
+    }
+
+    auto query_index(daxa_u32 zone_i, daxa_u32 is_end) const -> daxa_u32 {
+        auto const slot = static_cast<daxa_u32>(frame_index % FRAME_SLOT_N);
+        return (slot * MAX_ZONE_N + zone_i) * 2 + is_end;
+    }
+    // Must be recorded before any zone of the frame
+    void begin_frame(daxa::CommandRecorder &recorder) {
+        auto const slot = static_cast<daxa_u32>(frame_index % FRAME_SLOT_N);
+        slot_generations[slot] = generation;
+        slot_cpu_times[slot] = CpuProfiler::Clock::now();
+        recorder.reset_timestamps({.query_pool = query_pool, .start_index = slot * MAX_ZONE_N * 2, .count = MAX_ZONE_N * 2});
+    }
+    static void begin_zone(daxa::CommandRecorder &recorder, daxa_u32 zone_i) {
+        if (s_instance != nullptr && zone_i != INVALID_ZONE) {
+            recorder.write_timestamp({.query_pool = s_instance->query_pool, .pipeline_stage = daxa::PipelineStageFlagBits::BOTTOM_OF_PIPE, .query_index = s_instance->query_index(zone_i, 0)});
+        }
+    }
+    static void end_zone(daxa::CommandRecorder &recorder, daxa_u32 zone_i) {
+        if (s_instance != nullptr && zone_i != INVALID_ZONE) {
+            recorder.write_timestamp({.query_pool = s_instance->query_pool, .pipeline_stage = daxa::PipelineStageFlagBits::BOTTOM_OF_PIPE, .query_index = s_instance->query_index(zone_i, 1)});
+        }
+    }
+
+    // Reads back the oldest slot, which the next frame is about to reuse. Zones whose queries
+    // aren't available (not executed, or still in flight) are left out rather than waited on.
+    void next_frame() {
+        ++frame_index;
+        has_new_results = false;
+        if (frame_index < FRAME_SLOT_N) {
+            return;
+        }
+        auto const slot = static_cast<daxa_u32>(frame_index % FRAME_SLOT_N);
+        if (slot_generations[slot] != generation || zone_names.empty()) {
+            return;
+        }
+        auto const zone_n = static_cast<daxa_u32>(zone_names.size());
+        // Each query comes back as a (value, availability) pair
+        auto const results = query_pool.get_query_results(slot * MAX_ZONE_N * 2, zone_n * 2);
+        auto new_results = std::vector<ZoneResult>{};
+        auto first_tick = std::numeric_limits<daxa_u64>::max();
+        auto last_tick = daxa_u64{0};
+        for (daxa_u32 zone_i = 0; zone_i < zone_n; ++zone_i) {
+            auto const begin_tick = results[zone_i * 4 + 0];
+            auto const end_tick = results[zone_i * 4 + 2];
+            if (results[zone_i * 4 + 1] == 0 || results[zone_i * 4 + 3] == 0 || end_tick < begin_tick) {
+                continue;
+            }
+            first_tick = std::min(first_tick, begin_tick);
+            last_tick = std::max(last_tick, end_tick);
+            new_results.push_back({
+                .name = zone_names[zone_i],
+                .zone_i = zone_i,
+                .start = static_cast<daxa_f64>(begin_tick),
+                .duration = static_cast<daxa_f64>(end_tick - begin_tick) * timestamp_period / 1'000'000.0,
+            });
+        }
+        if (new_results.empty()) {
+            return;
+        }
+        for (auto &result : new_results) {
+            result.start = (result.start - static_cast<daxa_f64>(first_tick)) * timestamp_period / 1'000'000.0;
+        }
+        zone_results = std::move(new_results);
+        frame_time = static_cast<daxa_f64>(last_tick - first_tick) * timestamp_period / 1'000'000.0;
+        has_new_results = true;
+        resolved_frame_index = frame_index - FRAME_SLOT_N;
+        frame_end_tick = last_tick;
+
+        // There's no shared clock, so the first zone is placed where the frame was recorded
+        if (CpuProfiler::s_instance != nullptr) {
+            auto external_zones = std::vector<CpuProfiler::ExternalZone>{};
+            for (auto const &zone : zone_results) {
+                auto const begin = slot_cpu_times[slot] + std::chrono::duration_cast<CpuProfiler::Clock::duration>(std::chrono::duration<daxa_f64, std::milli>(zone.start));
+                external_zones.push_back({.name = zone.name, .begin = begin, .duration = zone.duration * 1000.0});
+            }
+            CpuProfiler::s_instance->add_external_zones("GPU", external_zones);
+        }
+    }
+
+    // Writes a timestamp in a submission of its own, between two CPU clock reads with the queue idle.
+    // That stalls the device, so it's only done for measurements that need GPU ticks on the CPU clock.
+    void sync_clocks() {
+        auto task_graph = daxa::TaskGraph({
+            .device = device,
+            .name = "gpu_profiler_clock_sync",
+        });
+        task_graph.add_task({
+            .attachments = {},
+            .task = [this](daxa::TaskInterface const &ti) {
+                ti.recorder.reset_timestamps({.query_pool = query_pool, .start_index = CLOCK_SYNC_QUERY, .count = 1});
+                ti.recorder.write_timestamp({.query_pool = query_pool, .pipeline_stage = daxa::PipelineStageFlagBits::BOTTOM_OF_PIPE, .query_index = CLOCK_SYNC_QUERY});
+            },
+            .name = "GpuProfilerClockSync",
+        });
+        task_graph.submit({});
+        task_graph.complete({});
+        device.wait_idle();
+        auto const before = CpuProfiler::Clock::now();
+        task_graph.execute({});
+        device.wait_idle();
+        auto const after = CpuProfiler::Clock::now();
+        auto const results = query_pool.get_query_results(CLOCK_SYNC_QUERY, 1);
+        if (results[1] == 0) {
+            return;
+        }
+        clock_sync = ClockSync{.tick = results[0], .cpu_time = before + (after - before) / 2, .uncertainty = (after - before) / 2};
+    }
+    // Requires `clock_sync`
+    auto tick_to_cpu_time(daxa_u64 tick) const -> CpuProfiler::Clock::time_point {
+        auto const ns = (static_cast<daxa_f64>(tick) - static_cast<daxa_f64>(clock_sync->tick)) * timestamp_period;
+        return clock_sync->cpu_time + std::chrono::duration_cast<CpuProfiler::Clock::duration>(std::chrono::duration<daxa_f64, std::nano>(ns));
+    }
+
+    // Writes the last resolved frame in the Chrome trace event format (chrome://tracing, Perfetto)
+    auto write_chrome_trace(std::filesystem::path const &path) const -> bool {
+        auto file = std::ofstream(path);
+        file << "{\"traceEvents\":[";
+        for (size_t i = 0; i < zone_results.size(); ++i) {
+            auto const &zone = zone_results[i];
+            file << (i == 0 ? "" : ",") << fmt::format(R"({{"name":"{}","ph":"X","pid":0,"tid":0,"ts":{:.3f},"dur":{:.3f}}})", zone.name, zone.start * 1000.0, zone.duration * 1000.0);
+        }
+        file << "],\"displayTimeUnit\":\"ms\"}";
+        return file.good();
+    }
+};
+
 #define ENABLE_THREAD_POOL true
 
 #if ENABLE_THREAD_POOL
@@ -170,6 +804,7 @@ namespace {
       private:
         void thread_loop() {
 #if ENABLE_THREAD_POOL
+            CpuProfiler::set_thread_name("thread pool");
             while (true) {
                 std::function<void()> job;
                 {
@@ -183,6 +818,7 @@ namespace {
                     job = jobs.front();
                     jobs.pop();
                 }
+                CPU_PROFILE_ZONE("ThreadPool job");
                 job();
             }
 #endif
@@ -214,6 +850,18 @@ struct AsyncManagedComputePipeline {
 #endif
         return pipeline && pipeline->is_valid();
     }
+    // Like `is_valid`, but doesn't wait for the compile to finish
+    auto is_ready() -> bool {
+#if ENABLE_THREAD_POOL
+        if (pipeline_future.valid()) {
+            if (pipeline_future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                return false;
+            }
+            pipeline = pipeline_future.get();
+        }
+#endif
+        return true;
+    }
     auto get() -> daxa::ComputePipeline & {
         return *pipeline;
     }
@@ -235,19 +883,174 @@ struct AsyncManagedRasterPipeline {
 #endif
         return pipeline && pipeline->is_valid();
     }
+    // Like `is_valid`, but doesn't wait for the compile to finish
+    auto is_ready() -> bool {
+#if ENABLE_THREAD_POOL
+        if (pipeline_future.valid()) {
+            if (pipeline_future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                return false;
+            }
+            pipeline = pipeline_future.get();
+        }
+#endif
+        return true;
+    }
     auto get() -> daxa::RasterPipeline & {
         return *pipeline;
     }
 };
 
+// Records every pipeline compile and hot reload. The daxa PipelineManager preprocesses, compiles and
+// creates the pipeline in one call, so only the total is known for each compile, along with how long it
+// sat in the thread pool queue and waited for a free PipelineManager.
+struct ShaderCompileStats : AppUi::DebugDisplayProvider {
+    using Clock = std::chrono::steady_clock;
+    static inline constexpr daxa_f64 SLOW_COMPILE_THRESHOLD = 1.0; // In seconds
+
+    struct Entry {
+        std::string name;
+        std::string kind;
+        std::string source;
+        std::string defines;
+        daxa_f64 queue_time;
+        daxa_f64 lock_time;
+        daxa_f64 compile_time;
+        bool success;
+    };
+
+    std::mutex mtx;
+    std::vector<Entry> entries;
+
+    static auto source_name(daxa::ShaderSource const &source) -> std::string {
+        if (auto const *file = daxa::get_if<daxa::ShaderFile>(&source)) {
+            return file->path.string();
+        }
+        return "<code>";
+    }
+    static auto raster_shader_info(daxa::RasterPipelineCompileInfo const &info) -> daxa::ShaderCompileInfo const & {
+        return info.fragment_shader_info.has_value() ? info.fragment_shader_info.value() : info.vertex_shader_info.value();
+    }
+    static auto define_list(std::vector<daxa::ShaderDefine> const &defines) -> std::string {
+        auto result = std::string{};
+        for (auto const &define : defines) {
+            result += result.empty() ? "" : " ";
+            result += define.value.empty() ? define.name : fmt::format("{}={}", define.name, define.value);
+        }
+        return result;
+    }
+
+    void add(Entry &&entry) {
+        if (entry.compile_time > SLOW_COMPILE_THRESHOLD) {
+            Logger::log(LogLevel::WARN, "shaders", fmt::format("[slow compile] {} ({}) took {:.0f} ms [{}]", entry.name, entry.source, entry.compile_time * 1000.0, entry.defines));
+        }
+        auto lock = std::lock_guard{mtx};
+        entries.push_back(std::move(entry));
+    }
+
+    auto write_json(std::filesystem::path const &path) -> bool {
+        auto json = nlohmann::json::array();
+        {
+            auto lock = std::lock_guard{mtx};
+            for (auto const &entry : entries) {
+                json.push_back({
+                    {"name", entry.name},
+                    {"kind", entry.kind},
+                    {"source", entry.source},
+                    {"defines", entry.defines},
+                    {"queue_ms", entry.queue_time * 1000.0},
+                    {"lock_ms", entry.lock_time * 1000.0},
+                    {"compile_ms", entry.compile_time * 1000.0},
+                    {"success", entry.success},
+                });
+            }
+        }
+        auto file = std::ofstream(path);
+        file << std::setw(4) << json;
+        return file.good();
+    }
+
+    void add_ui() override {
+        auto should_dump = false;
+        if (ImGui::TreeNode("Shader Compiles")) {
+            auto lock = std::lock_guard{mtx};
+            auto total_time = 0.0;
+            for (auto const &entry : entries) {
+                total_time += entry.compile_time;
+            }
+            ImGui::Text("compiles: %zu | total: %.1f ms", entries.size(), total_time * 1000.0);
+            should_dump = ImGui::Button("Dump JSON");
+            if (ImGui::BeginTable("##shader_compiles", 6, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollY | ImGuiTableFlags_Sortable | ImGuiTableFlags_Resizable, ImVec2(0.0f, 300.0f))) {
+                ImGui::TableSetupColumn("Name");
+                ImGui::TableSetupColumn("Kind");
+                ImGui::TableSetupColumn("Compile (ms)", ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_PreferSortDescending);
+                ImGui::TableSetupColumn("Queue (ms)", ImGuiTableColumnFlags_PreferSortDescending);
+                ImGui::TableSetupColumn("Lock (ms)", ImGuiTableColumnFlags_PreferSortDescending);
+                ImGui::TableSetupColumn("Defines");
+                ImGui::TableSetupScrollFreeze(0, 1);
+                ImGui::TableHeadersRow();
+                if (auto *sort_specs = ImGui::TableGetSortSpecs(); sort_specs != nullptr && sort_specs->SpecsDirty && sort_specs->SpecsCount > 0) {
+                    auto const &spec = sort_specs->Specs[0];
+                    auto key = [&spec](Entry const &entry) -> std::variant<std::string, daxa_f64> {
+                        switch (spec.ColumnIndex) {
+                        case 0: return entry.name;
+                        case 1: return entry.kind;
+                        case 3: return entry.queue_time;
+                        case 4: return entry.lock_time;
+                        case 5: return entry.defines;
+                        default: return entry.compile_time;
+                        }
+                    };
+                    std::stable_sort(entries.begin(), entries.end(), [&](Entry const &a, Entry const &b) {
+                        return spec.SortDirection == ImGuiSortDirection_Ascending ? key(a) < key(b) : key(b) < key(a);
+                    });
+                    sort_specs->SpecsDirty = false;
+                }
+                for (auto const &entry : entries) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    if (entry.success) {
+                        ImGui::Text("%s", entry.name.c_str());
+                    } else {
+                        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s", entry.name.c_str());
+                    }
+                    if (ImGui::IsItemHovered()) {
+                        ImGui::SetTooltip("%s", entry.source.c_str());
+                    }
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%s", entry.kind.c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.2f", entry.compile_time * 1000.0);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.2f", entry.queue_time * 1000.0);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.2f", entry.lock_time * 1000.0);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%s", entry.defines.c_str());
+                }
+                ImGui::EndTable();
+            }
+            ImGui::TreePop();
+        }
+        if (should_dump) {
+            auto const path = std::filesystem::path{"shader_compile_stats.json"};
+            if (write_json(path)) {
+                AppUi::Console::s_instance->add_log(fmt::format("Wrote shader compile stats to {}", std::filesystem::absolute(path).string()));
+            }
+        }
+    }
+};
+
 struct AsyncPipelineManager {
     std::array<daxa::PipelineManager, 8> pipeline_managers;
     struct Atomics {
         std::array<std::mutex, 8> mutexes{};
         std::atomic_uint64_t current_index = 0;
         ThreadPool thread_pool{};
+        ShaderCompileStats compile_stats{};
     };
     std::unique_ptr<Atomics> atomics;
+    std::vector<std::shared_ptr<AsyncManagedComputePipeline>> retired_compute_pipelines;
+    std::vector<std::shared_ptr<AsyncManagedRasterPipeline>> retired_raster_pipelines;
 
     AsyncPipelineManager(daxa::PipelineManagerInfo info) {
         pipeline_managers = {
@@ -290,16 +1093,21 @@ struct AsyncPipelineManager {
         result.pipeline_promise = pipeline_promise;
         result.pipeline_future = pipeline_promise->get_future();
         auto info_copy = info;
+        auto const enqueue_time = ShaderCompileStats::Clock::now();
 
-        atomics->thread_pool.enqueue([this, pipeline_promise, info_copy]() {
+        atomics->thread_pool.enqueue([this, pipeline_promise, info_copy, enqueue_time]() {
+            CPU_PROFILE_ZONE("compile compute pipeline");
+            auto const start_time = ShaderCompileStats::Clock::now();
             auto [pipeline_manager, lock] = get_pipeline_manager();
+            auto const lock_time = ShaderCompileStats::Clock::now();
             auto compile_result = pipeline_manager.add_compute_pipeline(info_copy);
+            record_compile(info_copy.name, "compute", info_copy.shader_info, enqueue_time, start_time, lock_time, !compile_result.is_err() && compile_result.value()->is_valid());
             if (compile_result.is_err()) {
-                AppUi::Console::s_instance->add_log(compile_result.message());
+                Logger::log(LogLevel::ERR, "shaders", compile_result.message());
                 return;
             }
             if (!compile_result.value()->is_valid()) {
-                AppUi::Console::s_instance->add_log(compile_result.message());
+                Logger::log(LogLevel::ERR, "shaders", compile_result.message());
                 return;
             }
             pipeline_promise->set_value(compile_result.value());
@@ -307,16 +1115,19 @@ struct AsyncPipelineManager {
 
         return result;
 #else
+        auto const start_time = ShaderCompileStats::Clock::now();
         auto [pipeline_manager, lock] = get_pipeline_manager();
+        auto const lock_time = ShaderCompileStats::Clock::now();
         auto compile_result = pipeline_manager.add_compute_pipeline(info);
+        record_compile(info.name, "compute", info.shader_info, start_time, start_time, lock_time, !compile_result.is_err() && compile_result.value()->is_valid());
         if (compile_result.is_err()) {
-            AppUi::Console::s_instance->add_log(compile_result.message());
+            Logger::log(LogLevel::ERR, "shaders", compile_result.message());
             return {};
         }
         auto result = AsyncManagedComputePipeline{};
         result.pipeline = compile_result.value();
         if (!compile_result.value()->is_valid()) {
-            AppUi::Console::s_instance->add_log(compile_result.message());
+            Logger::log(LogLevel::ERR, "shaders", compile_result.message());
         }
         return result;
 #endif
@@ -328,16 +1139,21 @@ struct AsyncPipelineManager {
         result.pipeline_promise = pipeline_promise;
         result.pipeline_future = pipeline_promise->get_future();
         auto info_copy = info;
+        auto const enqueue_time = ShaderCompileStats::Clock::now();
 
-        atomics->thread_pool.enqueue([this, pipeline_promise, info_copy]() {
+        atomics->thread_pool.enqueue([this, pipeline_promise, info_copy, enqueue_time]() {
+            CPU_PROFILE_ZONE("compile raster pipeline");
+            auto const start_time = ShaderCompileStats::Clock::now();
             auto [pipeline_manager, lock] = get_pipeline_manager();
+            auto const lock_time = ShaderCompileStats::Clock::now();
             auto compile_result = pipeline_manager.add_raster_pipeline(info_copy);
+            record_compile(info_copy.name, "raster", ShaderCompileStats::raster_shader_info(info_copy), enqueue_time, start_time, lock_time, !compile_result.is_err() && compile_result.value()->is_valid());
             if (compile_result.is_err()) {
-                AppUi::Console::s_instance->add_log(compile_result.message());
+                Logger::log(LogLevel::ERR, "shaders", compile_result.message());
                 return;
             }
             if (!compile_result.value()->is_valid()) {
-                AppUi::Console::s_instance->add_log(compile_result.message());
+                Logger::log(LogLevel::ERR, "shaders", compile_result.message());
                 return;
             }
             pipeline_promise->set_value(compile_result.value());
@@ -345,16 +1161,19 @@ struct AsyncPipelineManager {
 
         return result;
 #else
+        auto const start_time = ShaderCompileStats::Clock::now();
         auto [pipeline_manager, lock] = get_pipeline_manager();
+        auto const lock_time = ShaderCompileStats::Clock::now();
         auto compile_result = pipeline_manager.add_raster_pipeline(info);
+        record_compile(info.name, "raster", ShaderCompileStats::raster_shader_info(info), start_time, start_time, lock_time, !compile_result.is_err() && compile_result.value()->is_valid());
         if (compile_result.is_err()) {
-            AppUi::Console::s_instance->add_log(compile_result.message());
+            Logger::log(LogLevel::ERR, "shaders", compile_result.message());
             return {};
         }
         auto result = AsyncManagedRasterPipeline{};
         result.pipeline = compile_result.value();
         if (!compile_result.value()->is_valid()) {
-            AppUi::Console::s_instance->add_log(compile_result.message());
+            Logger::log(LogLevel::ERR, "shaders", compile_result.message());
         }
         return result;
 #endif
@@ -367,6 +1186,36 @@ struct AsyncPipelineManager {
         auto [pipeline_manager, lock] = get_pipeline_manager();
         pipeline_manager.remove_raster_pipeline(pipeline);
     }
+    // Stops tracking a pipeline that has been replaced (such as by a variant with different tunable
+    // defines), so `reload_all` no longer recompiles it. Ones still compiling are removed once done.
+    void retire(std::shared_ptr<AsyncManagedComputePipeline> pipeline) {
+        retired_compute_pipelines.push_back(std::move(pipeline));
+        remove_retired();
+    }
+    void retire(std::shared_ptr<AsyncManagedRasterPipeline> pipeline) {
+        retired_raster_pipelines.push_back(std::move(pipeline));
+        remove_retired();
+    }
+    void remove_retired() {
+        std::erase_if(retired_compute_pipelines, [this](auto const &pipeline) {
+            if (!pipeline->is_ready()) {
+                return false;
+            }
+            if (pipeline->pipeline) {
+                remove_compute_pipeline(pipeline->pipeline);
+            }
+            return true;
+        });
+        std::erase_if(retired_raster_pipelines, [this](auto const &pipeline) {
+            if (!pipeline->is_ready()) {
+                return false;
+            }
+            if (pipeline->pipeline) {
+                remove_raster_pipeline(pipeline->pipeline);
+            }
+            return true;
+        });
+    }
     void add_virtual_file(daxa::VirtualFileInfo const &info) {
         for (auto &pipeline_manager : pipeline_managers) {
             pipeline_manager.add_virtual_file(info);
@@ -379,6 +1228,7 @@ struct AsyncPipelineManager {
 #endif
     }
     auto reload_all() -> daxa::PipelineReloadResult {
+        remove_retired();
         std::array<daxa::PipelineReloadResult, 8> results;
         for (daxa_u32 i = 0; i < pipeline_managers.size(); ++i) {
             // #if ENABLE_THREAD_POOL
@@ -389,8 +1239,24 @@ struct AsyncPipelineManager {
             //             });
             // #else
             auto &pipeline_manager = pipeline_managers[i];
+            auto const start_time = ShaderCompileStats::Clock::now();
             auto lock = std::lock_guard{atomics->mutexes[i]};
+            auto const lock_time = ShaderCompileStats::Clock::now();
             results[i] = pipeline_manager.reload_all();
+            // Reloads that found nothing to do aren't worth recording
+            if (!daxa::holds_alternative<daxa::NoPipelineChanged>(results[i])) {
+                auto const end_time = ShaderCompileStats::Clock::now();
+                atomics->compile_stats.add({
+                    .name = fmt::format("reload_all (manager {})", i),
+                    .kind = "reload",
+                    .source = "",
+                    .defines = "",
+                    .queue_time = 0.0,
+                    .lock_time = std::chrono::duration<daxa_f64>(lock_time - start_time).count(),
+                    .compile_time = std::chrono::duration<daxa_f64>(end_time - lock_time).count(),
+                    .success = !daxa::holds_alternative<daxa::PipelineReloadError>(results[i]),
+                });
+            }
             // #endif
         }
         // #if ENABLE_THREAD_POOL
@@ -405,7 +1271,25 @@ struct AsyncPipelineManager {
         return results[0];
     }
 
+    auto compile_stats() -> ShaderCompileStats & {
+        return atomics->compile_stats;
+    }
+
   private:
+    void record_compile(std::string const &name, char const *kind, daxa::ShaderCompileInfo const &shader_info, ShaderCompileStats::Clock::time_point enqueue_time, ShaderCompileStats::Clock::time_point start_time, ShaderCompileStats::Clock::time_point lock_time, bool success) {
+        auto const end_time = ShaderCompileStats::Clock::now();
+        atomics->compile_stats.add({
+            .name = name,
+            .kind = kind,
+            .source = ShaderCompileStats::source_name(shader_info.source),
+            .defines = ShaderCompileStats::define_list(shader_info.compile_options.defines),
+            .queue_time = std::chrono::duration<daxa_f64>(start_time - enqueue_time).count(),
+            .lock_time = std::chrono::duration<daxa_f64>(lock_time - start_time).count(),
+            .compile_time = std::chrono::duration<daxa_f64>(end_time - lock_time).count(),
+            .success = success,
+        });
+    }
+
     auto get_pipeline_manager() -> std::pair<daxa::PipelineManager &, std::unique_lock<std::mutex>> {
 #if ENABLE_THREAD_POOL
         auto index = atomics->current_index.fetch_add(1);
@@ -474,12 +1358,15 @@ struct Task : TaskHeadT {
     // Not set by user
     // std::string_view name = TaskHeadT::NAME;
     std::shared_ptr<PipelineT> pipeline;
+    daxa_u32 profiler_zone = GpuProfiler::INVALID_ZONE;
     void callback(daxa::TaskInterface const &ti) {
         auto push = PushT{};
         if (!pipeline->is_valid()) {
             return;
         }
+        GpuProfiler::begin_zone(ti.recorder, profiler_zone);
         callback_(ti, pipeline->get(), push, info);
+        GpuProfiler::end_zone(ti.recorder, profiler_zone);
     }
 };
 
@@ -497,13 +1384,16 @@ struct Task<TaskHeadT, PushT, InfoT, AsyncManagedRasterPipeline> : TaskHeadT {
     // Not set by user
     // std::string_view name = TaskHeadT::NAME;
     std::shared_ptr<AsyncManagedRasterPipeline> pipeline;
+    daxa_u32 profiler_zone = GpuProfiler::INVALID_ZONE;
     void callback(daxa::TaskInterface const &ti) {
         auto push = PushT{};
         // ti.copy_task_head_to(&push.uses);
         if (!pipeline->is_valid()) {
             return;
         }
+        GpuProfiler::begin_zone(ti.recorder, profiler_zone);
         callback_(ti, pipeline->get(), push, info);
+        GpuProfiler::end_zone(ti.recorder, profiler_zone);
     }
 };
 
@@ -519,6 +1409,8 @@ struct RecordContext {
     AsyncPipelineManager *pipeline_manager;
     daxa_u32vec2 render_resolution;
     daxa_u32vec2 output_resolution;
+    // Fixed for the whole recording. Pipelines get the ones their shaders read as defines.
+    Tunables tunables;
 
     daxa::TaskImageView task_swapchain_image;
     daxa::TaskImageView task_blue_noise_vec2_image;
@@ -528,6 +1420,178 @@ struct RecordContext {
 
     std::unordered_map<std::string, std::shared_ptr<AsyncManagedComputePipeline>> *compute_pipelines;
     std::unordered_map<std::string, std::shared_ptr<AsyncManagedRasterPipeline>> *raster_pipelines;
+    // For each task name and its own defines, the key (including tunable defines) of the pipeline
+    // it was last recorded with. Used to evict the variants left behind by tunable changes.
+    std::unordered_map<std::string, std::string> *pipeline_variants;
+
+    // Tasks recorded through `add` and `add_task` between `begin_culling` and `cull_unused_tasks`.
+    // They only reach `task_graph` once culling has traced which of them feed anything.
+    struct PendingTask {
+        size_t node_i;
+        std::function<void()> record;
+    };
+    std::vector<PendingTask> pending_tasks{};
+    bool is_culling = false;
+
+    struct TransientInfo {
+        std::string type;
+        std::string name;
+        size_t size;
+        daxa_u32 index;
+        // Lifetime, in indices of the tasks recorded through `add` and `add_task`
+        daxa_u32 first_task;
+        daxa_u32 last_task;
+    };
+    std::vector<TransientInfo> transient_infos{};
+    daxa_u32 task_n = 0;
+
+    // Every task recorded through `add` and `add_task`, along with the resources they use. Culled
+    // tasks keep their node, but not their uses. Only used for inspecting the graph.
+    struct TaskNodeInfo {
+        struct ResourceUse {
+            std::string type;
+            daxa_u32 index;
+            bool is_persistent;
+            bool is_read;
+            bool is_write;
+        };
+        std::string name;
+        std::string kind;
+        daxa_u32 profiler_zone;
+        daxa_u32 task_i;
+        std::vector<ResourceUse> uses;
+    };
+    std::vector<TaskNodeInfo> task_nodes{};
+    std::unordered_map<std::string, daxa_u32> task_name_counts{};
+
+    auto create_transient_image(daxa::TaskTransientImageInfo const &info) -> daxa::TaskImageView {
+        auto result = task_graph.create_transient_image(info);
+        auto size = image_size_estimate({.format = info.format, .size = info.size, .mip_level_count = info.mip_level_count, .array_layer_count = info.array_layer_count});
+        transient_infos.push_back({.type = "image", .name = std::string{info.name.view()}, .size = size, .index = result.index, .first_task = task_n, .last_task = task_n});
+        return result;
+    }
+    auto create_transient_buffer(daxa::TaskTransientBufferInfo const &info) -> daxa::TaskBufferView {
+        auto result = task_graph.create_transient_buffer(info);
+        transient_infos.push_back({.type = "buffer", .name = std::string{info.name.view()}, .size = info.size, .index = result.index, .first_task = task_n, .last_task = task_n});
+        return result;
+    }
+
+    void add_resource_use(TaskNodeInfo &node, std::string_view type, auto const &view, daxa::TaskAccess const &access) {
+        if (view.is_empty()) {
+            return;
+        }
+        if (!view.is_persistent()) {
+            for (auto &info : transient_infos) {
+                if (info.index == view.index && info.type == type) {
+                    info.last_task = task_n;
+                }
+            }
+        }
+        auto const access_type = static_cast<daxa_u32>(access.type);
+        node.uses.push_back({
+            .type = std::string{type},
+            .index = view.index,
+            .is_persistent = view.is_persistent(),
+            .is_read = (access_type & (static_cast<daxa_u32>(daxa::TaskAccessType::READ) | static_cast<daxa_u32>(daxa::TaskAccessType::SAMPLED))) != 0,
+            .is_write = (access_type & static_cast<daxa_u32>(daxa::TaskAccessType::WRITE)) != 0,
+        });
+    }
+
+    template <typename TaskHeadT>
+    void add_resource_uses(TaskNodeInfo &node, typename TaskHeadT::Views const &views) {
+        for (auto const &view : views) {
+            if (auto const *image_view = daxa::get_if<std::pair<daxa::TaskImageAttachmentIndex, daxa::TaskImageView>>(&view)) {
+                auto const &attachment = TaskHeadT::AT.value[image_view->first.value];
+                add_resource_use(node, "image", image_view->second, attachment.value.image.task_access);
+            } else if (auto const *buffer_view = daxa::get_if<std::pair<daxa::TaskBufferAttachmentIndex, daxa::TaskBufferView>>(&view)) {
+                auto const &attachment = TaskHeadT::AT.value[buffer_view->first.value];
+                add_resource_use(node, "buffer", buffer_view->second, attachment.value.buffer.task_access);
+            }
+        }
+    }
+
+    // Until `cull_unused_tasks`, tasks recorded through `add` and `add_task` are held back instead of
+    // being added to `task_graph`. Nothing may add tasks to `task_graph` directly (or through
+    // `conditional`) in between, since those would end up ordered before the held back tasks.
+    void begin_culling() {
+        is_culling = true;
+    }
+
+    // Walks the held back tasks in reverse and keeps those that write a persistent resource, write a
+    // transient that a kept task reads, or write nothing at all. Only the kept tasks are added to
+    // `task_graph`. Debug passes whose image no kept task writes are marked as culled, so pinning one
+    // in the debug view (which reads it) keeps its producers. Returns the names of the culled tasks.
+    auto cull_unused_tasks() -> std::vector<std::string> {
+        using ResourceKey = std::pair<std::string, daxa_u32>;
+        is_culling = false;
+        auto read_transients = std::set<ResourceKey>{};
+        auto is_kept = std::vector<bool>(pending_tasks.size(), false);
+        for (size_t pending_i = pending_tasks.size(); pending_i-- > 0;) {
+            auto const &node = task_nodes[pending_tasks[pending_i].node_i];
+            auto has_write = false;
+            auto is_consumed = false;
+            for (auto const &use : node.uses) {
+                if (use.is_write) {
+                    has_write = true;
+                    is_consumed = is_consumed || use.is_persistent || read_transients.contains({use.type, use.index});
+                }
+            }
+            if (has_write && !is_consumed) {
+                continue;
+            }
+            is_kept[pending_i] = true;
+            for (auto const &use : node.uses) {
+                if (use.is_read && !use.is_persistent) {
+                    read_transients.insert({use.type, use.index});
+                }
+            }
+        }
+
+        auto culled = std::vector<std::string>{};
+        for (size_t pending_i = 0; pending_i < pending_tasks.size(); ++pending_i) {
+            auto &pending = pending_tasks[pending_i];
+            if (is_kept[pending_i]) {
+                pending.record();
+            } else {
+                auto &node = task_nodes[pending.node_i];
+                node.kind = "culled";
+                node.uses.clear();
+                culled.push_back(node.name);
+            }
+        }
+        pending_tasks.clear();
+
+        // The lifetimes were extended by the culled tasks too, so re-derive them from the rest.
+        // Transients that only culled tasks used are never allocated.
+        auto written_transients = std::set<ResourceKey>{};
+        for (auto &info : transient_infos) {
+            info.first_task = std::numeric_limits<daxa_u32>::max();
+            info.last_task = 0;
+        }
+        for (auto const &node : task_nodes) {
+            for (auto const &use : node.uses) {
+                if (use.is_persistent) {
+                    continue;
+                }
+                if (use.is_write) {
+                    written_transients.insert({use.type, use.index});
+                }
+                for (auto &info : transient_infos) {
+                    if (info.index == use.index && info.type == use.type) {
+                        info.first_task = std::min(info.first_task, node.task_i);
+                        info.last_task = std::max(info.last_task, node.task_i);
+                    }
+                }
+            }
+        }
+        std::erase_if(transient_infos, [](TransientInfo const &info) { return info.first_task > info.last_task; });
+
+        for (auto &pass : AppUi::DebugDisplay::s_instance->passes) {
+            auto const &view = pass.task_image_id;
+            pass.is_culled = !view.is_empty() && !view.is_persistent() && !written_transients.contains({"image", view.index});
+        }
+        return culled;
+    }
 
     template <typename TaskHeadT, typename PushT, typename InfoT, typename PipelineT>
     auto find_or_add_pipeline(Task<TaskHeadT, PushT, InfoT, PipelineT> &task, std::string const &shader_id) {
@@ -578,15 +1642,116 @@ struct RecordContext {
         }
     }
 
+    void add_tunable_defines(std::vector<daxa::ShaderDefine> &defines, daxa::ShaderSource const &source) const {
+        auto const *file = daxa::get_if<daxa::ShaderFile>(&source);
+        if (file == nullptr) {
+            return;
+        }
+        for (auto &define : tunables.shader_defines(file->path.generic_string())) {
+            auto const is_present = std::any_of(defines.begin(), defines.end(), [&](auto const &other) { return other.name == define.name; });
+            if (!is_present) {
+                defines.push_back(std::move(define));
+            }
+        }
+    }
+
+    template <typename PipelineT>
+    void evict_pipeline(std::string const &shader_id) {
+        if constexpr (std::is_same_v<PipelineT, AsyncManagedComputePipeline>) {
+            if (auto iter = compute_pipelines->find(shader_id); iter != compute_pipelines->end()) {
+                pipeline_manager->retire(std::move(iter->second));
+                compute_pipelines->erase(iter);
+            }
+        } else if constexpr (std::is_same_v<PipelineT, AsyncManagedRasterPipeline>) {
+            if (auto iter = raster_pipelines->find(shader_id); iter != raster_pipelines->end()) {
+                pipeline_manager->retire(std::move(iter->second));
+                raster_pipelines->erase(iter);
+            }
+        }
+    }
+
+    // Task heads recorded more than once (per mip, per filter pass, ...) get an occurrence suffix, so
+    // their profiler zones and nodes can be told apart
+    auto unique_task_name(std::string_view name) -> std::string {
+        auto const occurrence_n = task_name_counts[std::string{name}]++;
+        return occurrence_n == 0 ? std::string{name} : fmt::format("{} #{}", name, occurrence_n + 1);
+    }
+
+    // Adds the task to `task_graph` right away, or holds it back while culling
+    void record_task(std::function<void()> &&record) {
+        if (is_culling) {
+            pending_tasks.push_back({.node_i = task_nodes.size() - 1, .record = std::move(record)});
+        } else {
+            record();
+        }
+    }
+
     template <typename TaskHeadT, typename PushT, typename InfoT, typename PipelineT>
     void add(Task<TaskHeadT, PushT, InfoT, PipelineT> &&task) {
-        auto shader_id = std::string{TaskHeadT::name()};
+        auto variant_id = std::string{TaskHeadT::name()};
         for (auto const &define : task.extra_defines) {
+            variant_id.append(define.name);
+            variant_id.append(define.value);
+        }
+        auto const own_define_n = task.extra_defines.size();
+        if constexpr (std::is_same_v<PipelineT, AsyncManagedComputePipeline>) {
+            add_tunable_defines(task.extra_defines, task.source);
+        } else {
+            add_tunable_defines(task.extra_defines, task.vert_source);
+            add_tunable_defines(task.extra_defines, task.frag_source);
+        }
+        auto shader_id = variant_id;
+        for (auto const &define : std::span{task.extra_defines}.subspan(own_define_n)) {
             shader_id.append(define.name);
             shader_id.append(define.value);
         }
+        auto &current_shader_id = (*pipeline_variants)[variant_id];
+        if (current_shader_id != shader_id) {
+            if (!current_shader_id.empty()) {
+                evict_pipeline<PipelineT>(current_shader_id);
+            }
+            current_shader_id = shader_id;
+        }
         auto pipe_iter = find_or_add_pipeline<TaskHeadT, PushT, InfoT, PipelineT>(task, shader_id);
         task.pipeline = pipe_iter->second;
-        task_graph.add_task(std::move(task));
+        auto name = unique_task_name(TaskHeadT::name());
+        task.profiler_zone = GpuProfiler::add_zone(name);
+        auto node = TaskNodeInfo{
+            .name = std::move(name),
+            .kind = std::is_same_v<PipelineT, AsyncManagedComputePipeline> ? "compute" : "raster",
+            .profiler_zone = task.profiler_zone,
+            .task_i = task_n,
+            .uses = {},
+        };
+        add_resource_uses<TaskHeadT>(node, task.views);
+        task_nodes.push_back(std::move(node));
+        ++task_n;
+        record_task([this, task = std::make_shared<Task<TaskHeadT, PushT, InfoT, PipelineT>>(std::move(task))]() {
+            task_graph.add_task(std::move(*task));
+        });
+    }
+
+    // Same as `task_graph.add_task`, but the task is timed by the GpuProfiler and shows up in `task_nodes`
+    void add_task(daxa::InlineTaskInfo &&info) {
+        auto name = unique_task_name(std::string{info.name});
+        auto const zone_i = GpuProfiler::add_zone(name);
+        auto node = TaskNodeInfo{.name = std::move(name), .kind = "inline", .profiler_zone = zone_i, .task_i = task_n, .uses = {}};
+        for (auto const &attachment : info.attachments) {
+            if (attachment.type == daxa::TaskAttachmentType::IMAGE) {
+                add_resource_use(node, "image", attachment.value.image.view, attachment.value.image.task_access);
+            } else if (attachment.type == daxa::TaskAttachmentType::BUFFER) {
+                add_resource_use(node, "buffer", attachment.value.buffer.view, attachment.value.buffer.task_access);
+            }
+        }
+        task_nodes.push_back(std::move(node));
+        ++task_n;
+        info.task = [task = std::move(info.task), zone_i](daxa::TaskInterface ti) {
+            GpuProfiler::begin_zone(ti.recorder, zone_i);
+            task(ti);
+            GpuProfiler::end_zone(ti.recorder, zone_i);
+        };
+        record_task([this, info = std::make_shared<daxa::InlineTaskInfo>(std::move(info))]() {
+            task_graph.add_task(std::move(*info));
+        });
     }
 };
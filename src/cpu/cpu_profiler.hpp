@@ -0,0 +1,344 @@
+#pragma once
+
+#include "app_ui.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if !defined(ENABLE_CPU_PROFILER)
+#define ENABLE_CPU_PROFILER true
+#endif
+
+// Scoped CPU zones. Every thread writes its zones into its own ring buffer, which only that thread
+// writes to, so recording a zone is two clock reads and a store, with no locks or allocations. Once a
+// frame, the main thread drains every ring buffer into the frame history. Tracks from outside the CPU,
+// like the GpuProfiler's zones, can be added to the same timeline.
+struct CpuProfiler : AppUi::DebugDisplayProvider {
+    using Clock = std::chrono::steady_clock;
+
+    // Must be a power of two
+    static inline constexpr size_t THREAD_ZONE_N = 4096;
+    static inline constexpr size_t FRAME_HISTORY_N = 120;
+    static inline constexpr daxa_u32 EXTERNAL_TRACK_OFFSET = 1000;
+
+    struct RawZone {
+        char const *name;
+        Clock::rep begin;
+        Clock::rep end;
+        daxa_u32 depth;
+    };
+    struct ThreadBuffer {
+        std::array<RawZone, THREAD_ZONE_N> zones{};
+        // Only written by the owning thread. The reader never gets ahead of it.
+        std::atomic<daxa_u64> write_n = 0;
+        daxa_u64 read_n = 0;
+        daxa_u64 dropped_n = 0;
+        daxa_u32 depth = 0;
+        daxa_u32 track = 0;
+        std::atomic_bool in_use = true;
+        std::string name;
+
+        void push(RawZone const &zone) {
+            auto const i = write_n.load(std::memory_order_relaxed);
+            zones[i & (THREAD_ZONE_N - 1)] = zone;
+            write_n.store(i + 1, std::memory_order_release);
+        }
+    };
+
+    struct Zone {
+        std::string name;
+        // In microseconds since `epoch`
+        daxa_f64 begin;
+        daxa_f64 duration;
+        daxa_u32 track;
+        daxa_u32 depth;
+    };
+    struct Frame {
+        daxa_f64 begin;
+        daxa_f64 end;
+        std::vector<Zone> zones;
+    };
+    struct ExternalZone {
+        std::string name;
+        Clock::time_point begin;
+        daxa_f64 duration; // In microseconds
+    };
+
+    inline static CpuProfiler *s_instance = nullptr;
+    inline static Clock::time_point const epoch = Clock::now();
+
+    inline static std::mutex registry_mtx;
+    inline static std::vector<std::unique_ptr<ThreadBuffer>> thread_buffers;
+
+    std::deque<Frame> frames;
+    std::vector<std::string> external_tracks;
+    std::vector<Zone> pending_external_zones;
+    Clock::time_point frame_begin = Clock::now();
+    bool is_paused = false;
+
+    CpuProfiler() {
+        s_instance = this;
+        set_thread_name("main");
+    }
+    CpuProfiler(CpuProfiler const &) = delete;
+    CpuProfiler(CpuProfiler &&) = delete;
+    auto operator=(CpuProfiler const &) -> CpuProfiler & = delete;
+    auto operator=(CpuProfiler &&) -> CpuProfiler & = delete;
+    ~CpuProfiler() override {
+        if (s_instance == this) {
+            s_instance = nullptr;
+        }
+    }
+
+    static auto to_us(Clock::rep ticks) -> daxa_f64 {
+        return std::chrono::duration<daxa_f64, std::micro>(Clock::duration(ticks)).count();
+    }
+    static auto to_us(Clock::time_point time) -> daxa_f64 {
+        return std::chrono::duration<daxa_f64, std::micro>(time - epoch).count();
+    }
+
+    // Registers the calling thread on its first zone. Buffers of exited threads are handed to new threads.
+    static auto thread_buffer() -> ThreadBuffer * {
+        struct ThreadBufferHandle {
+            ThreadBuffer *buffer = nullptr;
+            ~ThreadBufferHandle() {
+                if (buffer != nullptr) {
+                    buffer->in_use = false;
+                }
+            }
+        };
+        thread_local auto handle = ThreadBufferHandle{};
+        if (handle.buffer == nullptr) {
+            auto lock = std::lock_guard{registry_mtx};
+            for (auto &buffer : thread_buffers) {
+                if (!buffer->in_use) {
+                    buffer->in_use = true;
+                    buffer->depth = 0;
+                    handle.buffer = buffer.get();
+                    break;
+                }
+            }
+            if (handle.buffer == nullptr) {
+                thread_buffers.push_back(std::make_unique<ThreadBuffer>());
+                handle.buffer = thread_buffers.back().get();
+                handle.buffer->track = static_cast<daxa_u32>(thread_buffers.size() - 1);
+            }
+            handle.buffer->name = fmt::format("thread {}", handle.buffer->track);
+        }
+        return handle.buffer;
+    }
+    static void set_thread_name(std::string name) {
+        auto *buffer = thread_buffer();
+        auto lock = std::lock_guard{registry_mtx};
+        buffer->name = std::move(name);
+    }
+
+    // Adds zones to a named track that isn't a CPU thread. They show up in the next collected frame.
+    void add_external_zones(std::string const &track_name, std::vector<ExternalZone> const &zones) {
+        auto track_iter = std::find(external_tracks.begin(), external_tracks.end(), track_name);
+        if (track_iter == external_tracks.end()) {
+            external_tracks.push_back(track_name);
+            track_iter = external_tracks.end() - 1;
+        }
+        auto const track = EXTERNAL_TRACK_OFFSET + static_cast<daxa_u32>(track_iter - external_tracks.begin());
+        for (auto const &zone : zones) {
+            pending_external_zones.push_back({.name = zone.name, .begin = to_us(zone.begin), .duration = zone.duration, .track = track, .depth = 0});
+        }
+    }
+
+    // Drains the zones every thread has finished since the last call into a new frame
+    void next_frame() {
+        auto const now = Clock::now();
+        auto frame = Frame{.begin = to_us(frame_begin), .end = to_us(now), .zones = std::move(pending_external_zones)};
+        pending_external_zones.clear();
+        frame_begin = now;
+        {
+            auto lock = std::lock_guard{registry_mtx};
+            for (auto &buffer : thread_buffers) {
+                auto const write_n = buffer->write_n.load(std::memory_order_acquire);
+                if (write_n - buffer->read_n > THREAD_ZONE_N) {
+                    buffer->dropped_n += write_n - buffer->read_n - THREAD_ZONE_N;
+                    buffer->read_n = write_n - THREAD_ZONE_N;
+                }
+                auto const first_zone_i = frame.zones.size();
+                for (auto i = buffer->read_n; i < write_n; ++i) {
+                    auto const &zone = buffer->zones[i & (THREAD_ZONE_N - 1)];
+                    frame.zones.push_back({.name = zone.name, .begin = to_us(zone.begin - epoch.time_since_epoch().count()), .duration = to_us(zone.end - zone.begin), .track = buffer->track, .depth = zone.depth});
+                }
+                // The owning thread may have lapped us while copying, in which case the oldest copies are torn
+                auto const new_write_n = buffer->write_n.load(std::memory_order_acquire);
+                if (new_write_n > buffer->read_n + THREAD_ZONE_N) {
+                    auto const torn_n = std::min<daxa_u64>(new_write_n - buffer->read_n - THREAD_ZONE_N, write_n - buffer->read_n);
+                    frame.zones.erase(frame.zones.begin() + static_cast<std::ptrdiff_t>(first_zone_i), frame.zones.begin() + static_cast<std::ptrdiff_t>(first_zone_i + torn_n));
+                    buffer->dropped_n += torn_n;
+                }
+                buffer->read_n = write_n;
+            }
+        }
+        if (is_paused) {
+            return;
+        }
+        frames.push_back(std::move(frame));
+        while (frames.size() > FRAME_HISTORY_N) {
+            frames.pop_front();
+        }
+    }
+
+    auto track_name(daxa_u32 track) const -> std::string {
+        if (track >= EXTERNAL_TRACK_OFFSET) {
+            return external_tracks[track - EXTERNAL_TRACK_OFFSET];
+        }
+        auto lock = std::lock_guard{registry_mtx};
+        return thread_buffers[track]->name;
+    }
+
+    // Writes the frame history in the Chrome trace event format (chrome://tracing, Perfetto)
+    auto write_chrome_trace(std::filesystem::path const &path) const -> bool {
+        auto file = std::ofstream(path);
+        file << "{\"traceEvents\":[";
+        auto is_first = true;
+        auto write_track_name = [&](daxa_u32 track, std::string const &name) {
+            file << (is_first ? "" : ",") << fmt::format(R"({{"name":"thread_name","ph":"M","pid":0,"tid":{},"args":{{"name":"{}"}}}})", track, name);
+            is_first = false;
+        };
+        {
+            auto lock = std::lock_guard{registry_mtx};
+            for (auto const &buffer : thread_buffers) {
+                write_track_name(buffer->track, buffer->name);
+            }
+        }
+        for (daxa_u32 i = 0; i < external_tracks.size(); ++i) {
+            write_track_name(EXTERNAL_TRACK_OFFSET + i, external_tracks[i]);
+        }
+        for (auto const &frame : frames) {
+            for (auto const &zone : frame.zones) {
+                file << "," << fmt::format(R"({{"name":"{}","ph":"X","pid":0,"tid":{},"ts":{:.3f},"dur":{:.3f}}})", zone.name, zone.track, zone.begin, zone.duration);
+            }
+        }
+        file << "],\"displayTimeUnit\":\"ms\"}";
+        return file.good();
+    }
+
+    void add_ui() override {
+        if (ImGui::TreeNode("CPU Profiler")) {
+            ImGui::Checkbox("Pause", &is_paused);
+            ImGui::SameLine();
+            if (ImGui::Button("Export Chrome Trace")) {
+                auto const trace_path = std::filesystem::path{"cpu_trace.json"};
+                if (write_chrome_trace(trace_path)) {
+                    AppUi::Console::s_instance->add_log(fmt::format("Wrote CPU trace to {}", std::filesystem::absolute(trace_path).string()));
+                }
+            }
+            if (frames.empty()) {
+                ImGui::TreePop();
+                return;
+            }
+            auto const &frame = frames.back();
+            ImGui::Text("frame: %.3f ms | zones: %zu", (frame.end - frame.begin) / 1000.0, frame.zones.size());
+
+            // Timeline of the last frame, one row per track and zone depth
+            auto rows = std::vector<std::pair<daxa_u32, daxa_u32>>{};
+            for (auto const &zone : frame.zones) {
+                auto const row = std::pair{zone.track, zone.depth};
+                if (std::find(rows.begin(), rows.end(), row) == rows.end()) {
+                    rows.push_back(row);
+                }
+            }
+            std::sort(rows.begin(), rows.end());
+            auto const row_height = 18.0f;
+            auto const timeline_pos = ImGui::GetCursorScreenPos();
+            auto const timeline_width = std::max(ImGui::GetContentRegionAvail().x, 1.0f);
+            auto const timeline_height = row_height * static_cast<float>(rows.size());
+            auto *draw_list = ImGui::GetWindowDrawList();
+            draw_list->AddRectFilled(timeline_pos, ImVec2(timeline_pos.x + timeline_width, timeline_pos.y + timeline_height), IM_COL32(32, 32, 32, 255));
+            auto const us_to_px = static_cast<daxa_f64>(timeline_width) / std::max(frame.end - frame.begin, 1.0);
+            for (auto const &zone : frame.zones) {
+                auto const row_i = static_cast<float>(std::find(rows.begin(), rows.end(), std::pair{zone.track, zone.depth}) - rows.begin());
+                auto const x0 = timeline_pos.x + static_cast<float>(std::max(zone.begin - frame.begin, 0.0) * us_to_px);
+                auto const x1 = std::max(timeline_pos.x + static_cast<float>((zone.begin + zone.duration - frame.begin) * us_to_px), x0 + 1.0f);
+                auto const y0 = timeline_pos.y + row_i * row_height;
+                auto const hue = static_cast<float>(std::hash<std::string>{}(zone.name) % 360) / 360.0f;
+                draw_list->AddRectFilled(ImVec2(x0, y0), ImVec2(x1, y0 + row_height - 1.0f), ImColor::HSV(hue, 0.6f, 0.8f));
+                if (ImGui::IsMouseHoveringRect(ImVec2(x0, y0), ImVec2(x1, y0 + row_height))) {
+                    ImGui::SetTooltip("%s (%s): %.3f ms", zone.name.c_str(), track_name(zone.track).c_str(), zone.duration / 1000.0);
+                }
+            }
+            ImGui::Dummy(ImVec2(timeline_width, timeline_height));
+
+            // Per-name totals, averaged over the frame history
+            struct ZoneStats {
+                std::string name;
+                daxa_f64 total;
+                daxa_u64 count;
+            };
+            auto stats = std::vector<ZoneStats>{};
+            for (auto const &history_frame : frames) {
+                for (auto const &zone : history_frame.zones) {
+                    auto iter = std::find_if(stats.begin(), stats.end(), [&zone](auto const &s) { return s.name == zone.name; });
+                    if (iter == stats.end()) {
+                        stats.push_back({.name = zone.name, .total = 0.0, .count = 0});
+                        iter = stats.end() - 1;
+                    }
+                    iter->total += zone.duration;
+                    ++iter->count;
+                }
+            }
+            std::sort(stats.begin(), stats.end(), [](auto const &a, auto const &b) { return a.total > b.total; });
+            if (ImGui::BeginTable("##cpu_zones", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollY, ImVec2(0.0f, 240.0f))) {
+                ImGui::TableSetupColumn("Name");
+                ImGui::TableSetupColumn("ms / frame");
+                ImGui::TableSetupColumn("calls / frame");
+                ImGui::TableHeadersRow();
+                auto const frame_n = static_cast<daxa_f64>(frames.size());
+                for (auto const &s : stats) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%s", s.name.c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", s.total / frame_n / 1000.0);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.1f", static_cast<daxa_f64>(s.count) / frame_n);
+                }
+                ImGui::EndTable();
+            }
+            ImGui::TreePop();
+        }
+    }
+};
+
+#if ENABLE_CPU_PROFILER
+struct CpuProfileZone {
+    CpuProfiler::ThreadBuffer *buffer;
+    char const *name;
+    CpuProfiler::Clock::rep begin;
+
+    explicit CpuProfileZone(char const *a_name)
+        : buffer{CpuProfiler::thread_buffer()}, name{a_name}, begin{CpuProfiler::Clock::now().time_since_epoch().count()} {
+        ++buffer->depth;
+    }
+    CpuProfileZone(CpuProfileZone const &) = delete;
+    CpuProfileZone(CpuProfileZone &&) = delete;
+    auto operator=(CpuProfileZone const &) -> CpuProfileZone & = delete;
+    auto operator=(CpuProfileZone &&) -> CpuProfileZone & = delete;
+    ~CpuProfileZone() {
+        --buffer->depth;
+        buffer->push({.name = name, .begin = begin, .end = CpuProfiler::Clock::now().time_since_epoch().count(), .depth = buffer->depth});
+    }
+};
+
+#define CPU_PROFILE_ZONE_CONCAT_IMPL(a, b) a##b
+#define CPU_PROFILE_ZONE_CONCAT(a, b) CPU_PROFILE_ZONE_CONCAT_IMPL(a, b)
+// `name` must be a string literal, or otherwise outlive the profiler
+#define CPU_PROFILE_ZONE(name) CpuProfileZone const CPU_PROFILE_ZONE_CONCAT(cpu_profile_zone_, __LINE__){name}
+#else
+#define CPU_PROFILE_ZONE(name)
+#endif
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "app_ui.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+// Limits the frame rate to a target FPS. Most of the wait is a sleep, and the rest is a spin, with the
+// spin margin tracking how late the OS scheduler actually wakes us up from sleeps.
+struct FramePacer : AppUi::DebugDisplayProvider {
+    using Clock = std::chrono::steady_clock;
+
+    static inline constexpr size_t FRAME_TIME_N = 240;
+
+    Clock::time_point next_frame_time = Clock::now();
+    Clock::time_point prev_frame_time = Clock::now();
+    std::chrono::duration<double> sleep_slack = std::chrono::milliseconds(1);
+    std::chrono::duration<double> max_sleep_slack{};
+
+    std::array<float, FRAME_TIME_N> frame_times{};
+    size_t frame_time_i = 0;
+    size_t frame_time_n = 0;
+    daxa_f32 target_fps = 0.0f;
+
+    // Blocks until the next frame is due. A `a_target_fps` of 0 disables the limiter.
+    void wait(daxa_f32 a_target_fps) {
+        target_fps = a_target_fps;
+        auto now = Clock::now();
+        if (target_fps <= 0.0f) {
+            next_frame_time = now;
+            end_wait(now);
+            return;
+        }
+        auto const period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / static_cast<double>(target_fps)));
+        // If we fell more than a frame behind, don't try to catch up with a burst of frames
+        if (next_frame_time + period < now) {
+            next_frame_time = now;
+        }
+        auto const sleep_time = std::chrono::duration<double>(next_frame_time - now) - sleep_slack;
+        if (sleep_time.count() > 0.0) {
+            auto const sleep_start = Clock::now();
+            std::this_thread::sleep_for(sleep_time);
+            auto const oversleep = std::chrono::duration<double>(Clock::now() - sleep_start) - sleep_time;
+            max_sleep_slack = std::max(max_sleep_slack, oversleep);
+            // Rise quickly when the scheduler gets worse, and decay slowly
+            if (oversleep > sleep_slack) {
+                sleep_slack += (oversleep - sleep_slack) * 0.5;
+            } else {
+                sleep_slack += (oversleep - sleep_slack) * 0.02;
+            }
+            sleep_slack = std::clamp(sleep_slack, std::chrono::duration<double>(0.0001), std::chrono::duration<double>(0.004));
+        }
+        while (Clock::now() < next_frame_time) {
+            std::this_thread::yield();
+        }
+        next_frame_time += period;
+        end_wait(Clock::now());
+    }
+
+    void end_wait(Clock::time_point now) {
+        frame_times[frame_time_i] = std::chrono::duration<float>(now - prev_frame_time).count();
+        frame_time_i = (frame_time_i + 1) % FRAME_TIME_N;
+        frame_time_n = std::min(frame_time_n + 1, FRAME_TIME_N);
+        prev_frame_time = now;
+    }
+
+    void add_ui() override {
+        if (ImGui::TreeNode("Frame Pacing")) {
+            auto mean = 0.0;
+            auto min_time = 1e9;
+            auto max_time = 0.0;
+            for (size_t i = 0; i < frame_time_n; ++i) {
+                auto const t = static_cast<double>(frame_times[i]);
+                mean += t;
+                min_time = std::min(min_time, t);
+                max_time = std::max(max_time, t);
+            }
+            mean /= static_cast<double>(std::max<size_t>(frame_time_n, 1));
+            auto variance = 0.0;
+            for (size_t i = 0; i < frame_time_n; ++i) {
+                auto const d = static_cast<double>(frame_times[i]) - mean;
+                variance += d * d;
+            }
+            variance /= static_cast<double>(std::max<size_t>(frame_time_n, 1));
+            if (target_fps > 0.0f) {
+                ImGui::Text("target: %.2f ms", 1000.0 / static_cast<double>(target_fps));
+            } else {
+                ImGui::Text("target: unlimited");
+            }
+            ImGui::Text("mean: %.2f ms | std dev: %.3f ms", mean * 1000.0, std::sqrt(variance) * 1000.0);
+            ImGui::Text("min: %.2f ms | max: %.2f ms", min_time * 1000.0, max_time * 1000.0);
+            ImGui::Text("sleep slack: %.3f ms | worst: %.3f ms", sleep_slack.count() * 1000.0, max_sleep_slack.count() * 1000.0);
+            ImGui::PlotLines("##frame_times", frame_times.data(), static_cast<int>(FRAME_TIME_N), static_cast<int>(frame_time_i), nullptr, 0.0f, static_cast<float>(max_time) * 1.25f, ImVec2(0, 80.0f));
+            ImGui::TreePop();
+        }
+    }
+};
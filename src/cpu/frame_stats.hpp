@@ -0,0 +1,255 @@
+#pragma once
+
+#include "app_ui.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+
+// Long-window frame time statistics. Each category is binned into a log-scale histogram with a
+// few percent of resolution per bin, so quantiles over the whole session cost constant memory and
+// time. The most recent raw samples are also kept for exporting.
+struct FrameStats : AppUi::DebugDisplayProvider {
+    enum Category : daxa_u32 {
+        FRAME,
+        CPU_RECORD,
+        GPU,
+        PRESENT_WAIT,
+        CATEGORY_COUNT,
+    };
+    static inline constexpr auto CATEGORY_NAMES = std::array<char const *, CATEGORY_COUNT>{"frame", "cpu_record", "gpu", "present_wait"};
+
+    // In seconds
+    static inline constexpr daxa_f64 HISTOGRAM_MIN = 0.00005;
+    static inline constexpr daxa_f64 HISTOGRAM_MAX = 2.0;
+    static inline constexpr size_t HISTOGRAM_BIN_N = 256;
+    static inline constexpr size_t MAX_RAW_SAMPLE_N = 100'000;
+
+    struct Histogram {
+        std::array<daxa_u64, HISTOGRAM_BIN_N> bins{};
+        daxa_u64 count = 0;
+        daxa_f64 sum = 0.0;
+        daxa_f64 max = 0.0;
+
+        static auto bin_of(daxa_f64 value) -> size_t {
+            auto const t = std::log(std::max(value, HISTOGRAM_MIN) / HISTOGRAM_MIN) / std::log(HISTOGRAM_MAX / HISTOGRAM_MIN);
+            return std::min(static_cast<size_t>(t * HISTOGRAM_BIN_N), HISTOGRAM_BIN_N - 1);
+        }
+        // The geometric middle of the bin
+        static auto value_of(size_t bin) -> daxa_f64 {
+            return HISTOGRAM_MIN * std::pow(HISTOGRAM_MAX / HISTOGRAM_MIN, (static_cast<daxa_f64>(bin) + 0.5) / HISTOGRAM_BIN_N);
+        }
+
+        void add(daxa_f64 value) {
+            ++bins[bin_of(value)];
+            ++count;
+            sum += value;
+            max = std::max(max, value);
+        }
+        auto quantile(daxa_f64 q) const -> daxa_f64 {
+            if (count == 0) {
+                return 0.0;
+            }
+            auto const target = static_cast<daxa_u64>(std::ceil(q * static_cast<daxa_f64>(count)));
+            auto seen = daxa_u64{0};
+            for (size_t i = 0; i < HISTOGRAM_BIN_N; ++i) {
+                seen += bins[i];
+                if (seen >= std::max(target, daxa_u64{1})) {
+                    return std::min(value_of(i), max);
+                }
+            }
+            return max;
+        }
+        auto mean() const -> daxa_f64 {
+            return count != 0 ? sum / static_cast<daxa_f64>(count) : 0.0;
+        }
+    };
+
+    struct Sample {
+        daxa_u64 frame_index;
+        daxa_f64 time;
+        std::array<daxa_f32, CATEGORY_COUNT> values;
+    };
+
+    std::array<Histogram, CATEGORY_COUNT> histograms{};
+    std::vector<Sample> samples;
+    size_t sample_i = 0;
+    daxa_f32 stutter_threshold_ms = 33.3f;
+    daxa_u64 stutter_n = 0;
+    daxa_f64 time = 0.0;
+    daxa_u32 histogram_view_category = FRAME;
+
+    // Values in seconds. Categories that weren't measured this frame are passed as negative.
+    void add_frame(daxa_u64 frame_index, std::array<daxa_f32, CATEGORY_COUNT> const &values) {
+        time += static_cast<daxa_f64>(std::max(values[FRAME], 0.0f));
+        for (daxa_u32 i = 0; i < CATEGORY_COUNT; ++i) {
+            if (values[i] >= 0.0f) {
+                histograms[i].add(static_cast<daxa_f64>(values[i]));
+            }
+        }
+        if (values[FRAME] * 1000.0f > stutter_threshold_ms) {
+            ++stutter_n;
+        }
+        auto const sample = Sample{.frame_index = frame_index, .time = time, .values = values};
+        if (samples.size() < MAX_RAW_SAMPLE_N) {
+            samples.push_back(sample);
+        } else {
+            samples[sample_i] = sample;
+        }
+        sample_i = (sample_i + 1) % MAX_RAW_SAMPLE_N;
+    }
+
+    void reset() {
+        histograms = {};
+        samples.clear();
+        sample_i = 0;
+        stutter_n = 0;
+        time = 0.0;
+    }
+
+    // Oldest first
+    template <typename F>
+    void for_each_sample(F &&f) const {
+        auto const first = samples.size() < MAX_RAW_SAMPLE_N ? size_t{0} : sample_i;
+        for (size_t i = 0; i < samples.size(); ++i) {
+            f(samples[(first + i) % samples.size()]);
+        }
+    }
+
+    auto write_csv(std::filesystem::path const &path) const -> bool {
+        auto file = std::ofstream(path);
+        file << "frame_index,time";
+        for (auto const *name : CATEGORY_NAMES) {
+            file << ',' << name << "_ms";
+        }
+        file << '\n';
+        for_each_sample([&](Sample const &sample) {
+            file << sample.frame_index << ',' << sample.time;
+            for (auto value : sample.values) {
+                file << ',';
+                if (value >= 0.0f) {
+                    file << value * 1000.0f;
+                }
+            }
+            file << '\n';
+        });
+        return file.good();
+    }
+
+    auto summary_json() const -> nlohmann::json {
+        auto result = nlohmann::json{
+            {"frames", histograms[FRAME].count},
+            {"stutter_threshold_ms", stutter_threshold_ms},
+            {"stutters", stutter_n},
+        };
+        for (daxa_u32 i = 0; i < CATEGORY_COUNT; ++i) {
+            auto const &histogram = histograms[i];
+            result[CATEGORY_NAMES[i]] = {
+                {"mean_ms", histogram.mean() * 1000.0},
+                {"p50_ms", histogram.quantile(0.5) * 1000.0},
+                {"p90_ms", histogram.quantile(0.9) * 1000.0},
+                {"p99_ms", histogram.quantile(0.99) * 1000.0},
+                {"p99.9_ms", histogram.quantile(0.999) * 1000.0},
+                {"max_ms", histogram.max * 1000.0},
+            };
+        }
+        return result;
+    }
+
+    auto write_json(std::filesystem::path const &path) const -> bool {
+        auto json = nlohmann::json{{"summary", summary_json()}};
+        auto samples_json = nlohmann::json::array();
+        for_each_sample([&](Sample const &sample) {
+            auto sample_json = nlohmann::json{{"frame_index", sample.frame_index}, {"time", sample.time}};
+            for (daxa_u32 i = 0; i < CATEGORY_COUNT; ++i) {
+                if (sample.values[i] >= 0.0f) {
+                    sample_json[fmt::format("{}_ms", CATEGORY_NAMES[i])] = sample.values[i] * 1000.0f;
+                }
+            }
+            samples_json.push_back(std::move(sample_json));
+        });
+        json["samples"] = std::move(samples_json);
+        auto file = std::ofstream(path);
+        file << std::setw(4) << json;
+        return file.good();
+    }
+
+    void add_ui() override {
+        if (ImGui::TreeNode("Frame Statistics")) {
+            auto const &frame_histogram = histograms[FRAME];
+            ImGui::Text("frames: %llu | time: %.1f s", static_cast<unsigned long long>(frame_histogram.count), time);
+            ImGui::SliderFloat("Stutter Threshold (ms)", &stutter_threshold_ms, 5.0f, 200.0f, "%.1f");
+            ImGui::Text("stutters: %llu (%.3f%%)", static_cast<unsigned long long>(stutter_n), frame_histogram.count != 0 ? static_cast<double>(stutter_n) * 100.0 / static_cast<double>(frame_histogram.count) : 0.0);
+            if (ImGui::BeginTable("##frame_stats", 7, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders)) {
+                ImGui::TableSetupColumn("ms");
+                ImGui::TableSetupColumn("mean");
+                ImGui::TableSetupColumn("p50");
+                ImGui::TableSetupColumn("p90");
+                ImGui::TableSetupColumn("p99");
+                ImGui::TableSetupColumn("p99.9");
+                ImGui::TableSetupColumn("max");
+                ImGui::TableHeadersRow();
+                for (daxa_u32 i = 0; i < CATEGORY_COUNT; ++i) {
+                    auto const &histogram = histograms[i];
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%s", CATEGORY_NAMES[i]);
+                    for (auto value : {histogram.mean(), histogram.quantile(0.5), histogram.quantile(0.9), histogram.quantile(0.99), histogram.quantile(0.999), histogram.max}) {
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.2f", value * 1000.0);
+                    }
+                }
+                ImGui::EndTable();
+            }
+
+            auto category = static_cast<int>(histogram_view_category);
+            ImGui::Combo("Histogram", &category, CATEGORY_NAMES.data(), static_cast<int>(CATEGORY_COUNT));
+            histogram_view_category = static_cast<daxa_u32>(category);
+            auto const &histogram = histograms[histogram_view_category];
+            auto first_bin = HISTOGRAM_BIN_N;
+            auto last_bin = size_t{0};
+            for (size_t i = 0; i < HISTOGRAM_BIN_N; ++i) {
+                if (histogram.bins[i] != 0) {
+                    first_bin = std::min(first_bin, i);
+                    last_bin = i;
+                }
+            }
+            if (first_bin <= last_bin) {
+                // Counts are log-scaled too, so the rare slow frames stay visible
+                auto bin_values = std::vector<float>{};
+                auto max_value = 0.0f;
+                for (auto i = first_bin; i <= last_bin; ++i) {
+                    bin_values.push_back(std::log2(1.0f + static_cast<float>(histogram.bins[i])));
+                    max_value = std::max(max_value, bin_values.back());
+                }
+                auto const label = fmt::format("{:.2f} ms .. {:.2f} ms", Histogram::value_of(first_bin) * 1000.0, Histogram::value_of(last_bin) * 1000.0);
+                ImGui::PlotHistogram("##frame_histogram", bin_values.data(), static_cast<int>(bin_values.size()), 0, label.c_str(), 0.0f, max_value, ImVec2(0, 100.0f));
+            }
+
+            if (ImGui::Button("Reset")) {
+                reset();
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Export CSV")) {
+                auto const path = std::filesystem::path{"frame_stats.csv"};
+                if (write_csv(path)) {
+                    AppUi::Console::s_instance->add_log(fmt::format("Wrote frame statistics to {}", std::filesystem::absolute(path).string()));
+                }
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Export JSON")) {
+                auto const path = std::filesystem::path{"frame_stats.json"};
+                if (write_json(path)) {
+                    AppUi::Console::s_instance->add_log(fmt::format("Wrote frame statistics to {}", std::filesystem::absolute(path).string()));
+                }
+            }
+            ImGui::TreePop();
+        }
+    }
+};
@@ -0,0 +1,178 @@
+#pragma once
+
+#include "app_ui.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Measures how old input is by the time it's copied into the GpuInput upload, and by the time the GPU
+// finishes the frame that carries it (the last timed pass, right before present). A worker thread
+// emits timestamped synthetic input events at a high rate, and the main thread collects them at the
+// same points where it samples real input: at the top of the frame, and at the late latch right
+// before the main task graph is executed.
+struct InputLatencyProbe : AppUi::DebugDisplayProvider {
+    using Clock = std::chrono::steady_clock;
+
+    static inline constexpr auto EVENT_PERIOD = std::chrono::microseconds(500);
+    // GPU and CPU clocks drift apart, so VoxelApp re-syncs them this often while the probe runs
+    static inline constexpr auto CLOCK_SYNC_PERIOD = std::chrono::seconds(5);
+    static inline constexpr size_t MAX_PENDING_FRAME_N = 16;
+
+    // The events uploaded with a frame, until the GpuProfiler resolves when that frame ended
+    struct PendingFrame {
+        daxa_u64 frame_index;
+        std::vector<Clock::time_point> early_events;
+        std::vector<Clock::time_point> late_events;
+    };
+
+    std::thread thread;
+    std::atomic_bool running = false;
+    std::mutex mtx;
+    std::vector<Clock::time_point> events;
+    std::vector<Clock::time_point> sampled_events;
+    // Index into `sampled_events` of the first event collected by the late latch
+    size_t late_events_begin = ~size_t{0};
+
+    std::deque<PendingFrame> pending_frames;
+
+    // Running means, in seconds, of the event age at upload time
+    double early_age_mean = 0.0;
+    double late_age_mean = 0.0;
+    daxa_u64 early_event_n = 0;
+    daxa_u64 late_event_n = 0;
+    // Running means, in seconds, of the event age when the GPU finished its frame
+    double early_frame_end_age_mean = 0.0;
+    double late_frame_end_age_mean = 0.0;
+    daxa_u64 early_frame_end_event_n = 0;
+    daxa_u64 late_frame_end_event_n = 0;
+    double clock_sync_uncertainty = 0.0;
+
+    InputLatencyProbe() = default;
+    InputLatencyProbe(InputLatencyProbe const &) = delete;
+    InputLatencyProbe(InputLatencyProbe &&) = delete;
+    auto operator=(InputLatencyProbe const &) -> InputLatencyProbe & = delete;
+    auto operator=(InputLatencyProbe &&) -> InputLatencyProbe & = delete;
+    ~InputLatencyProbe() override {
+        stop();
+    }
+
+    void start() {
+        if (running) {
+            return;
+        }
+        running = true;
+        early_age_mean = late_age_mean = 0.0;
+        early_event_n = late_event_n = 0;
+        early_frame_end_age_mean = late_frame_end_age_mean = 0.0;
+        early_frame_end_event_n = late_frame_end_event_n = 0;
+        thread = std::thread([this]() {
+            auto next = Clock::now();
+            while (running) {
+                next += EVENT_PERIOD;
+                std::this_thread::sleep_until(next);
+                auto lock = std::lock_guard{mtx};
+                events.push_back(Clock::now());
+            }
+        });
+    }
+    void stop() {
+        running = false;
+        if (thread.joinable()) {
+            thread.join();
+        }
+        events.clear();
+        sampled_events.clear();
+        pending_frames.clear();
+    }
+
+    // Called where input is sampled. Events collected at the late latch are kept apart from the rest.
+    void sample(bool is_late_latch) {
+        if (!running) {
+            return;
+        }
+        auto lock = std::lock_guard{mtx};
+        if (is_late_latch) {
+            late_events_begin = sampled_events.size();
+        }
+        sampled_events.insert(sampled_events.end(), events.begin(), events.end());
+        events.clear();
+    }
+
+    static void add_age(double &mean, daxa_u64 &n, Clock::time_point event, Clock::time_point now) {
+        ++n;
+        mean += (std::chrono::duration<double>(now - event).count() - mean) / static_cast<double>(n);
+    }
+
+    // Called when GpuInput is handed to the upload of the frame with the GpuProfiler's `frame_index`
+    void on_upload(daxa_u64 frame_index) {
+        if (!running) {
+            return;
+        }
+        auto const now = Clock::now();
+        auto frame = PendingFrame{.frame_index = frame_index};
+        for (size_t i = 0; i < sampled_events.size(); ++i) {
+            if (i >= late_events_begin) {
+                add_age(late_age_mean, late_event_n, sampled_events[i], now);
+                frame.late_events.push_back(sampled_events[i]);
+            } else {
+                add_age(early_age_mean, early_event_n, sampled_events[i], now);
+                frame.early_events.push_back(sampled_events[i]);
+            }
+        }
+        sampled_events.clear();
+        late_events_begin = ~size_t{0};
+        pending_frames.push_back(std::move(frame));
+        if (pending_frames.size() > MAX_PENDING_FRAME_N) {
+            pending_frames.pop_front();
+        }
+    }
+
+    // Called when the GpuProfiler resolves a frame, with the CPU time its last pass ended at
+    void on_frame_end(daxa_u64 frame_index, Clock::time_point frame_end, Clock::duration sync_uncertainty) {
+        while (!pending_frames.empty() && pending_frames.front().frame_index < frame_index) {
+            pending_frames.pop_front();
+        }
+        if (pending_frames.empty() || pending_frames.front().frame_index != frame_index) {
+            return;
+        }
+        auto const &frame = pending_frames.front();
+        for (auto const &event : frame.early_events) {
+            add_age(early_frame_end_age_mean, early_frame_end_event_n, event, frame_end);
+        }
+        for (auto const &event : frame.late_events) {
+            add_age(late_frame_end_age_mean, late_frame_end_event_n, event, frame_end);
+        }
+        pending_frames.pop_front();
+        clock_sync_uncertainty = std::chrono::duration<double>(sync_uncertainty).count();
+    }
+
+    void add_ui() override {
+        if (ImGui::TreeNode("Input Latency")) {
+            auto is_running = running.load();
+            if (ImGui::Checkbox("Synthetic Input Probe", &is_running)) {
+                if (is_running) {
+                    start();
+                } else {
+                    stop();
+                }
+            }
+            auto const total_n = early_event_n + late_event_n;
+            auto const mean = total_n != 0 ? (early_age_mean * static_cast<double>(early_event_n) + late_age_mean * static_cast<double>(late_event_n)) / static_cast<double>(total_n) : 0.0;
+            ImGui::Text("mean input age at upload: %.3f ms", mean * 1000.0);
+            ImGui::Text("top of frame: %.3f ms (%llu events)", early_age_mean * 1000.0, static_cast<unsigned long long>(early_event_n));
+            ImGui::Text("late latch: %.3f ms (%llu events)", late_age_mean * 1000.0, static_cast<unsigned long long>(late_event_n));
+            ImGui::Separator();
+            ImGui::Text("input to GPU frame end (+- %.3f ms clock sync)", clock_sync_uncertainty * 1000.0);
+            ImGui::Text("top of frame: %.3f ms (%llu events)", early_frame_end_age_mean * 1000.0, static_cast<unsigned long long>(early_frame_end_event_n));
+            ImGui::Text("late latch: %.3f ms (%llu events)", late_frame_end_age_mean * 1000.0, static_cast<unsigned long long>(late_frame_end_event_n));
+            if (early_frame_end_event_n != 0 && late_frame_end_event_n != 0) {
+                ImGui::Text("late latch saves: %.3f ms", (early_frame_end_age_mean - late_frame_end_age_mean) * 1000.0);
+            }
+            ImGui::TreePop();
+        }
+    }
+};
@@ -0,0 +1,291 @@
+#include "input_recording.hpp"
+
+#include <fmt/format.h>
+#include <imgui_stdlib.h>
+#include <nlohmann/json.hpp>
+
+#include <cstring>
+
+using namespace input_recording;
+
+namespace {
+    template <typename T>
+    void write_value(std::ofstream &file, T const &value) {
+        file.write(reinterpret_cast<char const *>(&value), sizeof(T));
+    }
+
+    // Byte ranges of `curr` that differ from `prev`. Ranges closer than a few bytes are merged, since
+    // each range costs 4 bytes of header.
+    auto diff_ranges(GpuInput const &prev, GpuInput const &curr) -> std::vector<std::pair<uint16_t, uint16_t>> {
+        constexpr auto MERGE_DISTANCE = size_t{4};
+        auto const *prev_bytes = reinterpret_cast<uint8_t const *>(&prev);
+        auto const *curr_bytes = reinterpret_cast<uint8_t const *>(&curr);
+        auto result = std::vector<std::pair<uint16_t, uint16_t>>{};
+        for (size_t i = 0; i < sizeof(GpuInput); ++i) {
+            if (prev_bytes[i] == curr_bytes[i]) {
+                continue;
+            }
+            if (!result.empty() && i - (result.back().first + result.back().second) <= MERGE_DISTANCE) {
+                result.back().second = static_cast<uint16_t>(i + 1 - result.back().first);
+            } else {
+                result.emplace_back(static_cast<uint16_t>(i), uint16_t{1});
+            }
+        }
+        return result;
+    }
+} // namespace
+
+auto InputRecorder::begin(std::filesystem::path const &a_path, AppUi &ui, daxa_f32 &phys_time_accumulator) -> bool {
+    end();
+    path = a_path;
+    file = std::ofstream(path, std::ios::binary);
+    if (!file.is_open()) {
+        AppUi::Console::s_instance->add_log(fmt::format("[error] Failed to open '{}' for recording", path.string()));
+        return false;
+    }
+    auto settings_json = nlohmann::json{};
+    ui.settings.save_json(settings_json);
+    prev_settings = settings_json.dump();
+    prev_gpu_input = {};
+    frame_n = 0;
+
+    write_value(file, MAGIC);
+    write_value(file, VERSION);
+    write_value(file, static_cast<daxa_u32>(sizeof(GpuInput)));
+    write_string(prev_settings);
+
+    ui.should_run_startup = true;
+    phys_time_accumulator = 0.0f;
+    // Reloading the current model puts its load into the recording
+    if (!ui.gvox_model_path.empty()) {
+        ui.should_upload_gvox_model = true;
+    }
+    AppUi::Console::s_instance->add_log(fmt::format("Recording input to '{}'", path.string()));
+    return true;
+}
+
+void InputRecorder::end() {
+    if (!file.is_open()) {
+        return;
+    }
+    write_value(file, RecordType::END);
+    file.close();
+    AppUi::Console::s_instance->add_log(fmt::format("Recorded {} frames to '{}'", frame_n, path.string()));
+}
+
+void InputRecorder::record_model_load(std::string const &model_path) {
+    if (!file.is_open()) {
+        return;
+    }
+    write_value(file, RecordType::MODEL_LOAD);
+    write_string(model_path);
+}
+
+void InputRecorder::record_seed_change(std::string const &seed) {
+    if (!file.is_open()) {
+        return;
+    }
+    write_value(file, RecordType::SEED_CHANGE);
+    write_string(seed);
+}
+
+void InputRecorder::record_frame(GpuInput const &gpu_input, AppSettings const &settings) {
+    if (!file.is_open()) {
+        return;
+    }
+    write_settings_if_changed(settings);
+    auto const ranges = diff_ranges(prev_gpu_input, gpu_input);
+    write_value(file, RecordType::FRAME);
+    write_value(file, static_cast<uint16_t>(ranges.size()));
+    for (auto const &[offset, size] : ranges) {
+        write_value(file, offset);
+        write_value(file, size);
+        file.write(reinterpret_cast<char const *>(&gpu_input) + offset, size);
+    }
+    prev_gpu_input = gpu_input;
+    ++frame_n;
+}
+
+void InputRecorder::write_string(std::string const &str) {
+    write_value(file, static_cast<daxa_u32>(str.size()));
+    file.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+void InputRecorder::write_settings_if_changed(AppSettings const &settings) {
+    auto settings_json = nlohmann::json{};
+    settings.save_json(settings_json);
+    auto settings_str = settings_json.dump();
+    if (settings_str == prev_settings) {
+        return;
+    }
+    write_value(file, RecordType::SETTINGS_CHANGE);
+    write_string(settings_str);
+    prev_settings = std::move(settings_str);
+}
+
+auto InputReplay::load(std::filesystem::path const &a_path) -> std::optional<InputReplay> {
+    auto file = std::ifstream(a_path, std::ios::binary);
+    if (!file.is_open()) {
+        AppUi::Console::s_instance->add_log(fmt::format("[error] Failed to open recording '{}'", a_path.string()));
+        return std::nullopt;
+    }
+    auto result = InputReplay{};
+    result.path = a_path;
+    result.data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    auto header = std::array<daxa_u32, 3>{};
+    if (result.data.size() < sizeof(header)) {
+        AppUi::Console::s_instance->add_log(fmt::format("[error] '{}' is not an input recording", a_path.string()));
+        return std::nullopt;
+    }
+    std::memcpy(header.data(), result.data.data(), sizeof(header));
+    result.cursor = sizeof(header);
+    if (header[0] != MAGIC || header[1] != VERSION) {
+        AppUi::Console::s_instance->add_log(fmt::format("[error] '{}' is not an input recording, or is from an incompatible version", a_path.string()));
+        return std::nullopt;
+    }
+    if (header[2] != sizeof(GpuInput)) {
+        AppUi::Console::s_instance->add_log(fmt::format("[error] '{}' was recorded with a different GpuInput layout ({} bytes, expected {})", a_path.string(), header[2], sizeof(GpuInput)));
+        return std::nullopt;
+    }
+    auto settings = result.read_string();
+    if (!settings) {
+        AppUi::Console::s_instance->add_log(fmt::format("[error] '{}' is truncated", a_path.string()));
+        return std::nullopt;
+    }
+    result.initial_settings = std::move(*settings);
+    return result;
+}
+
+void InputReplay::begin(AppUi &ui, daxa_f32 &phys_time_accumulator) {
+    // The recorded settings only apply for the replay, and must not be saved over the user's
+    ui.begin_temporary_settings();
+    ui.settings.load_json(nlohmann::json::parse(initial_settings, nullptr, false));
+    ui.should_record_task_graph = true;
+    ui.should_upload_seed_data = true;
+    ui.should_run_startup = true;
+    phys_time_accumulator = 0.0f;
+    frame_i = 0;
+    start_time = std::chrono::steady_clock::now();
+    AppUi::Console::s_instance->add_log(fmt::format("Replaying input from '{}'", path.string()));
+}
+
+void InputReplay::begin_frame(GpuInput &out_gpu_input, AppUi &ui) {
+    while (!is_done) {
+        if (cursor >= data.size()) {
+            is_done = true;
+            break;
+        }
+        auto const type = static_cast<RecordType>(data[cursor++]);
+        if (type == RecordType::FRAME) {
+            auto range_n = uint16_t{};
+            if (cursor + sizeof(range_n) > data.size()) {
+                is_done = true;
+                break;
+            }
+            std::memcpy(&range_n, data.data() + cursor, sizeof(range_n));
+            cursor += sizeof(range_n);
+            for (uint16_t i = 0; i < range_n; ++i) {
+                auto range = std::array<uint16_t, 2>{};
+                if (cursor + sizeof(range) > data.size()) {
+                    is_done = true;
+                    break;
+                }
+                std::memcpy(range.data(), data.data() + cursor, sizeof(range));
+                cursor += sizeof(range);
+                if (cursor + range[1] > data.size() || size_t{range[0]} + range[1] > sizeof(GpuInput)) {
+                    is_done = true;
+                    break;
+                }
+                std::memcpy(reinterpret_cast<uint8_t *>(&gpu_input) + range[0], data.data() + cursor, range[1]);
+                cursor += range[1];
+            }
+            break;
+        }
+        if (type == RecordType::END) {
+            is_done = true;
+            break;
+        }
+        auto str = read_string();
+        if (!str) {
+            is_done = true;
+            break;
+        }
+        switch (type) {
+        case RecordType::MODEL_LOAD:
+            ui.gvox_model_path = std::move(*str);
+            ui.should_upload_gvox_model = true;
+            break;
+        case RecordType::SEED_CHANGE:
+            ui.begin_temporary_settings();
+            ui.settings.world_seed_str = std::move(*str);
+            ui.should_upload_seed_data = true;
+            break;
+        case RecordType::SETTINGS_CHANGE:
+            ui.begin_temporary_settings();
+            ui.settings.load_json(nlohmann::json::parse(*str, nullptr, false));
+            ui.should_record_task_graph = true;
+            break;
+        default: break;
+        }
+    }
+    if (is_done) {
+        auto const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        AppUi::Console::s_instance->add_log(fmt::format("Replayed {} frames in {:.2f} s ({:.3f} ms per frame)", frame_i, seconds, frame_i != 0 ? seconds * 1000.0 / frame_i : 0.0));
+        return;
+    }
+
+    // Only the player's input is replayed. Everything derived from settings, resolution or GPU
+    // resources is still filled in by the app.
+    out_gpu_input.time = gpu_input.time;
+    out_gpu_input.delta_time = gpu_input.delta_time;
+    out_gpu_input.frame_index = gpu_input.frame_index;
+    out_gpu_input.flags = gpu_input.flags;
+    out_gpu_input.scripted_cam_pos = gpu_input.scripted_cam_pos;
+    out_gpu_input.scripted_cam_rot = gpu_input.scripted_cam_rot;
+    out_gpu_input.mouse = gpu_input.mouse;
+    std::memcpy(out_gpu_input.actions, gpu_input.actions, sizeof(gpu_input.actions));
+    ++frame_i;
+}
+
+auto InputReplay::read_string() -> std::optional<std::string> {
+    auto size = daxa_u32{};
+    if (cursor + sizeof(size) > data.size()) {
+        return std::nullopt;
+    }
+    std::memcpy(&size, data.data() + cursor, sizeof(size));
+    cursor += sizeof(size);
+    if (cursor + size > data.size()) {
+        return std::nullopt;
+    }
+    auto result = std::string(reinterpret_cast<char const *>(data.data() + cursor), size);
+    cursor += size;
+    return result;
+}
+
+void InputRecordingUi::add_ui() {
+    if (ImGui::TreeNode("Input Recording")) {
+        auto const is_replaying = replay != nullptr && replay->has_value() && !(*replay)->is_done;
+        ImGui::InputText("File", &path);
+        if (recorder->is_recording()) {
+            ImGui::Text("recording: %u frames", recorder->frame_n);
+            if (ImGui::Button("Stop Recording")) {
+                should_toggle_recording = true;
+            }
+        } else if (is_replaying) {
+            ImGui::Text("replaying: frame %u", (*replay)->frame_i);
+            if (ImGui::Button("Stop Replay")) {
+                should_stop_replay = true;
+            }
+        } else {
+            if (ImGui::Button("Start Recording")) {
+                should_toggle_recording = true;
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Replay")) {
+                should_start_replay = true;
+            }
+        }
+        ImGui::TreePop();
+    }
+}
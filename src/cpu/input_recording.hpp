@@ -0,0 +1,91 @@
+#pragma once
+
+#include "app_ui.hpp"
+
+#include <shared/input.inl>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Sessions are recorded as the GpuInput of every frame, along with the UI-side events that don't go
+// through GpuInput (model loads, seed changes and settings changes). Each frame only stores the byte
+// ranges of GpuInput that changed since the previous frame, so a file is tied to the build's GpuInput
+// layout, which is checked on load.
+namespace input_recording {
+    inline constexpr daxa_u32 MAGIC = 0x52494347; // "GCIR"
+    inline constexpr daxa_u32 VERSION = 1;
+
+    enum struct RecordType : uint8_t {
+        FRAME,
+        MODEL_LOAD,
+        SEED_CHANGE,
+        SETTINGS_CHANGE,
+        END = 0xff,
+    };
+} // namespace input_recording
+
+struct InputRecorder {
+    std::ofstream file;
+    std::filesystem::path path;
+    GpuInput prev_gpu_input{};
+    std::string prev_settings;
+    daxa_u32 frame_n = 0;
+
+    auto is_recording() const -> bool { return file.is_open(); }
+
+    // The first recorded frame restarts the world, so the replay starts from the same state. Zeroes
+    // `phys_time_accumulator` (GpuApp's), so physics steps land on the same frames when replayed.
+    auto begin(std::filesystem::path const &a_path, AppUi &ui, daxa_f32 &phys_time_accumulator) -> bool;
+    void end();
+
+    void record_model_load(std::string const &model_path);
+    void record_seed_change(std::string const &seed);
+    // Called with the final GpuInput, right before it's uploaded
+    void record_frame(GpuInput const &gpu_input, AppSettings const &settings);
+
+  private:
+    void write_string(std::string const &str);
+    void write_settings_if_changed(AppSettings const &settings);
+};
+
+struct InputReplay {
+    std::filesystem::path path;
+    std::vector<uint8_t> data;
+    size_t cursor = 0;
+    GpuInput gpu_input{};
+    std::string initial_settings;
+    daxa_u32vec2 output_resolution{};
+
+    daxa_u32 frame_i = 0;
+    std::chrono::steady_clock::time_point start_time{};
+    bool is_done = false;
+
+    static auto load(std::filesystem::path const &a_path) -> std::optional<InputReplay>;
+
+    // Restores the settings the session was recorded with and restarts the world. Zeroes
+    // `phys_time_accumulator` like InputRecorder::begin did, since the replayed delta times only
+    // reproduce the recorded physics steps from the same starting point.
+    void begin(AppUi &ui, daxa_f32 &phys_time_accumulator);
+    // Applies this frame's events to the UI, and the recorded player input to `out_gpu_input`.
+    // Sets `is_done` once the recording runs out.
+    void begin_frame(GpuInput &out_gpu_input, AppUi &ui);
+
+  private:
+    auto read_string() -> std::optional<std::string>;
+};
+
+// Debug UI for starting and stopping recordings and replays. VoxelApp acts on the requests.
+struct InputRecordingUi : AppUi::DebugDisplayProvider {
+    InputRecorder const *recorder = nullptr;
+    std::optional<InputReplay> const *replay = nullptr;
+    std::string path = "session.gcir";
+    bool should_toggle_recording = false;
+    bool should_start_replay = false;
+    bool should_stop_replay = false;
+
+    void add_ui() override;
+};
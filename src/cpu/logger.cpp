@@ -0,0 +1,184 @@
+#include "logger.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <iostream>
+
+Logger::Logger() {
+    s_instance = this;
+    thread = std::thread([this]() { run(); });
+}
+
+Logger::~Logger() {
+    if (s_instance == this) {
+        s_instance = nullptr;
+    }
+    {
+        auto lock = std::lock_guard{sink_mtx};
+        should_stop = true;
+    }
+    sink_cv.notify_one();
+    thread.join();
+}
+
+auto Logger::level_name(LogLevel level) -> char const * {
+    switch (level) {
+    case LogLevel::TRACE: return "trace";
+    case LogLevel::INFO: return "info";
+    case LogLevel::WARN: return "warn";
+    case LogLevel::ERR: return "error";
+    }
+    return "";
+}
+
+auto Logger::thread_buffer() -> ThreadBuffer * {
+    struct ThreadBufferHandle {
+        ThreadBuffer *buffer = nullptr;
+        ~ThreadBufferHandle() {
+            if (buffer != nullptr) {
+                buffer->in_use = false;
+            }
+        }
+    };
+    thread_local auto handle = ThreadBufferHandle{};
+    if (handle.buffer == nullptr) {
+        auto lock = std::lock_guard{registry_mtx};
+        for (auto &buffer : thread_buffers) {
+            if (!buffer->in_use) {
+                buffer->in_use = true;
+                handle.buffer = buffer.get();
+                break;
+            }
+        }
+        if (handle.buffer == nullptr) {
+            thread_buffers.push_back(std::make_unique<ThreadBuffer>());
+            handle.buffer = thread_buffers.back().get();
+        }
+    }
+    return handle.buffer;
+}
+
+void Logger::log(LogLevel level, char const *category, std::string text) {
+    auto *logger = s_instance;
+    if (logger == nullptr) {
+        std::cout << text << '\n';
+        return;
+    }
+    auto *buffer = thread_buffer();
+    auto const i = buffer->write_n.load(std::memory_order_relaxed);
+    while (i - buffer->read_n.load(std::memory_order_acquire) >= THREAD_ENTRY_N) {
+        {
+            auto lock = std::lock_guard{logger->sink_mtx};
+            logger->should_wake = true;
+        }
+        logger->sink_cv.notify_one();
+        std::this_thread::yield();
+    }
+    buffer->entries[i & (THREAD_ENTRY_N - 1)] = Entry{
+        .time = Clock::now().time_since_epoch().count(),
+        .level = level,
+        .category = category,
+        .text = std::move(text),
+    };
+    buffer->write_n.store(i + 1, std::memory_order_release);
+    if (level == LogLevel::ERR) {
+        {
+            auto lock = std::lock_guard{logger->sink_mtx};
+            logger->should_wake = true;
+        }
+        logger->sink_cv.notify_one();
+    }
+}
+
+auto Logger::open_file(std::filesystem::path const &path) -> bool {
+    auto new_file = std::ofstream(path);
+    if (!new_file.is_open()) {
+        log(LogLevel::ERR, "log", fmt::format("[error] Failed to open log file '{}'", path.string()));
+        return false;
+    }
+    auto lock = std::lock_guard{history_mtx};
+    for (auto const &record : history) {
+        new_file << fmt::format("{:10.3f} [{}] [{}] {}\n", record.time, level_name(record.level), record.category, record.text);
+    }
+    file = std::move(new_file);
+    return true;
+}
+
+void Logger::flush() {
+    auto lock = std::unique_lock{sink_mtx};
+    // Two full drains, since one might already be halfway through
+    auto const target_drain_n = drain_n + 2;
+    should_wake = true;
+    sink_cv.notify_one();
+    flushed_cv.wait(lock, [&]() { return drain_n >= target_drain_n || should_stop; });
+}
+
+void Logger::clear_history() {
+    auto lock = std::lock_guard{history_mtx};
+    history.clear();
+}
+
+void Logger::run() {
+    while (true) {
+        auto is_stopping = false;
+        {
+            auto lock = std::unique_lock{sink_mtx};
+            sink_cv.wait_for(lock, SINK_INTERVAL, [this]() { return should_stop || should_wake; });
+            should_wake = false;
+            is_stopping = should_stop;
+        }
+        drain();
+        {
+            auto lock = std::lock_guard{sink_mtx};
+            ++drain_n;
+        }
+        flushed_cv.notify_all();
+        if (is_stopping) {
+            return;
+        }
+    }
+}
+
+void Logger::drain() {
+    auto entries = std::vector<Entry>{};
+    {
+        auto lock = std::lock_guard{registry_mtx};
+        for (auto &buffer : thread_buffers) {
+            auto const read_n = buffer->read_n.load(std::memory_order_relaxed);
+            auto const write_n = buffer->write_n.load(std::memory_order_acquire);
+            for (auto i = read_n; i < write_n; ++i) {
+                entries.push_back(std::move(buffer->entries[i & (THREAD_ENTRY_N - 1)]));
+            }
+            buffer->read_n.store(write_n, std::memory_order_release);
+        }
+    }
+    if (entries.empty()) {
+        return;
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](Entry const &a, Entry const &b) { return a.time < b.time; });
+
+    auto out = std::string{};
+    for (auto const &entry : entries) {
+        if (entry.level >= stdout_level) {
+            out += entry.text;
+            out += '\n';
+        }
+    }
+    std::cout << out << std::flush;
+
+    auto history_lock = std::lock_guard{history_mtx};
+    for (auto &entry : entries) {
+        auto const time = std::chrono::duration<daxa_f64>(Clock::duration(entry.time) - epoch.time_since_epoch()).count();
+        if (file.is_open()) {
+            file << fmt::format("{:10.3f} [{}] [{}] {}\n", time, level_name(entry.level), entry.category, entry.text);
+        }
+        history.push_back({.time = time, .level = entry.level, .category = entry.category, .text = std::move(entry.text)});
+    }
+    while (history.size() > HISTORY_N) {
+        history.pop_front();
+    }
+    if (file.is_open()) {
+        file.flush();
+    }
+}
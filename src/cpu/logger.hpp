@@ -0,0 +1,102 @@
+#pragma once
+
+#include <daxa/daxa.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum struct LogLevel : uint8_t {
+    TRACE,
+    INFO,
+    WARN,
+    ERR,
+};
+
+// Asynchronous logging. Every thread pushes its messages into its own ring buffer, so logging is a
+// clock read and a move of the already formatted string, with no locks or IO. A sink thread drains
+// the ring buffers every few milliseconds, in time order, into a bounded history for the console,
+// stdout and optionally a file. Errors wake the sink right away, so they're written out promptly.
+struct Logger {
+    using Clock = std::chrono::steady_clock;
+
+    // Must be a power of two. A thread that fills its ring waits for the sink rather than losing messages.
+    static inline constexpr size_t THREAD_ENTRY_N = 1024;
+    static inline constexpr size_t HISTORY_N = 8192;
+    static inline constexpr auto SINK_INTERVAL = std::chrono::milliseconds(10);
+
+    struct Entry {
+        Clock::rep time;
+        LogLevel level;
+        // Must be a string literal, or otherwise outlive the logger
+        char const *category;
+        std::string text;
+    };
+    struct ThreadBuffer {
+        std::array<Entry, THREAD_ENTRY_N> entries{};
+        // Only written by the owning thread
+        std::atomic<daxa_u64> write_n = 0;
+        // Only written by the sink
+        std::atomic<daxa_u64> read_n = 0;
+        std::atomic_bool in_use = true;
+    };
+
+    struct Record {
+        daxa_f64 time; // Seconds since `epoch`
+        LogLevel level;
+        char const *category;
+        std::string text;
+    };
+
+    inline static Logger *s_instance = nullptr;
+    inline static Clock::time_point const epoch = Clock::now();
+
+    inline static std::mutex registry_mtx;
+    inline static std::vector<std::unique_ptr<ThreadBuffer>> thread_buffers;
+
+    // Guards `history` and the log file. Only the sink adds to them.
+    std::mutex history_mtx;
+    std::deque<Record> history;
+    LogLevel stdout_level = LogLevel::INFO;
+
+    Logger();
+    Logger(Logger const &) = delete;
+    Logger(Logger &&) = delete;
+    auto operator=(Logger const &) -> Logger & = delete;
+    auto operator=(Logger &&) -> Logger & = delete;
+    ~Logger();
+
+    // Safe to call from any thread, and before or after the logger exists
+    static void log(LogLevel level, char const *category, std::string text);
+
+    // Also writes every message to `path`, starting with the ones still in the history
+    auto open_file(std::filesystem::path const &path) -> bool;
+    // Blocks until everything logged so far has been written out
+    void flush();
+    void clear_history();
+
+    static auto level_name(LogLevel level) -> char const *;
+
+  private:
+    static auto thread_buffer() -> ThreadBuffer *;
+    void run();
+    void drain();
+
+    std::thread thread;
+    std::mutex sink_mtx;
+    std::condition_variable sink_cv;
+    std::condition_variable flushed_cv;
+    bool should_stop = false;
+    bool should_wake = false;
+    daxa_u64 drain_n = 0;
+    std::ofstream file;
+};
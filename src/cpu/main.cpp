@@ -1,6 +1,6 @@
 #include "voxel_app.hpp"
 
-auto main() -> int {
-    auto app = VoxelApp{};
+auto main(int argc, char const *argv[]) -> int {
+    auto app = VoxelApp{LaunchOptions::parse({argv + 1, static_cast<size_t>(argc - 1)})};
     app.run();
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cpu/mesh_model.hpp>
+#include <cpu/core.hpp>
 
 #include <daxa/gpu_resources.hpp>
 #include <daxa/utils/task_graph.hpp>
@@ -105,7 +106,7 @@ namespace {
     };
 } // namespace
 
-void open_mesh_model(daxa::Device device, MeshModel &model, std::filesystem::path const &filepath, std::string const &name) {
+void open_mesh_model(daxa::Device device, StagingBufferPool &staging_pool, MeshModel &model, std::filesystem::path const &filepath, std::string const &name) {
     Assimp::Importer import{};
     aiScene const *scene = import.ReadFile(filepath.string(), aiProcess_Triangulate | aiProcess_GenBoundingBoxes);
     if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
@@ -115,7 +116,7 @@ void open_mesh_model(daxa::Device device, MeshModel &model, std::filesystem::pat
     model.bound_min = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
     model.bound_max = {std::numeric_limits<float>::min(), std::numeric_limits<float>::min(), std::numeric_limits<float>::min()};
     process_node(device, model, scene->mRootNode, scene, filepath.parent_path(), {{1, 0, 0, 0}, {0, 0, -1, 0}, {0, 1, 0, 0}, {0, 0, 0, 1}});
-    auto texture_staging_buffers = std::vector<daxa::BufferId>{};
+    auto texture_stagings = std::vector<StagingBufferPool::Allocation>{};
     daxa::TaskGraph mip_task_list = daxa::TaskGraph({
         .device = device,
         .name = "mesh upload task list",
@@ -155,12 +156,9 @@ void open_mesh_model(daxa::Device device, MeshModel &model, std::filesystem::pat
         auto data = texture->pixels;
         auto &image_id = texture->image_id;
         size_t image_size = sx * sy * sizeof(uint8_t) * dst_channel_n;
-        auto texture_staging_buffer = device.create_buffer({
-            .size = static_cast<uint32_t>(image_size),
-            .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
-            .name = "texture_staging_buffer",
-        });
-        auto *staging_buffer_ptr = device.get_host_address_as<uint8_t>(texture_staging_buffer).value();
+        auto texture_staging = staging_pool.acquire(device, image_size);
+        auto texture_staging_buffer = texture_staging.buffer;
+        auto *staging_buffer_ptr = texture_staging.ptr;
         for (size_t i = 0; i < sx * sy; ++i) {
             size_t src_offset = i * src_channel_n;
             size_t dst_offset = i * dst_channel_n;
@@ -168,7 +166,7 @@ void open_mesh_model(daxa::Device device, MeshModel &model, std::filesystem::pat
                 staging_buffer_ptr[ci + dst_offset] = data[ci + src_offset];
             }
         }
-        texture_staging_buffers.push_back(texture_staging_buffer);
+        texture_stagings.push_back(texture_staging);
 
         texture->task_image = daxa::TaskImage(daxa::TaskImageInfo{
             .initial_images = {
@@ -251,8 +249,8 @@ void open_mesh_model(daxa::Device device, MeshModel &model, std::filesystem::pat
     mip_task_list.complete({});
     mip_task_list.execute({});
     device.wait_idle();
-    for (auto texture_staging_buffer : texture_staging_buffers) {
-        device.destroy_buffer(texture_staging_buffer);
+    for (auto const &texture_staging : texture_stagings) {
+        staging_pool.release(texture_staging);
     }
     for (auto *fi_bitmap : fi_bitmaps) {
         FreeImage_Unload(fi_bitmap);
@@ -4,6 +4,8 @@
 #include <daxa/utils/task_graph.hpp>
 #include <shared/utils/mesh_model.inl>
 
+struct StagingBufferPool;
+
 struct Texture {
     std::filesystem::path path;
     daxa::ImageId image_id;
@@ -27,4 +29,4 @@ struct MeshModel {
     daxa_f32vec3 bound_max;
 };
 
-void open_mesh_model(daxa::Device device, MeshModel &model, std::filesystem::path const &filepath, std::string const &name);
+void open_mesh_model(daxa::Device device, StagingBufferPool &staging_pool, MeshModel &model, std::filesystem::path const &filepath, std::string const &name);
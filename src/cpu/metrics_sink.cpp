@@ -0,0 +1,125 @@
+#include "metrics_sink.hpp"
+
+#include "app_ui.hpp"
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+auto MetricsSink::start(Info const &a_info) -> bool {
+    stop();
+    info = a_info;
+    if (info.path.has_parent_path()) {
+        auto ec = std::error_code{};
+        std::filesystem::create_directories(info.path.parent_path(), ec);
+    }
+    open_file();
+    if (!file.is_open()) {
+        AppUi::Console::s_instance->add_log(fmt::format("[error] Failed to open '{}' for metrics", info.path.string()));
+        return false;
+    }
+    start_time = Clock::now();
+    should_stop = false;
+    thread = std::thread([this]() { run(); });
+    AppUi::Console::s_instance->add_log(fmt::format("Writing metrics to '{}' every {:.2f} s", info.path.string(), info.interval));
+    return true;
+}
+
+void MetricsSink::stop() {
+    if (!thread.joinable()) {
+        return;
+    }
+    {
+        auto lock = std::lock_guard{wake_mtx};
+        should_stop = true;
+    }
+    wake_cv.notify_one();
+    thread.join();
+    file.close();
+}
+
+auto MetricsSink::add_metric(std::string name, Kind kind) -> Metric & {
+    auto lock = std::lock_guard{metrics_mtx};
+    auto &metric = metrics.emplace_back();
+    metric.name = std::move(name);
+    metric.kind = kind;
+    return metric;
+}
+
+void MetricsSink::run() {
+    auto const interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<daxa_f64>(info.interval));
+    auto next_sample_time = Clock::now() + interval;
+    while (true) {
+        auto lock = std::unique_lock{wake_mtx};
+        // Sleeping until an absolute time keeps the samples from drifting
+        if (wake_cv.wait_until(lock, next_sample_time, [this]() { return should_stop; })) {
+            lock.unlock();
+            write_sample();
+            return;
+        }
+        lock.unlock();
+        write_sample();
+        next_sample_time += interval;
+    }
+}
+
+void MetricsSink::write_sample() {
+    auto sample = nlohmann::json{
+        {"t", std::chrono::duration<daxa_f64>(Clock::now() - start_time).count()},
+        {"unix_ms", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count()},
+    };
+    {
+        auto lock = std::lock_guard{metrics_mtx};
+        for (auto &metric : metrics) {
+            if (metric.kind != Kind::SUMMARY) {
+                sample[metric.name] = metric.value.load(std::memory_order_relaxed);
+                continue;
+            }
+            auto summary_lock = std::lock_guard{metric.summary_mtx};
+            if (metric.summary_n == 0) {
+                sample[metric.name] = nullptr;
+            } else {
+                sample[metric.name] = {
+                    {"mean", metric.summary_sum / static_cast<daxa_f64>(metric.summary_n)},
+                    {"max", metric.summary_max},
+                    {"n", metric.summary_n},
+                };
+            }
+            metric.summary_sum = 0.0;
+            metric.summary_max = 0.0;
+            metric.summary_n = 0;
+        }
+    }
+    auto const line = sample.dump() + '\n';
+    if (file_size + line.size() > info.max_file_size) {
+        rotate();
+    }
+    if (!file.is_open()) {
+        return;
+    }
+    file << line;
+    file.flush();
+    file_size += line.size();
+}
+
+void MetricsSink::open_file() {
+    file = std::ofstream(info.path, std::ios::app);
+    auto ec = std::error_code{};
+    auto const size = std::filesystem::file_size(info.path, ec);
+    file_size = ec ? 0 : static_cast<size_t>(size);
+}
+
+void MetricsSink::rotate() {
+    file.close();
+    auto rotated_path = [this](daxa_u32 i) {
+        auto result = info.path;
+        result += fmt::format(".{}", i);
+        return result;
+    };
+    auto ec = std::error_code{};
+    std::filesystem::remove(rotated_path(info.max_file_n), ec);
+    for (auto i = info.max_file_n; i > 1; --i) {
+        std::filesystem::rename(rotated_path(i - 1), rotated_path(i), ec);
+    }
+    std::filesystem::rename(info.path, rotated_path(1), ec);
+    open_file();
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <daxa/daxa.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Appends a JSON line with the value of every registered metric at a fixed interval, for soak runs
+// where nobody is looking at the UI. Metrics are updated from any thread with atomics (or a tiny lock,
+// for summaries), and all the formatting and file IO happens on the sink's own thread. When the file
+// gets too big it's rotated to `<path>.1`, `<path>.2`, and so on.
+struct MetricsSink {
+    using Clock = std::chrono::steady_clock;
+
+    enum struct Kind {
+        // The latest value
+        GAUGE,
+        // A running total
+        COUNTER,
+        // Mean, max and count of the values recorded since the previous sample
+        SUMMARY,
+    };
+
+    struct Metric {
+        std::string name;
+        Kind kind = Kind::GAUGE;
+        std::atomic<daxa_f64> value = 0.0;
+        std::mutex summary_mtx;
+        daxa_f64 summary_sum = 0.0;
+        daxa_f64 summary_max = 0.0;
+        daxa_u64 summary_n = 0;
+
+        void set(daxa_f64 v) { value.store(v, std::memory_order_relaxed); }
+        void add(daxa_f64 v) { value.fetch_add(v, std::memory_order_relaxed); }
+        void record(daxa_f64 v) {
+            auto lock = std::lock_guard{summary_mtx};
+            summary_sum += v;
+            summary_max = summary_n == 0 ? v : std::max(summary_max, v);
+            ++summary_n;
+        }
+    };
+
+    struct Info {
+        std::filesystem::path path;
+        daxa_f64 interval = 1.0; // In seconds
+        size_t max_file_size = 64 * 1024 * 1024;
+        daxa_u32 max_file_n = 4;
+    };
+
+    MetricsSink() = default;
+    MetricsSink(MetricsSink const &) = delete;
+    MetricsSink(MetricsSink &&) = delete;
+    auto operator=(MetricsSink const &) -> MetricsSink & = delete;
+    auto operator=(MetricsSink &&) -> MetricsSink & = delete;
+    ~MetricsSink() { stop(); }
+
+    // Metrics can be registered before or after starting. The returned references stay valid for the
+    // lifetime of the sink.
+    auto gauge(std::string name) -> Metric & { return add_metric(std::move(name), Kind::GAUGE); }
+    auto counter(std::string name) -> Metric & { return add_metric(std::move(name), Kind::COUNTER); }
+    auto summary(std::string name) -> Metric & { return add_metric(std::move(name), Kind::SUMMARY); }
+
+    auto start(Info const &a_info) -> bool;
+    // Writes a final sample and joins the thread
+    void stop();
+    auto is_running() const -> bool { return thread.joinable(); }
+
+  private:
+    auto add_metric(std::string name, Kind kind) -> Metric &;
+    void run();
+    void write_sample();
+    void open_file();
+    void rotate();
+
+    Info info;
+    std::deque<Metric> metrics;
+    std::mutex metrics_mtx;
+    std::thread thread;
+    std::mutex wake_mtx;
+    std::condition_variable wake_cv;
+    bool should_stop = false;
+    std::ofstream file;
+    size_t file_size = 0;
+    Clock::time_point start_time;
+};
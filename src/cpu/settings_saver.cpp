@@ -0,0 +1,90 @@
+#include "settings_saver.hpp"
+#include "logger.hpp"
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include <fstream>
+#include <iomanip>
+
+SettingsSaver::SettingsSaver(std::filesystem::path a_path) : path{std::move(a_path)} {
+    thread = std::thread([this]() { run(); });
+}
+
+SettingsSaver::~SettingsSaver() {
+    {
+        auto lock = std::lock_guard{mtx};
+        should_stop = true;
+    }
+    cv.notify_one();
+    thread.join();
+}
+
+void SettingsSaver::request(AppSettings const &settings) {
+    {
+        auto lock = std::lock_guard{mtx};
+        auto const now = Clock::now();
+        if (!pending) {
+            first_request_time = now;
+        }
+        last_request_time = now;
+        pending = settings;
+    }
+    cv.notify_one();
+}
+
+void SettingsSaver::flush() {
+    auto lock = std::unique_lock{mtx};
+    should_flush = true;
+    cv.notify_one();
+    written_cv.wait(lock, [this]() { return (!pending && !is_writing) || should_stop; });
+}
+
+void SettingsSaver::run() {
+    auto lock = std::unique_lock{mtx};
+    while (true) {
+        if (!pending) {
+            should_flush = false;
+            written_cv.notify_all();
+            if (should_stop) {
+                return;
+            }
+            cv.wait(lock, [this]() { return pending.has_value() || should_stop || should_flush; });
+            continue;
+        }
+        auto const deadline = std::min(last_request_time + QUIET_TIME, first_request_time + MAX_DELAY);
+        if (!should_flush && !should_stop && Clock::now() < deadline) {
+            // Woken early by every new request, which may push the deadline back
+            cv.wait_until(lock, deadline);
+            continue;
+        }
+        auto settings = std::move(*pending);
+        pending.reset();
+        is_writing = true;
+        lock.unlock();
+        write(settings);
+        lock.lock();
+        is_writing = false;
+    }
+}
+
+void SettingsSaver::write(AppSettings const &settings) {
+    auto json = nlohmann::json{};
+    settings.save_json(json);
+    auto temp_path = path;
+    temp_path += ".tmp";
+    {
+        auto f = std::ofstream(temp_path);
+        f << std::setw(4) << json;
+        f.close();
+        if (f.fail()) {
+            Logger::log(LogLevel::ERR, "settings", fmt::format("[error] Failed to write '{}'", temp_path.string()));
+            return;
+        }
+    }
+    auto ec = std::error_code{};
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec) {
+        Logger::log(LogLevel::ERR, "settings", fmt::format("[error] Failed to replace '{}': {}", path.string(), ec.message()));
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "app_settings.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+// Writes the settings file from its own thread, so the frame loop only pays for copying the settings.
+// Requests are debounced: a save happens once no new request came in for `QUIET_TIME`, or `MAX_DELAY`
+// after the first unsaved request, so dragging a slider writes the file a few times rather than every
+// frame. The file is written next to the destination and then renamed over it, so a crash mid-write
+// never leaves a partial file behind.
+struct SettingsSaver {
+    using Clock = std::chrono::steady_clock;
+
+    static inline constexpr auto QUIET_TIME = std::chrono::milliseconds(250);
+    static inline constexpr auto MAX_DELAY = std::chrono::milliseconds(1000);
+
+    SettingsSaver(std::filesystem::path a_path);
+    SettingsSaver(SettingsSaver const &) = delete;
+    SettingsSaver(SettingsSaver &&) = delete;
+    auto operator=(SettingsSaver const &) -> SettingsSaver & = delete;
+    auto operator=(SettingsSaver &&) -> SettingsSaver & = delete;
+    // Writes any pending save before returning
+    ~SettingsSaver();
+
+    // Replaces any snapshot still waiting to be written
+    void request(AppSettings const &settings);
+    // Blocks until everything requested so far has been written
+    void flush();
+
+  private:
+    void run();
+    void write(AppSettings const &settings);
+
+    std::filesystem::path path;
+    std::thread thread;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::condition_variable written_cv;
+    std::optional<AppSettings> pending;
+    Clock::time_point first_request_time;
+    Clock::time_point last_request_time;
+    bool is_writing = false;
+    bool should_flush = false;
+    bool should_stop = false;
+};
@@ -0,0 +1,141 @@
+#include "startup_timer.hpp"
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <map>
+
+#if defined(_WIN32)
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#endif
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <ctime>
+#endif
+
+StartupTimer::Scope::Scope(char const *name)
+#if ENABLE_CPU_PROFILER
+    : zone{name}
+#endif
+{
+    auto *timer = StartupTimer::s_instance;
+    if (timer == nullptr || timer->is_finished) {
+        return;
+    }
+    phase_i = timer->phases.size();
+    timer->phases.push_back({.name = name, .depth = timer->depth, .wall_time = 0.0, .cpu_time = 0.0});
+    ++timer->depth;
+    wall_start = Clock::now();
+    cpu_start = process_cpu_time();
+}
+
+StartupTimer::Scope::~Scope() {
+    auto *timer = StartupTimer::s_instance;
+    if (timer == nullptr || phase_i == ~size_t{0}) {
+        return;
+    }
+    --timer->depth;
+    auto &phase = timer->phases[phase_i];
+    phase.wall_time = std::chrono::duration<daxa_f64>(Clock::now() - wall_start).count();
+    phase.cpu_time = process_cpu_time() - cpu_start;
+}
+
+auto StartupTimer::process_cpu_time() -> daxa_f64 {
+#if defined(_WIN32)
+    auto creation_time = FILETIME{};
+    auto exit_time = FILETIME{};
+    auto kernel_time = FILETIME{};
+    auto user_time = FILETIME{};
+    GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time, &kernel_time, &user_time);
+    auto to_100ns = [](FILETIME const &t) { return (static_cast<daxa_u64>(t.dwHighDateTime) << 32) | t.dwLowDateTime; };
+    return static_cast<daxa_f64>(to_100ns(kernel_time) + to_100ns(user_time)) * 1e-7;
+#else
+    auto t = timespec{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &t);
+    return static_cast<daxa_f64>(t.tv_sec) + static_cast<daxa_f64>(t.tv_nsec) * 1e-9;
+#endif
+}
+
+void StartupTimer::finish(CpuProfiler &cpu_profiler, std::filesystem::path const &data_directory) {
+    is_finished = true;
+    auto const total_time = std::chrono::duration<daxa_f64>(Clock::now() - start).count();
+    auto &console = *AppUi::Console::s_instance;
+
+    console.add_log(fmt::format("startup: {:.3f} s", total_time));
+    console.add_log(fmt::format("  {:<40} {:>10} {:>10} {:>7}", "phase", "wall ms", "cpu ms", "cpu/wall"));
+    for (auto const &phase : phases) {
+        auto const name = std::string(phase.depth * 2, ' ') + phase.name;
+        auto const ratio = phase.wall_time > 0.0 ? phase.cpu_time / phase.wall_time : 0.0;
+        console.add_log(fmt::format("  {:<40} {:>10.2f} {:>10.2f} {:>7.2f}", name, phase.wall_time * 1000.0, phase.cpu_time * 1000.0, ratio));
+    }
+
+    // Pipeline compiles run on the thread pool, so their concurrency comes from the CpuProfiler zones
+    cpu_profiler.next_frame();
+    if (!cpu_profiler.frames.empty()) {
+        struct ThreadStats {
+            daxa_u32 job_n = 0;
+            daxa_f64 busy = 0.0;
+        };
+        auto thread_stats = std::map<daxa_u32, ThreadStats>{};
+        auto first_begin = std::numeric_limits<daxa_f64>::max();
+        auto last_end = 0.0;
+        auto total_busy = 0.0;
+        for (auto const &zone : cpu_profiler.frames.back().zones) {
+            if (zone.name != "ThreadPool job") {
+                continue;
+            }
+            auto &stats = thread_stats[zone.track];
+            ++stats.job_n;
+            stats.busy += zone.duration;
+            total_busy += zone.duration;
+            first_begin = std::min(first_begin, zone.begin);
+            last_end = std::max(last_end, zone.begin + zone.duration);
+        }
+        if (!thread_stats.empty()) {
+            auto const span = last_end - first_begin;
+            console.add_log(fmt::format("  pipeline compiles: {:.2f} ms busy over {:.2f} ms on {} threads (avg concurrency {:.2f})", total_busy / 1000.0, span / 1000.0, thread_stats.size(), span > 0.0 ? total_busy / span : 0.0));
+            for (auto const &[track, stats] : thread_stats) {
+                console.add_log(fmt::format("    {:<20} {:>4} jobs {:>10.2f} ms", cpu_profiler.track_name(track), stats.job_n, stats.busy / 1000.0));
+            }
+        }
+    }
+
+    auto const trace_path = std::filesystem::path{"startup_trace.json"};
+    if (cpu_profiler.write_chrome_trace(trace_path)) {
+        console.add_log(fmt::format("  wrote startup trace to {}", std::filesystem::absolute(trace_path).string()));
+    }
+
+    // One line per launch. The first launch after a reboot or driver update is the cold one.
+    auto const history_path = data_directory / "startup_history.jsonl";
+    {
+        auto history_file = std::ifstream(history_path);
+        auto line = std::string{};
+        auto prev_line = std::string{};
+        while (std::getline(history_file, line)) {
+            if (!line.empty()) {
+                prev_line = std::move(line);
+            }
+        }
+        auto const prev_launch = nlohmann::json::parse(prev_line, nullptr, false);
+        if (!prev_launch.is_discarded() && prev_launch.contains("total_s")) {
+            console.add_log(fmt::format("  previous launch: {:.3f} s", prev_launch["total_s"].get<daxa_f64>()));
+        }
+    }
+    auto launch = nlohmann::json{
+        {"timestamp", std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count()},
+        {"total_s", total_time},
+        {"phases", nlohmann::json::array()},
+    };
+    for (auto const &phase : phases) {
+        launch["phases"].push_back({{"name", phase.name}, {"depth", phase.depth}, {"wall_ms", phase.wall_time * 1000.0}, {"cpu_ms", phase.cpu_time * 1000.0}});
+    }
+    auto history_file = std::ofstream(history_path, std::ios::app);
+    history_file << launch.dump() << '\n';
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "cpu_profiler.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Times the phases of startup, up to and including the first frame. Phases can nest, and code that
+// runs during startup can open its own phases through `s_instance`. CPU time is for the whole process,
+// so a phase with more CPU than wall time had other threads working.
+struct StartupTimer {
+    using Clock = std::chrono::steady_clock;
+
+    struct Phase {
+        std::string name;
+        daxa_u32 depth;
+        daxa_f64 wall_time;
+        daxa_f64 cpu_time;
+    };
+
+    struct Scope {
+        size_t phase_i = ~size_t{0};
+        Clock::time_point wall_start;
+        daxa_f64 cpu_start = 0.0;
+#if ENABLE_CPU_PROFILER
+        CpuProfileZone zone;
+#endif
+
+        explicit Scope(char const *name);
+        Scope(Scope const &) = delete;
+        Scope(Scope &&) = delete;
+        auto operator=(Scope const &) -> Scope & = delete;
+        auto operator=(Scope &&) -> Scope & = delete;
+        ~Scope();
+    };
+
+    inline static StartupTimer *s_instance = nullptr;
+
+    Clock::time_point start = Clock::now();
+    std::vector<Phase> phases;
+    daxa_u32 depth = 0;
+    bool is_finished = false;
+
+    StartupTimer() { s_instance = this; }
+    StartupTimer(StartupTimer const &) = delete;
+    StartupTimer(StartupTimer &&) = delete;
+    auto operator=(StartupTimer const &) -> StartupTimer & = delete;
+    auto operator=(StartupTimer &&) -> StartupTimer & = delete;
+    ~StartupTimer() {
+        if (s_instance == this) {
+            s_instance = nullptr;
+        }
+    }
+
+    // For timing member initializers
+    template <typename F>
+    auto time(char const *name, F &&f) {
+        auto const scope = Scope{name};
+        return f();
+    }
+
+    // Logs the phase table and pipeline compile concurrency, writes the startup trace, and appends
+    // this launch to the startup history so cold and warm launches can be compared.
+    void finish(CpuProfiler &cpu_profiler, std::filesystem::path const &data_directory);
+
+    // Seconds of CPU time used by every thread of the process
+    static auto process_cpu_time() -> daxa_f64;
+};
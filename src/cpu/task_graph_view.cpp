@@ -0,0 +1,238 @@
+#include "task_graph_view.hpp"
+
+#include <imgui_node_editor.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <optional>
+
+namespace ed = ax::NodeEditor;
+
+namespace {
+    auto node_id(size_t node_i) -> ed::NodeId { return ed::NodeId(node_i * 3 + 1); }
+    auto input_pin_id(size_t node_i) -> ed::PinId { return ed::PinId(node_i * 3 + 2); }
+    auto output_pin_id(size_t node_i) -> ed::PinId { return ed::PinId(node_i * 3 + 3); }
+    auto link_id(size_t edge_i) -> ed::LinkId { return ed::LinkId(edge_i + 1); }
+
+    auto hazard_name(TaskGraphView::Hazard hazard) -> char const * {
+        switch (hazard) {
+        case TaskGraphView::Hazard::READ_AFTER_WRITE: return "read after write";
+        case TaskGraphView::Hazard::WRITE_AFTER_READ: return "write after read";
+        case TaskGraphView::Hazard::WRITE_AFTER_WRITE: return "write after write";
+        }
+        return "";
+    }
+} // namespace
+
+TaskGraphView::~TaskGraphView() {
+    if (editor != nullptr) {
+        ed::DestroyEditor(editor);
+    }
+}
+
+void TaskGraphView::set_graph(std::vector<RecordContext::TaskNodeInfo> &&task_nodes, std::vector<RecordContext::TransientInfo> const &transient_infos) {
+    nodes.clear();
+    edges.clear();
+    unread_write_n = 0;
+    for (auto &info : task_nodes) {
+        nodes.push_back({.info = std::move(info)});
+    }
+
+    struct ResourceState {
+        std::optional<size_t> writer;
+        std::vector<size_t> readers;
+    };
+    auto resource_states = std::map<std::tuple<std::string, bool, daxa_u32>, ResourceState>{};
+    auto resource_name = [&](RecordContext::TaskNodeInfo::ResourceUse const &use) -> std::string {
+        if (!use.is_persistent) {
+            for (auto const &info : transient_infos) {
+                if (info.index == use.index && info.type == use.type) {
+                    return info.name;
+                }
+            }
+        }
+        return fmt::format("{} {} #{}", use.is_persistent ? "persistent" : "transient", use.type, use.index);
+    };
+    auto add_edge = [&](size_t src, size_t dst, RecordContext::TaskNodeInfo::ResourceUse const &use, Hazard hazard, bool is_unread_write) {
+        if (src == dst) {
+            return;
+        }
+        edges.push_back({.src = src, .dst = dst, .resource = resource_name(use), .hazard = hazard, .is_unread_write = is_unread_write});
+        ++nodes[dst].barrier_n;
+    };
+
+    for (size_t node_i = 0; node_i < nodes.size(); ++node_i) {
+        for (auto const &use : nodes[node_i].info.uses) {
+            nodes[node_i].use_labels.push_back(fmt::format("{} {}", use.is_write ? (use.is_read ? "reads/writes" : "writes") : "reads", resource_name(use)));
+            auto &state = resource_states[{use.type, use.is_persistent, use.index}];
+            if (use.is_read && state.writer.has_value()) {
+                add_edge(*state.writer, node_i, use, Hazard::READ_AFTER_WRITE, false);
+            }
+            if (!use.is_write) {
+                state.readers.push_back(node_i);
+                continue;
+            }
+            if (!state.readers.empty()) {
+                for (auto reader_i : state.readers) {
+                    add_edge(reader_i, node_i, use, Hazard::WRITE_AFTER_READ, false);
+                }
+            } else if (!use.is_read && state.writer.has_value() && *state.writer != node_i) {
+                add_edge(*state.writer, node_i, use, Hazard::WRITE_AFTER_WRITE, true);
+                ++unread_write_n;
+            }
+            state.writer = node_i;
+            state.readers.clear();
+        }
+    }
+
+    // Edges only ever point forward, so one pass in order of their destination settles the depths
+    for (auto const &edge : edges) {
+        nodes[edge.dst].depth = std::max(nodes[edge.dst].depth, nodes[edge.src].depth + 1);
+    }
+    auto depth_row_n = std::vector<daxa_u32>{};
+    for (auto &node : nodes) {
+        if (node.depth >= depth_row_n.size()) {
+            depth_row_n.resize(node.depth + 1, 0);
+        }
+        node.row = depth_row_n[node.depth]++;
+        for (auto const &info : transient_infos) {
+            if (info.first_task <= node.info.task_i && node.info.task_i <= info.last_task) {
+                node.transient_size += info.size;
+            }
+        }
+    }
+    needs_layout = true;
+}
+
+void TaskGraphView::add_ui() {
+    if (ImGui::TreeNode("Task Graph")) {
+        auto barrier_n = daxa_u32{0};
+        auto culled_n = size_t{0};
+        for (auto const &node : nodes) {
+            barrier_n += node.barrier_n;
+            culled_n += node.info.kind == "culled" ? 1 : 0;
+        }
+        ImGui::Text("tasks: %zu | culled: %zu | dependencies: %zu", nodes.size() - culled_n, culled_n, edges.size());
+        ImGui::Text("barriers (est.): %u | unread writes: %u", barrier_n, unread_write_n);
+        ImGui::Checkbox("Show Graph", &show_window);
+        if (unread_write_n != 0 && ImGui::TreeNode("Unread Writes")) {
+            for (auto const &edge : edges) {
+                if (edge.is_unread_write) {
+                    ImGui::BulletText("%s: written by %s, overwritten by %s", edge.resource.c_str(), nodes[edge.src].info.name.c_str(), nodes[edge.dst].info.name.c_str());
+                }
+            }
+            ImGui::TreePop();
+        }
+        ImGui::TreePop();
+    }
+    if (show_window) {
+        ImGui::SetNextWindowSize(ImVec2(1200.0f, 700.0f), ImGuiCond_FirstUseEver);
+        if (ImGui::Begin("Task Graph", &show_window)) {
+            if (ImGui::Button("Re-layout")) {
+                needs_layout = true;
+            }
+            ImGui::SameLine();
+            ImGui::TextDisabled("node colour: GPU time | red links: writes that are never read");
+            draw_graph();
+        }
+        ImGui::End();
+    }
+}
+
+void TaskGraphView::draw_graph() {
+    if (editor == nullptr) {
+        auto config = ed::Config{};
+        // Positions come from the automatic layout, so there's nothing worth saving
+        config.SettingsFile = nullptr;
+        editor = ed::CreateEditor(&config);
+    }
+
+    auto zone_times = std::vector<daxa_f64>(GpuProfiler::MAX_ZONE_N, -1.0);
+    auto max_time = 0.0;
+    if (gpu_profiler != nullptr) {
+        for (auto const &zone : gpu_profiler->zone_results) {
+            if (zone.zone_i < zone_times.size()) {
+                zone_times[zone.zone_i] = zone.duration;
+            }
+            max_time = std::max(max_time, zone.duration);
+        }
+    }
+    auto node_time = [&](Node const &node) -> daxa_f64 {
+        return node.info.profiler_zone < zone_times.size() ? zone_times[node.info.profiler_zone] : -1.0;
+    };
+
+    ed::SetCurrentEditor(editor);
+    ed::Begin("task_graph_editor");
+    for (size_t node_i = 0; node_i < nodes.size(); ++node_i) {
+        auto const &node = nodes[node_i];
+        auto const is_culled = node.info.kind == "culled";
+        auto const time = node_time(node);
+        auto const cost = max_time > 0.0 && time > 0.0 ? static_cast<float>(time / max_time) : 0.0f;
+        auto const color = is_culled ? ImColor(0.2f, 0.2f, 0.2f, 0.8f) : ImColor::HSV((1.0f - cost) * 0.33f, 0.6f, 0.2f + 0.3f * cost, 0.9f);
+        ed::PushStyleColor(ed::StyleColor_NodeBg, color);
+        ed::BeginNode(node_id(node_i));
+        ed::BeginPin(input_pin_id(node_i), ed::PinKind::Input);
+        ImGui::TextUnformatted(">");
+        ed::EndPin();
+        ImGui::SameLine();
+        ImGui::BeginGroup();
+        ImGui::TextUnformatted(node.info.name.c_str());
+        if (is_culled) {
+            ImGui::TextDisabled("culled");
+        } else {
+            ImGui::TextDisabled("%s", node.info.kind.c_str());
+            if (time >= 0.0) {
+                ImGui::Text("%.3f ms", time);
+            } else {
+                ImGui::TextDisabled("- ms");
+            }
+            ImGui::Text("barriers: %u", node.barrier_n);
+            ImGui::Text("transients: %.1f MB", static_cast<double>(node.transient_size) / 1000000.0);
+        }
+        ImGui::EndGroup();
+        ImGui::SameLine();
+        ed::BeginPin(output_pin_id(node_i), ed::PinKind::Output);
+        ImGui::TextUnformatted(">");
+        ed::EndPin();
+        ed::EndNode();
+        ed::PopStyleColor();
+        if (needs_layout) {
+            ed::SetNodePosition(node_id(node_i), ImVec2(static_cast<float>(node.depth) * 300.0f, static_cast<float>(node.row) * 130.0f));
+        }
+    }
+    for (size_t edge_i = 0; edge_i < edges.size(); ++edge_i) {
+        auto const &edge = edges[edge_i];
+        auto color = ImColor(0.8f, 0.8f, 0.8f, 0.6f);
+        if (edge.is_unread_write) {
+            color = ImColor(1.0f, 0.2f, 0.2f, 1.0f);
+        } else if (edge.hazard == Hazard::WRITE_AFTER_READ) {
+            color = ImColor(0.4f, 0.6f, 1.0f, 0.6f);
+        }
+        ed::Link(link_id(edge_i), output_pin_id(edge.src), input_pin_id(edge.dst), color, edge.is_unread_write ? 3.0f : 1.5f);
+    }
+    if (needs_layout) {
+        ed::NavigateToContent(0.0f);
+        needs_layout = false;
+    }
+
+    auto const hovered_node = ed::GetHoveredNode().Get();
+    auto const hovered_link = ed::GetHoveredLink().Get();
+    ed::Suspend();
+    if (hovered_link != 0) {
+        auto const &edge = edges[hovered_link - 1];
+        ImGui::SetTooltip("%s -> %s\n%s (%s)%s", nodes[edge.src].info.name.c_str(), nodes[edge.dst].info.name.c_str(), edge.resource.c_str(), hazard_name(edge.hazard), edge.is_unread_write ? "\nthe first write is never read" : "");
+    } else if (hovered_node != 0) {
+        auto const &node = nodes[(hovered_node - 1) / 3];
+        auto text = std::string{};
+        for (auto const &label : node.use_labels) {
+            text += text.empty() ? label : "\n" + label;
+        }
+        if (!text.empty()) {
+            ImGui::SetTooltip("%s", text.c_str());
+        }
+    }
+    ed::Resume();
+    ed::End();
+    ed::SetCurrentEditor(nullptr);
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cpu/core.hpp>
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace ax::NodeEditor {
+    struct EditorContext;
+} // namespace ax::NodeEditor
+
+// Node graph of the main task graph, as it was last recorded. Dependencies are derived from the
+// order in which tasks read and write each resource, the same way the task graph places its
+// barriers. A write that's overwritten before anything reads it is flagged, since its task (or at
+// least its barrier) is wasted.
+struct TaskGraphView : AppUi::DebugDisplayProvider {
+    enum struct Hazard {
+        READ_AFTER_WRITE,
+        WRITE_AFTER_READ,
+        WRITE_AFTER_WRITE,
+    };
+
+    struct Edge {
+        size_t src;
+        size_t dst;
+        std::string resource;
+        Hazard hazard;
+        // The source's write was never read before `dst` overwrote it
+        bool is_unread_write;
+    };
+
+    struct Node {
+        RecordContext::TaskNodeInfo info;
+        daxa_u32 depth = 0;
+        daxa_u32 row = 0;
+        size_t transient_size = 0;
+        daxa_u32 barrier_n = 0;
+        std::vector<std::string> use_labels;
+    };
+
+    GpuProfiler const *gpu_profiler = nullptr;
+    std::vector<Node> nodes;
+    std::vector<Edge> edges;
+    daxa_u32 unread_write_n = 0;
+
+    ax::NodeEditor::EditorContext *editor = nullptr;
+    bool show_window = false;
+    bool needs_layout = true;
+
+    TaskGraphView() = default;
+    TaskGraphView(TaskGraphView const &) = delete;
+    TaskGraphView(TaskGraphView &&) = delete;
+    auto operator=(TaskGraphView const &) -> TaskGraphView & = delete;
+    auto operator=(TaskGraphView &&) -> TaskGraphView & = delete;
+    ~TaskGraphView() override;
+
+    // Called after every re-record of the main task graph
+    void set_graph(std::vector<RecordContext::TaskNodeInfo> &&task_nodes, std::vector<RecordContext::TransientInfo> const &transient_infos);
+
+    void add_ui() override;
+
+  private:
+    void draw_graph();
+};
@@ -0,0 +1,193 @@
+#include "tunables.hpp"
+
+#include <fmt/format.h>
+#include <imgui.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+static auto parse_u32(std::string_view str, daxa_u32 &value) -> bool {
+    auto [end, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    return ec == std::errc{} && end == str.data() + str.size();
+}
+
+// Which shader files read each tunable, including through utils/sky.glsl (SKY_SKY_RES) and
+// utils/downscale.glsl (SHADING_SCL). Anything missing here silently uses the default from settings.inl.
+static constexpr auto shader_uses = std::array{
+    std::pair{"PREPASS_SCL", "trace_primary.comp.glsl"},
+    std::pair{"SHADING_SCL", "diffuse_gi.comp.glsl"},
+    std::pair{"SHADING_SCL", "downscale.comp.glsl"},
+    std::pair{"SHADING_SCL", "ssao.comp.glsl"},
+    std::pair{"SHADING_SCL", "trace_secondary.comp.glsl"},
+    std::pair{"SKY_TRANSMITTANCE_RES", "sky.comp.glsl"},
+    std::pair{"SKY_MULTISCATTERING_RES", "sky.comp.glsl"},
+    std::pair{"SKY_SKY_RES", "sky.comp.glsl"},
+    std::pair{"SKY_SKY_RES", "diffuse_gi.comp.glsl"},
+    std::pair{"SKY_SKY_RES", "postprocessing.comp.glsl"},
+    std::pair{"SKY_SKY_RES", "trace_primary.comp.glsl"},
+    std::pair{"SKY_SKY_RES", "trace_secondary.comp.glsl"},
+    std::pair{"SKY_CUBE_RES", "sky.comp.glsl"},
+    std::pair{"IBL_CUBE_RES", "convolve_cube.comp.glsl"},
+};
+
+auto Tunables::shader_defines(std::string_view path) const -> std::vector<daxa::ShaderDefine> {
+    auto result = std::vector<daxa::ShaderDefine>{};
+    for_each(*this, [&](char const *name, char const *, auto const &value, auto const &) {
+        auto const is_used = std::any_of(shader_uses.begin(), shader_uses.end(), [&](auto const &use) {
+            return std::string_view{use.first} == name && std::string_view{use.second} == path;
+        });
+        if (!is_used) {
+            return;
+        }
+        using T = std::remove_cvref_t<decltype(value)>;
+        if constexpr (std::is_same_v<T, bool>) {
+            result.push_back({name, value ? "1" : "0"});
+        } else if constexpr (std::is_same_v<T, daxa_u32vec2>) {
+            result.push_back({name, fmt::format("daxa_u32vec2({}, {})", value.x, value.y)});
+        } else {
+            result.push_back({name, std::to_string(value)});
+        }
+    });
+    return result;
+}
+
+auto Tunables::needs_record(Tunables const &recorded) const -> bool {
+    // Everything but the chunk update limit, which is read from GpuInput, is baked into the recorded graph
+    auto current = *this;
+    current.chunk_updates_per_frame = recorded.chunk_updates_per_frame;
+    return current.describe() != recorded.describe();
+}
+
+void Tunables::clamp() {
+    for_each(*this, [](char const *, char const *, auto &value, auto const &range) {
+        using T = std::remove_cvref_t<decltype(value)>;
+        if constexpr (std::is_same_v<T, daxa_u32vec2>) {
+            value.x = std::clamp(value.x, range.min, range.max);
+            value.y = std::clamp(value.y, range.min, range.max);
+        } else if constexpr (!std::is_same_v<T, bool>) {
+            value = std::clamp(value, range.min, range.max);
+        }
+    });
+}
+
+auto Tunables::set(std::string_view name, std::string_view value) -> bool {
+    auto found = false;
+    auto parsed = false;
+    for_each(*this, [&](char const *define_name, char const *, auto &tunable, auto const &) {
+        auto const define_name_view = std::string_view{define_name};
+        auto const matches = std::equal(name.begin(), name.end(), define_name_view.begin(), define_name_view.end(), [](char a, char b) {
+            return std::toupper(static_cast<unsigned char>(a)) == b;
+        });
+        if (!matches) {
+            return;
+        }
+        found = true;
+        using T = std::remove_cvref_t<decltype(tunable)>;
+        if constexpr (std::is_same_v<T, bool>) {
+            if (value == "1" || value == "on" || value == "true") {
+                tunable = true;
+                parsed = true;
+            } else if (value == "0" || value == "off" || value == "false") {
+                tunable = false;
+                parsed = true;
+            }
+        } else if constexpr (std::is_same_v<T, daxa_u32vec2>) {
+            auto const separator = value.find_first_of("x,");
+            auto result = T{};
+            if (separator == std::string_view::npos) {
+                // A single number sets both
+                parsed = parse_u32(value, result.x);
+                result.y = result.x;
+            } else {
+                parsed = parse_u32(value.substr(0, separator), result.x) && parse_u32(value.substr(separator + 1), result.y);
+            }
+            if (parsed) {
+                tunable = result;
+            }
+        } else {
+            auto result = T{};
+            parsed = parse_u32(value, result);
+            if (parsed) {
+                tunable = result;
+            }
+        }
+    });
+    clamp();
+    return found && parsed;
+}
+
+auto Tunables::describe() const -> std::vector<std::string> {
+    auto result = std::vector<std::string>{};
+    for_each(*this, [&](char const *name, char const *, auto const &value, auto const &) {
+        using T = std::remove_cvref_t<decltype(value)>;
+        if constexpr (std::is_same_v<T, bool>) {
+            result.push_back(fmt::format("{} = {}", name, value ? "on" : "off"));
+        } else if constexpr (std::is_same_v<T, daxa_u32vec2>) {
+            result.push_back(fmt::format("{} = {}x{}", name, value.x, value.y));
+        } else {
+            result.push_back(fmt::format("{} = {}", name, value));
+        }
+    });
+    return result;
+}
+
+void Tunables::save_json(nlohmann::json &json) const {
+    for_each(*this, [&](char const *name, char const *, auto const &value, auto const &) {
+        using T = std::remove_cvref_t<decltype(value)>;
+        if constexpr (std::is_same_v<T, daxa_u32vec2>) {
+            json[fmt::format("tunable_{}_x", name)] = value.x;
+            json[fmt::format("tunable_{}_y", name)] = value.y;
+        } else {
+            json[fmt::format("tunable_{}", name)] = value;
+        }
+    });
+}
+
+void Tunables::load_json(nlohmann::json const &json) {
+    auto grab_value = [&json](std::string const &str, auto &val) {
+        if (json.contains(str)) {
+            val = json[str];
+        }
+    };
+    for_each(*this, [&](char const *name, char const *, auto &value, auto const &) {
+        using T = std::remove_cvref_t<decltype(value)>;
+        if constexpr (std::is_same_v<T, daxa_u32vec2>) {
+            grab_value(fmt::format("tunable_{}_x", name), value.x);
+            grab_value(fmt::format("tunable_{}_y", name), value.y);
+        } else {
+            grab_value(fmt::format("tunable_{}", name), value);
+        }
+    });
+    // A hand-edited file could ask for something the shaders don't support
+    clamp();
+}
+
+auto Tunables::add_ui() -> bool {
+    auto changed = false;
+    for_each(*this, [&](char const *name, char const *label, auto &value, auto const &range) {
+        using T = std::remove_cvref_t<decltype(value)>;
+        if constexpr (std::is_same_v<T, bool>) {
+            changed |= ImGui::Checkbox(label, &value);
+        } else {
+            auto *data = reinterpret_cast<daxa_u32 *>(&value);
+            auto const component_n = std::is_same_v<T, daxa_u32vec2> ? 2 : 1;
+            ImGui::SliderScalarN(label, ImGuiDataType_U32, data, component_n, &range.min, &range.max);
+            // Re-recording compiles pipelines for the new value, so don't do it for every step of a drag
+            changed |= ImGui::IsItemDeactivatedAfterEdit();
+        }
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("%s", name);
+        }
+    });
+    if (ImGui::Button("Reset Tunables")) {
+        *this = {};
+        changed = true;
+    }
+    return changed;
+}
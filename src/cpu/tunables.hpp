@@ -0,0 +1,70 @@
+#pragma once
+
+#include <daxa/utils/pipeline_manager.hpp>
+#include <nlohmann/json_fwd.hpp>
+#include <shared/settings.inl>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Performance knobs that used to be hard-coded in `settings.inl`, which now only holds their defaults.
+// A pipeline recorded through `RecordContext::add` gets the tunables its shaders read as defines of the
+// same name, so a change takes effect when the main task graph is next re-recorded (compiling pipelines
+// for the new values as needed), rather than needing a rebuild. CHUNK_UPDATES_PER_FRAME is read from
+// GpuInput instead, so changing it needs neither.
+struct Tunables {
+    template <typename T>
+    struct Range {
+        T min;
+        T max;
+    };
+
+    daxa_u32 prepass_scl = PREPASS_SCL;
+    daxa_u32 shading_scl = SHADING_SCL;
+    bool enable_taa = ENABLE_TAA;
+    daxa_u32vec2 sky_transmittance_res = SKY_TRANSMITTANCE_RES;
+    daxa_u32vec2 sky_multiscattering_res = SKY_MULTISCATTERING_RES;
+    daxa_u32vec2 sky_sky_res = SKY_SKY_RES;
+    daxa_u32 sky_cube_res = SKY_CUBE_RES;
+    daxa_u32 ibl_cube_res = IBL_CUBE_RES;
+    daxa_u32 chunk_updates_per_frame = MAX_CHUNK_UPDATES_PER_FRAME;
+
+    // Calls `f(define_name, label, value, range)` for every tunable
+    template <typename SelfT, typename F>
+    static void for_each(SelfT &self, F &&f) {
+        f("PREPASS_SCL", "Depth Prepass Downscale", self.prepass_scl, Range<daxa_u32>{1, 4});
+        // utils/downscale.glsl only has filters for 1 and 2
+        f("SHADING_SCL", "Shading Downscale", self.shading_scl, Range<daxa_u32>{1, 2});
+        f("ENABLE_TAA", "TAA instead of FSR2", self.enable_taa, Range<bool>{false, true});
+        f("SKY_TRANSMITTANCE_RES", "Sky Transmittance LUT Size", self.sky_transmittance_res, Range<daxa_u32>{16, 1024});
+        f("SKY_MULTISCATTERING_RES", "Sky Multiscattering LUT Size", self.sky_multiscattering_res, Range<daxa_u32>{8, 256});
+        f("SKY_SKY_RES", "Sky LUT Size", self.sky_sky_res, Range<daxa_u32>{32, 1024});
+#if IMMEDIATE_SKY
+        // Otherwise, the cubes are persistent images created at their default size
+        f("SKY_CUBE_RES", "Sky Cube Size", self.sky_cube_res, Range<daxa_u32>{64, 4096});
+        f("IBL_CUBE_RES", "IBL Cube Size", self.ibl_cube_res, Range<daxa_u32>{4, 128});
+#endif
+        // The chunk update list in the voxel globals is always sized for the maximum
+        f("CHUNK_UPDATES_PER_FRAME", "Chunk Updates per Frame", self.chunk_updates_per_frame, Range<daxa_u32>{1, MAX_CHUNK_UPDATES_PER_FRAME});
+    }
+
+    // The defines for the tunables read by the shader file `path` (as passed to daxa::ShaderFile)
+    auto shader_defines(std::string_view path) const -> std::vector<daxa::ShaderDefine>;
+    // Whether the main task graph recorded with `recorded` is out of date
+    auto needs_record(Tunables const &recorded) const -> bool;
+    void clamp();
+
+    // Sets the tunable with the define name `name` (in any case) from a string such as "1", "on" or
+    // "256x128", clamping it to its range. Returns false if there's no such tunable or the value is malformed.
+    auto set(std::string_view name, std::string_view value) -> bool;
+    // The current value of every tunable, formatted as "DEFINE_NAME = value"
+    auto describe() const -> std::vector<std::string>;
+
+    void save_json(nlohmann::json &json) const;
+    // Only overwrites the values present in `json`
+    void load_json(nlohmann::json const &json);
+
+    // Returns whether a value was changed
+    auto add_ui() -> bool;
+};
@@ -2,9 +2,12 @@
 
 #include <thread>
 #include <numbers>
+#include <cmath>
 #include <fstream>
 #include <random>
 #include <unordered_map>
+#include <charconv>
+#include <string_view>
 
 #include <gvox/adapters/input/byte_buffer.h>
 #include <gvox/adapters/output/byte_buffer.h>
@@ -12,6 +15,9 @@
 
 #define APPNAME "Voxel App"
 
+// The offscreen target headless mode renders into in place of the swapchain image
+constexpr auto HEADLESS_OUTPUT_FORMAT = daxa::Format::R8G8B8A8_SRGB;
+
 using namespace std::chrono_literals;
 
 #include <iostream>
@@ -25,6 +31,67 @@ constexpr auto round_frame_dim(daxa_u32vec2 size) {
     return result;
 }
 
+auto LaunchOptions::parse(std::span<char const *const> args) -> LaunchOptions {
+    auto result = LaunchOptions{};
+    for (size_t i = 0; i < args.size(); ++i) {
+        auto const arg = std::string_view{args[i]};
+        auto next_arg = [&]() -> std::string_view {
+            if (i + 1 >= args.size()) {
+                std::cerr << "Missing value for " << arg << std::endl;
+                return {};
+            }
+            return args[++i];
+        };
+        auto next_u32 = [&]() -> daxa_u32 {
+            auto const str = next_arg();
+            auto value = daxa_u32{};
+            std::from_chars(str.data(), str.data() + str.size(), value);
+            return value;
+        };
+        if (arg == "--headless") {
+            result.headless = true;
+        } else if (arg == "--frames") {
+            result.frame_n = next_u32();
+        } else if (arg == "--seconds") {
+            result.max_seconds = std::strtof(std::string{next_arg()}.c_str(), nullptr);
+        } else if (arg == "--output") {
+            result.output_dir = next_arg();
+        } else if (arg == "--output-every") {
+            result.output_interval = next_u32();
+        } else if (arg == "--benchmark") {
+            result.benchmark_path = next_arg();
+        } else if (arg == "--report") {
+            result.report_path = next_arg();
+        } else if (arg == "--record") {
+            result.record_path = next_arg();
+        } else if (arg == "--replay") {
+            result.replay_path = next_arg();
+        } else if (arg == "--metrics") {
+            result.metrics_path = next_arg();
+        } else if (arg == "--metrics-interval") {
+            result.metrics_interval = std::max(std::strtof(std::string{next_arg()}.c_str(), nullptr), 0.01f);
+        } else if (arg == "--log") {
+            result.log_path = next_arg();
+        } else if (arg == "--exec") {
+            result.exec_path = next_arg();
+        } else if (arg == "--size") {
+            auto const str = next_arg();
+            auto const x_pos = str.find('x');
+            if (x_pos != std::string_view::npos) {
+                std::from_chars(str.data(), str.data() + x_pos, result.size.x);
+                std::from_chars(str.data() + x_pos + 1, str.data() + str.size(), result.size.y);
+            }
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+        }
+    }
+    result.size = {std::max(result.size.x, 1u), std::max(result.size.y, 1u)};
+    if (result.headless && result.benchmark_path.empty() && result.replay_path.empty() && result.frame_n == 0 && result.max_seconds <= 0.0f) {
+        result.frame_n = 600;
+    }
+    return result;
+}
+
 // Code flow
 // VoxelApp::VoxelApp()
 // GpuResources::create()
@@ -33,24 +100,27 @@ constexpr auto round_frame_dim(daxa_u32vec2 size) {
 // VoxelApp::on_update()
 
 // [App initialization]
-// Creates daxa instance, device, swapchain, pipeline manager
+// Creates daxa instance, device, swapchain (none when headless), pipeline manager
 // Creates ui and imgui_renderer
 // Creates task states
 // Creates GPU Resources: GpuResources::create()
 // Creates main task graph: VoxelApp::record_main_task_graph()
 // Creates GVOX Context (gvox_ctx)
 // Creates temp task graph
-VoxelApp::VoxelApp()
-    : AppWindow(APPNAME, {1280, 720}),
-      daxa_instance{daxa::create_instance({})},
-      device{daxa_instance.create_device({
-          .flags = daxa::DeviceFlags2{
-              // .buffer_device_address_capture_replay_bit = false,
-              // .conservative_rasterization = true,
-          },
-          .name = "device",
+VoxelApp::VoxelApp(LaunchOptions const &a_launch_options)
+    : AppWindow(APPNAME, a_launch_options.size, a_launch_options.headless),
+      launch_options{a_launch_options},
+      daxa_instance{startup_timer.time("Vulkan instance", []() { return daxa::create_instance({}); })},
+      device{startup_timer.time("device", [this]() {
+          return daxa_instance.create_device({
+              .flags = daxa::DeviceFlags2{
+                  // .buffer_device_address_capture_replay_bit = false,
+                  // .conservative_rasterization = true,
+              },
+              .name = "device",
+          });
       })},
-      swapchain{device.create_swapchain({
+      swapchain{launch_options.headless ? daxa::Swapchain{} : startup_timer.time("swapchain", [this]() { return device.create_swapchain({
           .native_window = AppWindow::get_native_handle(),
           .native_window_platform = AppWindow::get_native_platform(),
           .surface_format_selector = [](daxa::Format format) -> daxa_i32 {
@@ -64,8 +134,9 @@ VoxelApp::VoxelApp()
           .image_usage = daxa::ImageUsageFlagBits::TRANSFER_DST,
           .max_allowed_frames_in_flight = FRAMES_IN_FLIGHT,
           .name = "swapchain",
-      })},
+      }); })},
       main_pipeline_manager{[this]() {
+          auto const phase = StartupTimer::Scope{"pipeline manager"};
           auto result = AsyncPipelineManager({
               .device = device,
               .shader_compile_options = {
@@ -100,12 +171,17 @@ VoxelApp::VoxelApp()
           return result;
       }()},
       ui{[this]() {
+          auto const phase = StartupTimer::Scope{"AppUi"};
           auto result = AppUi(AppWindow::glfw_window_ptr);
           auto const &device_props = device.properties();
           result.debug_gpu_name = reinterpret_cast<char const *>(device_props.device_name);
           return result;
       }()},
       imgui_renderer{[this]() {
+          if (launch_options.headless) {
+              return daxa::ImGuiRenderer{};
+          }
+          auto const phase = StartupTimer::Scope{"ImGuiRenderer"};
           return daxa::ImGuiRenderer({
               .device = device,
               .format = swapchain.get_format(),
@@ -113,10 +189,76 @@ VoxelApp::VoxelApp()
               .use_custom_config = false,
           });
       }()},
-      gpu_app{device, swapchain.get_format()}, gvox_ctx(gvox_create_context()), main_task_graph{[this]() {
+      gpu_app{startup_timer.time("GpuApp", [this]() { return GpuApp{device, launch_options.headless ? HEADLESS_OUTPUT_FORMAT : swapchain.get_format()}; })}, gvox_ctx(gvox_create_context()), main_task_graph{[this]() {
+          auto const phase = StartupTimer::Scope{"record main task graph"};
           return record_main_task_graph();
       }()} {
 
+    ui.debug_display.providers.push_back(&frame_pacer);
+    ui.debug_display.providers.push_back(&input_latency_probe);
+    ui.debug_display.providers.push_back(&cpu_profiler);
+    ui.debug_display.providers.push_back(&frame_stats);
+    ui.debug_display.providers.push_back(&main_pipeline_manager.compile_stats());
+    task_graph_view.gpu_profiler = &gpu_app.gpu_profiler;
+    ui.debug_display.providers.push_back(&task_graph_view);
+
+    app_metrics = {
+        .frame_time = &metrics_sink.summary("frame_time_ms"),
+        .cpu_time = &metrics_sink.summary("cpu_time_ms"),
+        .gpu_time = &metrics_sink.summary("gpu_time_ms"),
+        .frame_n = &metrics_sink.counter("frames"),
+        .stutter_n = &metrics_sink.gauge("stutters"),
+        .chunk_update_n = &metrics_sink.counter("chunk_updates"),
+        .vram_usage = &metrics_sink.gauge("vram_bytes"),
+        .transient_heap_size = &metrics_sink.gauge("transient_heap_bytes"),
+        .render_target_pool_size = &metrics_sink.gauge("render_target_pool_bytes"),
+        .voxel_page_count = &metrics_sink.gauge("voxel_page_count"),
+        .voxel_heap_usage = &metrics_sink.gauge("voxel_heap_bytes"),
+    };
+    if (!launch_options.log_path.empty()) {
+        ui.console.logger->open_file(launch_options.log_path);
+    }
+    if (!launch_options.metrics_path.empty()) {
+        metrics_sink.start({.path = launch_options.metrics_path, .interval = launch_options.metrics_interval});
+    }
+    input_recording_ui.recorder = &input_recorder;
+    input_recording_ui.replay = &input_replay;
+    ui.debug_display.providers.push_back(&input_recording_ui);
+    if (!launch_options.headless && ui.settings.present_mode != 0) {
+        update_present_mode();
+    }
+
+    if (launch_options.headless) {
+        headless_output_image = device.create_image({
+            .format = HEADLESS_OUTPUT_FORMAT,
+            .size = {window_size.x, window_size.y, 1},
+            .usage = daxa::ImageUsageFlagBits::COLOR_ATTACHMENT | daxa::ImageUsageFlagBits::TRANSFER_SRC | daxa::ImageUsageFlagBits::TRANSFER_DST,
+            .name = "headless_output_image",
+        });
+        headless_readback_buffer = device.create_buffer({
+            .size = window_size.x * window_size.y * 4,
+            .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = "headless_readback_buffer",
+        });
+    }
+
+    if (!launch_options.benchmark_path.empty()) {
+        if (!start_benchmark(launch_options.benchmark_path)) {
+            should_quit = true;
+        }
+    }
+
+    if (!launch_options.replay_path.empty()) {
+        input_replay = InputReplay::load(launch_options.replay_path);
+        if (input_replay) {
+            input_replay->begin(ui, gpu_app.phys_time_accumulator);
+        } else {
+            should_quit = true;
+        }
+    } else if (!launch_options.record_path.empty()) {
+        input_recorder.begin(launch_options.record_path, ui, gpu_app.phys_time_accumulator);
+    }
+
     constexpr auto IMMEDIATE_LOAD_MODEL_FROM_GABES_DRIVE = false;
     if constexpr (IMMEDIATE_LOAD_MODEL_FROM_GABES_DRIVE) {
         // ui.gvox_model_path = "C:/Users/gabe/AppData/Roaming/GabeVoxelGame/models/building.vox";
@@ -151,13 +293,27 @@ VoxelApp::VoxelApp()
         halton_offsets[i] = daxa_f32vec2{radical_inverse(i, 2) - 0.5f, radical_inverse(i, 3) - 0.5f};
     }
 
-    main_pipeline_manager.wait();
-    ui.console.add_log(std::format("startup: {} s\n", std::chrono::duration<float>(Clock::now() - start).count()));
+    register_console_commands();
+
+    {
+        auto const phase = StartupTimer::Scope{"pipeline compile wait"};
+        main_pipeline_manager.wait();
+    }
+
+    if (!launch_options.exec_path.empty()) {
+        ui.console.exec_script(launch_options.exec_path);
+    }
 }
 VoxelApp::~VoxelApp() {
+    input_recorder.end();
+    metrics_sink.stop();
     gvox_destroy_context(gvox_ctx);
     device.wait_idle();
     device.collect_garbage();
+    if (launch_options.headless) {
+        device.destroy_image(headless_output_image);
+        device.destroy_buffer(headless_readback_buffer);
+    }
     gpu_app.destroy(device);
 }
 
@@ -165,8 +321,26 @@ VoxelApp::~VoxelApp() {
 // handle resize event
 // VoxelApp::on_update()
 void VoxelApp::run() {
+    if (launch_options.headless) {
+        run_headless();
+        return;
+    }
     while (true) {
-        glfwPollEvents();
+        auto const low_latency_input = ui.settings.low_latency_input && !AppWindow::minimized;
+        if (low_latency_input) {
+            // Wait out the frame budget before sampling input, so the frame is recorded with the freshest input
+            CPU_PROFILE_ZONE("FramePacer::wait");
+            frame_pacer.wait(target_fps());
+        }
+        {
+            CPU_PROFILE_ZONE("glfwPollEvents");
+            for (auto const &event : deferred_input_events) {
+                event();
+            }
+            deferred_input_events.clear();
+            glfwPollEvents();
+        }
+        input_latency_probe.sample(false);
         if (glfwWindowShouldClose(AppWindow::glfw_window_ptr) != 0) {
             break;
         }
@@ -176,18 +350,298 @@ void VoxelApp::run() {
             if (resized) {
                 on_resize(window_size.x, window_size.y);
             }
+            if (ui.should_update_present_mode) {
+                update_present_mode();
+            }
 
-            if (ui.settings.battery_saving_mode) {
-                std::this_thread::sleep_for(10ms);
+            if (!low_latency_input) {
+                CPU_PROFILE_ZONE("FramePacer::wait");
+                frame_pacer.wait(target_fps());
             }
 
             on_update();
+            if (has_deferred_resize) {
+                has_deferred_resize = false;
+                on_resize(deferred_resize_size.x, deferred_resize_size.y);
+            }
+            if (should_quit) {
+                break;
+            }
         } else {
             std::this_thread::sleep_for(1ms);
         }
     }
 }
 
+// [Headless loop]
+// Same frames as the windowed loop, without input, UI or presenting. Runs until the frame or time limit.
+void VoxelApp::run_headless() {
+    if (!launch_options.output_dir.empty()) {
+        std::filesystem::create_directories(launch_options.output_dir);
+    }
+    auto const run_start = Clock::now();
+    daxa_u32 frame_i = 0;
+    while (true) {
+        auto const elapsed = std::chrono::duration<daxa_f32>(Clock::now() - run_start).count();
+        auto const is_last_frame =
+            (launch_options.frame_n != 0 && frame_i + 1 >= launch_options.frame_n) ||
+            (launch_options.max_seconds > 0.0f && elapsed >= launch_options.max_seconds);
+        auto const is_output_frame = is_last_frame || (launch_options.output_interval != 0 && frame_i % launch_options.output_interval == 0);
+        headless_should_capture = !launch_options.output_dir.empty() && is_output_frame;
+        if (render_res_scl != ui.render_res_scl) {
+            // There's no swapchain to resize, so only the render targets need to change
+            render_res_scl = ui.render_res_scl;
+            ui.should_record_task_graph = true;
+        }
+        on_update();
+        if (headless_should_capture) {
+            CPU_PROFILE_ZONE("write_headless_frame");
+            write_headless_frame(frame_i);
+        }
+        ++frame_i;
+        if (is_last_frame || should_quit) {
+            break;
+        }
+    }
+    auto const seconds = std::chrono::duration<daxa_f32>(Clock::now() - run_start).count();
+    ui.console.add_log(fmt::format("headless: {} frames in {:.2f} s ({:.2f} fps)", frame_i, seconds, static_cast<daxa_f32>(frame_i) / seconds));
+}
+
+auto VoxelApp::start_benchmark(std::filesystem::path const &path) -> bool {
+    auto scenario = BenchmarkScenario::load(path);
+    if (!scenario) {
+        return false;
+    }
+    benchmark = Benchmark{.scenario = std::move(*scenario), .scenario_path = path, .output_latency_frame_n = static_cast<daxa_u32>(FRAMES_IN_FLIGHT + 1)};
+    ui.begin_temporary_settings();
+    benchmark->apply_settings(ui.settings);
+    ui.should_record_task_graph = true;
+    // Measure the scenario's world, not whatever was loaded before
+    ui.should_upload_seed_data = true;
+    ui.should_run_startup = true;
+    if (!benchmark->scenario.model_path.empty()) {
+        ui.gvox_model_path = benchmark->scenario.model_path;
+        ui.should_upload_gvox_model = true;
+    }
+    return true;
+}
+
+void VoxelApp::finish_benchmark() {
+    auto const environment = nlohmann::json{
+        {"gpu", ui.debug_gpu_name},
+        {"headless", launch_options.headless},
+        {"output_resolution", {window_size.x, window_size.y}},
+        {"render_resolution", {gpu_input.frame_dim.x, gpu_input.frame_dim.y}},
+    };
+    if (benchmark->write_report(launch_options.report_path, environment)) {
+        ui.console.add_log(fmt::format("benchmark: wrote report to {}", launch_options.report_path.string()));
+    } else {
+        ui.console.add_log(fmt::format("benchmark: failed to write report to {}", launch_options.report_path.string()));
+    }
+    ui.end_temporary_settings();
+    // Only a benchmark from the command line ends the run. One started from the console just stops.
+    if (launch_options.benchmark_path.empty()) {
+        benchmark.reset();
+    } else {
+        should_quit = true;
+    }
+}
+
+void VoxelApp::register_console_commands() {
+    using Type = AppUi::Console::CommandArg::Type;
+    using Console = AppUi::Console;
+    using CommandArgs = AppUi::Console::CommandArgs;
+    ui.console.add_command({
+        .name = "pass",
+        .help = "Lists the debug passes, or shows one in place of the final image",
+        .args = {{.name = "name", .type = Type::STRING, .is_optional = true, .completions = [this]() {
+                      auto result = std::vector<std::string>{};
+                      for (auto const &pass : ui.debug_display.passes) {
+                          result.push_back(pass.name);
+                      }
+                      return result;
+                  }}},
+        .callback = [this](Console &console, CommandArgs const &args) {
+            auto &debug_display = ui.debug_display;
+            if (!args.has(0)) {
+                for (auto const &pass : debug_display.passes) {
+                    console.add_log(fmt::format("{}{}{}", pass.name == debug_display.selected_pass_name ? "* " : "  ", pass.name, pass.is_culled ? " (culled)" : ""));
+                }
+                return;
+            }
+            auto const &name = args.get<std::string>(0);
+            auto iter = std::find_if(debug_display.passes.begin(), debug_display.passes.end(), [&](AppUi::Pass const &pass) { return pass.name == name; });
+            if (iter == debug_display.passes.end()) {
+                Logger::log(LogLevel::ERR, "console", fmt::format("[error] No debug pass named '{}'", name));
+                return;
+            }
+            debug_display.selected_pass = static_cast<uint32_t>(iter - debug_display.passes.begin());
+            debug_display.selected_pass_name = name;
+            ui.should_record_task_graph = true;
+        },
+    });
+    ui.console.add_command({
+        .name = "tunable",
+        .help = "Lists the tunables, or sets one (such as 'tunable SHADING_SCL 2' or 'tunable SKY_SKY_RES 192x108')",
+        .args = {
+            {.name = "name", .type = Type::STRING, .is_optional = true, .completions = []() {
+                 auto result = std::vector<std::string>{};
+                 auto tunables = Tunables{};
+                 Tunables::for_each(tunables, [&](char const *name, char const *, auto &, auto const &) { result.push_back(name); });
+                 return result;
+             }},
+            {.name = "value", .type = Type::STRING, .is_optional = true},
+        },
+        .callback = [this](Console &console, CommandArgs const &args) {
+            if (!args.has(1)) {
+                for (auto const &line : ui.settings.tunables.describe()) {
+                    if (!args.has(0) || line.starts_with(args.get<std::string>(0))) {
+                        console.add_log(line);
+                    }
+                }
+                return;
+            }
+            if (!ui.settings.tunables.set(args.get<std::string>(0), args.get<std::string>(1))) {
+                Logger::log(LogLevel::ERR, "console", fmt::format("[error] Can't set tunable '{}' to '{}'", args.get<std::string>(0), args.get<std::string>(1)));
+                return;
+            }
+            ui.needs_saving = true;
+        },
+    });
+    ui.console.add_command({
+        .name = "render_scale",
+        .help = "Sets the render resolution scale, snapped to the nearest option in the settings",
+        .args = {{.name = "scale", .type = Type::FLOAT}},
+        .callback = [this](Console &console, CommandArgs const &args) {
+            auto const scale = args.get<daxa_f32>(0);
+            auto const &values = AppUi::resolution_scale_values;
+            auto nearest = std::min_element(values.begin(), values.end(), [scale](daxa_f32 a, daxa_f32 b) { return std::abs(a - scale) < std::abs(b - scale); });
+            ui.settings.render_res_scl_id = static_cast<RenderResScl>(nearest - values.begin());
+            ui.needs_saving = true;
+            console.add_log(fmt::format("Render scale set to {}", AppUi::resolution_scale_options[static_cast<size_t>(ui.settings.render_res_scl_id)]));
+        },
+    });
+    ui.console.add_command({
+        .name = "regen",
+        .help = "Regenerates the world, optionally with a new seed",
+        .args = {{.name = "seed", .type = Type::STRING, .is_optional = true}},
+        .callback = [this](Console &, CommandArgs const &args) {
+            if (args.has(0)) {
+                ui.settings.world_seed_str = args.get<std::string>(0);
+                ui.needs_saving = true;
+            }
+            ui.should_upload_seed_data = true;
+            ui.should_run_startup = true;
+        },
+    });
+    ui.console.add_command({
+        .name = "profile_dump",
+        .help = "Writes the CPU and GPU traces and the shader compile stats as JSON",
+        .args = {{.name = "dir", .type = Type::STRING, .is_optional = true}},
+        .callback = [this](Console &console, CommandArgs const &args) {
+            auto const dir = std::filesystem::path{args.has(0) ? args.get<std::string>(0) : "."};
+            auto ec = std::error_code{};
+            std::filesystem::create_directories(dir, ec);
+            if (cpu_profiler.write_chrome_trace(dir / "cpu_trace.json") &&
+                gpu_app.gpu_profiler.write_chrome_trace(dir / "gpu_trace.json") &&
+                main_pipeline_manager.compile_stats().write_json(dir / "shader_compile_stats.json")) {
+                console.add_log(fmt::format("Wrote profiles to {}", std::filesystem::absolute(dir).string()));
+            } else {
+                Logger::log(LogLevel::ERR, "console", fmt::format("[error] Failed to write profiles to {}", dir.string()));
+            }
+        },
+    });
+    ui.console.add_command({
+        .name = "compact",
+        .help = "Frees the unused render targets and staging buffers held by the pools",
+        .callback = [this](Console &console, CommandArgs const &) {
+            auto const trimmed_size = gpu_app.render_target_pool.trim(device) + gpu_app.staging_pool.trim(device);
+            gpu_app.needs_vram_calc = true;
+            console.add_log(fmt::format("Freed {:.2f} MB", static_cast<daxa_f64>(trimmed_size) / static_cast<daxa_f64>(1 << 20)));
+        },
+    });
+    ui.console.add_command({
+        .name = "benchmark",
+        .help = "Runs a benchmark scenario, writing the report where --report says",
+        .args = {{.name = "scenario", .type = Type::STRING}},
+        .callback = [this](Console &, CommandArgs const &args) {
+            if (!start_benchmark(args.get<std::string>(0))) {
+                Logger::log(LogLevel::ERR, "console", fmt::format("[error] Can't run benchmark scenario '{}'", args.get<std::string>(0)));
+            }
+        },
+    });
+    ui.console.add_command({
+        .name = "quit",
+        .help = "Exits the app",
+        .callback = [this](Console &, CommandArgs const &) { should_quit = true; },
+    });
+}
+
+// Acts on the Input Recording UI, and applies the replay (if any) to this frame's GpuInput
+void VoxelApp::update_input_recording() {
+    if (input_recording_ui.should_toggle_recording) {
+        input_recording_ui.should_toggle_recording = false;
+        if (input_recorder.is_recording()) {
+            input_recorder.end();
+        } else if (!input_replay) {
+            input_recorder.begin(input_recording_ui.path, ui, gpu_app.phys_time_accumulator);
+        }
+    }
+    if (input_recording_ui.should_start_replay) {
+        input_recording_ui.should_start_replay = false;
+        if (!input_recorder.is_recording()) {
+            auto const was_replaying = input_replay.has_value();
+            input_replay = InputReplay::load(input_recording_ui.path);
+            if (input_replay) {
+                input_replay->begin(ui, gpu_app.phys_time_accumulator);
+            } else if (was_replaying) {
+                ui.end_temporary_settings();
+            }
+        }
+    }
+    if (input_recording_ui.should_stop_replay) {
+        input_recording_ui.should_stop_replay = false;
+        if (input_replay) {
+            input_replay.reset();
+            ui.end_temporary_settings();
+        }
+    }
+
+    if (!input_replay) {
+        return;
+    }
+    input_replay->begin_frame(gpu_input, ui);
+    if (input_replay->is_done) {
+        input_replay.reset();
+        ui.end_temporary_settings();
+        if (!launch_options.replay_path.empty()) {
+            should_quit = true;
+        }
+    }
+}
+
+void VoxelApp::write_headless_frame(daxa_u32 frame_i) {
+    device.wait_idle();
+    auto const *pixels = device.get_host_address_as<daxa_u8>(headless_readback_buffer).value();
+    auto *fi_bitmap = FreeImage_Allocate(static_cast<int>(window_size.x), static_cast<int>(window_size.y), 32);
+    for (daxa_u32 yi = 0; yi < window_size.y; ++yi) {
+        // FreeImage rows are bottom-up and BGRA
+        auto *dst = FreeImage_GetScanLine(fi_bitmap, static_cast<int>(window_size.y - 1 - yi));
+        auto const *src = pixels + size_t{yi} * window_size.x * 4;
+        for (daxa_u32 xi = 0; xi < window_size.x; ++xi) {
+            dst[xi * 4 + FI_RGBA_RED] = src[xi * 4 + 0];
+            dst[xi * 4 + FI_RGBA_GREEN] = src[xi * 4 + 1];
+            dst[xi * 4 + FI_RGBA_BLUE] = src[xi * 4 + 2];
+            dst[xi * 4 + FI_RGBA_ALPHA] = src[xi * 4 + 3];
+        }
+    }
+    auto const path = launch_options.output_dir / fmt::format("frame_{:05}.png", frame_i);
+    if (FreeImage_Save(FIF_PNG, fi_bitmap, path.string().c_str(), 0) == 0) {
+        ui.console.add_log(fmt::format("Failed to write {}", path.string()));
+    }
+    FreeImage_Unload(fi_bitmap);
+}
+
 auto VoxelApp::load_gvox_data_from_parser(GvoxAdapterContext *i_ctx, GvoxAdapterContext *p_ctx, GvoxRegionRange const *region_range) -> GvoxModelData {
     auto result = GvoxModelData{};
     GvoxByteBufferOutputAdapterConfig o_config = {
@@ -217,7 +671,7 @@ auto VoxelApp::load_gvox_data_from_parser(GvoxAdapterContext *i_ctx, GvoxAdapter
             char *str = new char[size + 1];
             gvox_get_result_message(gvox_ctx, str, nullptr);
             str[size] = '\0';
-            AppUi::Console::s_instance->add_log(fmt::format("ERROR loading model: {}", str));
+            Logger::log(LogLevel::ERR, "gvox", fmt::format("ERROR loading model: {}", str));
             gvox_pop_result(gvox_ctx);
             delete[] str;
             res = gvox_get_result(gvox_ctx);
@@ -232,6 +686,7 @@ auto VoxelApp::load_gvox_data_from_parser(GvoxAdapterContext *i_ctx, GvoxAdapter
 }
 
 auto VoxelApp::load_gvox_data() -> GvoxModelData {
+    CPU_PROFILE_ZONE("load_gvox_data");
     auto result = GvoxModelData{};
     auto file = std::ifstream(ui.gvox_model_path, std::ios::binary);
     if (!file.is_open()) {
@@ -297,8 +752,9 @@ auto VoxelApp::load_gvox_data() -> GvoxModelData {
 }
 
 auto VoxelApp::open_mesh_model() -> GvoxModelData {
+    CPU_PROFILE_ZONE("open_mesh_model");
     MeshModel mesh_model;
-    ::open_mesh_model(this->device, mesh_model, ui.gvox_model_path, "test");
+    ::open_mesh_model(this->device, gpu_app.staging_pool, mesh_model, ui.gvox_model_path, "test");
     if (mesh_model.meshes.size() == 0) {
         AppUi::Console::s_instance->add_log("[error] Failed to load the mesh model");
         ui.should_upload_gvox_model = false;
@@ -387,16 +843,11 @@ auto VoxelApp::open_mesh_model() -> GvoxModelData {
         },
         .task = [&](daxa::TaskInterface const &ti) {
             {
-                auto staging_gpu_input_buffer = device.create_buffer({
-                    .size = sizeof(MeshGpuInput),
-                    .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
-                    .name = "staging_gpu_input_buffer",
-                });
-                ti.recorder.destroy_buffer_deferred(staging_gpu_input_buffer);
-                auto *buffer_ptr = device.get_host_address_as<MeshGpuInput>(staging_gpu_input_buffer).value();
-                *buffer_ptr = mesh_gpu_input;
+                auto staging = gpu_app.staging_pool.acquire(device, sizeof(MeshGpuInput));
+                gpu_app.staging_pool.release(staging);
+                *reinterpret_cast<MeshGpuInput *>(staging.ptr) = mesh_gpu_input;
                 ti.recorder.copy_buffer_to_buffer({
-                    .src_buffer = staging_gpu_input_buffer,
+                    .src_buffer = staging.buffer,
                     .dst_buffer = mesh_gpu_input_buffer,
                     .size = sizeof(MeshGpuInput),
                 });
@@ -406,18 +857,14 @@ auto VoxelApp::open_mesh_model() -> GvoxModelData {
                 for (auto const &mesh : mesh_model.meshes) {
                     vert_n += mesh.verts.size();
                 }
-                auto staging_vertex_buffer = device.create_buffer({
-                    .size = static_cast<u32>(sizeof(MeshVertex) * vert_n),
-                    .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
-                    .name = "staging_vertex_buffer",
-                });
-                ti.recorder.destroy_buffer_deferred(staging_vertex_buffer);
-                auto *buffer_ptr = device.get_host_address_as<MeshVertex>(staging_vertex_buffer).value();
+                auto staging = gpu_app.staging_pool.acquire(device, sizeof(MeshVertex) * vert_n);
+                gpu_app.staging_pool.release(staging);
+                auto *buffer_ptr = reinterpret_cast<MeshVertex *>(staging.ptr);
                 usize vert_offset = 0;
                 for (auto const &mesh : mesh_model.meshes) {
                     std::memcpy(buffer_ptr + vert_offset, mesh.verts.data(), sizeof(MeshVertex) * mesh.verts.size());
                     ti.recorder.copy_buffer_to_buffer({
-                        .src_buffer = staging_vertex_buffer,
+                        .src_buffer = staging.buffer,
                         .dst_buffer = mesh.vertex_buffer,
                         .src_offset = sizeof(MeshVertex) * vert_offset,
                         .size = sizeof(MeshVertex) * mesh.verts.size(),
@@ -619,27 +1066,54 @@ auto VoxelApp::open_mesh_model() -> GvoxModelData {
 // Execute main task graph
 void VoxelApp::on_update() {
     auto now = Clock::now();
+    // The first frame runs the startup tasks, so it's the last phase of startup
+    auto first_frame_phase = std::optional<StartupTimer::Scope>{};
+    if (!startup_timer.is_finished) {
+        first_frame_phase.emplace("first frame (run_startup)");
+    }
 
-    swapchain_image = swapchain.acquire_next_image();
+    {
+        CPU_PROFILE_ZONE("acquire_next_image");
+        swapchain_image = launch_options.headless ? headless_output_image : swapchain.acquire_next_image();
+    }
 
     auto t0 = Clock::now();
     gpu_input.time = std::chrono::duration<daxa_f32>(now - start).count();
-    gpu_input.delta_time = std::chrono::duration<daxa_f32>(now - prev_time).count();
+    auto const wall_delta_time = std::chrono::duration<daxa_f32>(now - prev_time).count();
+    gpu_input.delta_time = wall_delta_time;
     prev_time = now;
-    gpu_input.render_res_scl = ui.render_res_scl;
+    update_input_recording();
+    auto &dyn_res = gpu_app.dynamic_resolution;
+    // Resolution changes driven by measured GPU time would make replays diverge
+    dyn_res.enabled = ui.settings.dynamic_resolution && !input_replay;
+    dyn_res.target_frame_time = 1.0f / std::max(ui.settings.dynamic_resolution_target_fps, 1.0f);
+    dyn_res.min_scale = ui.settings.dynamic_resolution_min_scale;
+    auto const &gpu_profiler = gpu_app.gpu_profiler;
+    dyn_res.update(gpu_profiler.has_new_results ? std::optional{static_cast<daxa_f32>(gpu_profiler.frame_time / 1000.0)} : std::nullopt);
+    gpu_input.render_res_scl = ui.render_res_scl * dyn_res.scale;
+    apply_dynamic_resolution();
     gpu_input.fov = ui.settings.camera_fov * (std::numbers::pi_v<daxa_f32> / 180.0f);
     gpu_input.sensitivity = ui.settings.mouse_sensitivity;
+    gpu_input.chunk_updates_per_frame = ui.settings.tunables.chunk_updates_per_frame;
 
-#if ENABLE_TAA
-    gpu_input.halton_jitter = halton_offsets[gpu_input.frame_index % halton_offsets.size()];
-#endif
+    if (benchmark) {
+        if (auto model_path = benchmark->begin_frame(gpu_input)) {
+            ui.gvox_model_path = *model_path;
+            ui.should_upload_gvox_model = true;
+        }
+    }
+
+    if (gpu_app.tunables.enable_taa) {
+        gpu_input.halton_jitter = halton_offsets[gpu_input.frame_index % halton_offsets.size()];
+    }
 
     audio.set_frequency(gpu_input.delta_time * 1000.0f * 200.0f);
 
     if (ui.should_hotload_shaders) {
+        CPU_PROFILE_ZONE("reload_all");
         auto reload_result = main_pipeline_manager.reload_all();
         if (auto *reload_err = daxa::get_if<daxa::PipelineReloadError>(&reload_result)) {
-            AppUi::Console::s_instance->add_log(reload_err->message);
+            Logger::log(LogLevel::ERR, "shaders", reload_err->message);
         }
     }
 
@@ -648,9 +1122,7 @@ void VoxelApp::on_update() {
         return;
     }
 
-    if (ui.should_upload_seed_data) {
-        update_seeded_value_noise();
-    }
+    update_seeded_value_noise();
 
     if (ui.should_upload_gvox_model) {
         if (false) {
@@ -676,6 +1148,7 @@ void VoxelApp::on_update() {
             }
             if (model_is_loading) {
                 model_is_loading = false;
+                input_recorder.record_model_load(ui.gvox_model_path);
                 gvox_model_data = load_gvox_data();
                 if (gvox_model_data.size != 0) {
                     model_is_ready = true;
@@ -690,71 +1163,131 @@ void VoxelApp::on_update() {
         }
     }
 
-#if !IMMEDIATE_SKY
-    if (ui.should_regenerate_sky) {
-        auto sky_task_graph = daxa::TaskGraph({
-            .device = device,
-            .alias_transients = GVOX_ENGINE_INSTALL,
-            .name = "sky_task_graph",
-        });
-
-        auto record_ctx = RecordContext{
-            .device = this->device,
-            .task_graph = sky_task_graph,
-            .pipeline_manager = &main_pipeline_manager,
-            .render_resolution = gpu_input.rounded_frame_dim,
-            .output_resolution = gpu_input.output_resolution,
-            .task_swapchain_image = task_swapchain_image,
-            .compute_pipelines = &this->compute_pipelines,
-            .raster_pipelines = &this->raster_pipelines,
-        };
-
-        record_ctx.task_input_buffer = gpu_app.task_input_buffer;
-        sky_task_graph.use_persistent_buffer(gpu_app.task_input_buffer);
-
-        auto sky_cube = generate_procedural_sky(record_ctx);
-        gpu_app.sky.use_images(record_ctx);
-        gpu_app.sky.render(record_ctx, sky_cube);
-
-        sky_task_graph.submit({});
-        sky_task_graph.complete({});
-        sky_task_graph.execute({});
-
-        ui.should_regenerate_sky = false;
-    }
-#endif
-
-    gpu_app.begin_frame(device, main_task_graph, ui);
-
-    if (ui.should_run_startup || model_is_ready) {
-        run_startup(main_task_graph);
-    }
     if (model_is_ready) {
-        upload_model(main_task_graph);
+        CPU_PROFILE_ZONE("upload_model");
+        upload_model();
+        model_is_ready = false;
     }
 
+    if (ui.settings.tunables.needs_record(gpu_app.tunables)) {
+        ui.should_record_task_graph = true;
+    }
     if (ui.should_record_task_graph) {
-        device.wait_idle();
+        CPU_PROFILE_ZONE("record_main_task_graph");
+        gpu_app.retired_objects.retire(std::move(main_task_graph));
         main_task_graph = record_main_task_graph();
     }
 
+    {
+        CPU_PROFILE_ZONE("GpuApp::begin_frame");
+        gpu_app.begin_frame(device, main_task_graph, ui);
+    }
+
     gpu_input.fif_index = gpu_input.frame_index % (FRAMES_IN_FLIGHT + 1);
-    // condition_values[static_cast<size_t>(Conditions::DYNAMIC_BUFFERS_REALLOC)] = should_realloc;
-    // main_task_graph.execute({.permutation_condition_values = condition_values});
-    main_task_graph.execute({});
-    model_is_ready = false;
+    if (ui.settings.late_latch_input && !launch_options.headless && !input_replay) {
+        CPU_PROFILE_ZONE("late_latch_input");
+        late_latch_input();
+    }
+    input_latency_probe.on_upload(gpu_app.gpu_profiler.frame_index);
+    input_recorder.record_frame(gpu_input, ui.settings);
+    {
+        CPU_PROFILE_ZONE("TaskGraph::execute");
+        main_task_graph.execute({.permutation_condition_values = gpu_app.condition_values});
+    }
+    ui.should_run_startup = false;
+#if !IMMEDIATE_SKY
+    ui.should_regenerate_sky = false;
+#endif
 
     gpu_input.resize_factor = 1.0f;
     gpu_input.mouse.pos_delta = {0.0f, 0.0f};
     gpu_input.mouse.scroll_delta = {0.0f, 0.0f};
 
-    gpu_app.end_frame(ui);
+    {
+        CPU_PROFILE_ZONE("GpuApp::end_frame");
+        gpu_app.end_frame(ui);
+    }
+    gpu_app.staging_pool.next_frame(device);
+    gpu_app.render_target_pool.next_frame(device);
+    gpu_app.retired_objects.next_frame();
+    gpu_app.gpu_profiler.next_frame();
+    if (input_latency_probe.running) {
+        auto &gpu_profiler = gpu_app.gpu_profiler;
+        if (!gpu_profiler.clock_sync || InputLatencyProbe::Clock::now() - gpu_profiler.clock_sync->cpu_time > InputLatencyProbe::CLOCK_SYNC_PERIOD) {
+            gpu_profiler.sync_clocks();
+        }
+        if (gpu_profiler.has_new_results && gpu_profiler.clock_sync) {
+            input_latency_probe.on_frame_end(gpu_profiler.resolved_frame_index, gpu_profiler.tick_to_cpu_time(gpu_profiler.frame_end_tick), gpu_profiler.clock_sync->uncertainty);
+        }
+    }
 
     auto t1 = Clock::now();
-    ui.update(gpu_input.delta_time, std::chrono::duration<daxa_f32>(t1 - t0).count());
+    {
+        CPU_PROFILE_ZONE("AppUi::update");
+        ui.update(gpu_input.delta_time, std::chrono::duration<daxa_f32>(t1 - t0).count());
+    }
+
+    auto frame_stat_values = std::array<daxa_f32, FrameStats::CATEGORY_COUNT>{};
+    frame_stat_values[FrameStats::FRAME] = wall_delta_time;
+    frame_stat_values[FrameStats::CPU_RECORD] = std::chrono::duration<daxa_f32>(t1 - t0).count();
+    // The profiler keeps its last results while no new frame resolves, and those mustn't be counted twice
+    frame_stat_values[FrameStats::GPU] = gpu_app.gpu_profiler.has_new_results ? static_cast<daxa_f32>(gpu_app.gpu_profiler.frame_time / 1000.0) : -1.0f;
+    // Acquiring the next image is where we block on presentation
+    frame_stat_values[FrameStats::PRESENT_WAIT] = std::chrono::duration<daxa_f32>(t0 - now).count();
+    frame_stats.add_frame(gpu_input.frame_index, frame_stat_values);
+
+    app_metrics.frame_time->record(wall_delta_time * 1000.0);
+    app_metrics.cpu_time->record(frame_stat_values[FrameStats::CPU_RECORD] * 1000.0);
+    if (gpu_app.gpu_profiler.has_new_results) {
+        app_metrics.gpu_time->record(gpu_app.gpu_profiler.frame_time);
+    }
+    app_metrics.frame_n->add(1.0);
+    app_metrics.stutter_n->set(static_cast<daxa_f64>(frame_stats.stutter_n));
+    app_metrics.chunk_update_n->add(gpu_output.voxel_world.chunk_update_n);
+    app_metrics.vram_usage->set(static_cast<daxa_f64>(gpu_app.vram_usage));
+    app_metrics.transient_heap_size->set(static_cast<daxa_f64>(gpu_app.transient_heap_size));
+    app_metrics.render_target_pool_size->set(static_cast<daxa_f64>(gpu_app.render_target_pool.allocated_size));
+    app_metrics.voxel_page_count->set(gpu_app.voxel_world.debug_page_count);
+    app_metrics.voxel_heap_usage->set(gpu_app.voxel_world.debug_gpu_heap_usage);
+
+    if (benchmark && benchmark->phase != Benchmark::Phase::DONE) {
+        auto const &gpu_profiler = gpu_app.gpu_profiler;
+        auto gpu_time = std::optional<daxa_f32>{};
+        auto pass_times = std::vector<std::pair<std::string, daxa_f32>>{};
+        if (gpu_profiler.has_new_results) {
+            gpu_time = static_cast<daxa_f32>(gpu_profiler.frame_time / 1000.0);
+            for (auto const &zone : gpu_profiler.zone_results) {
+                pass_times.emplace_back(zone.name, static_cast<daxa_f32>(zone.duration / 1000.0));
+            }
+        }
+        benchmark->end_frame({
+            .frame_time = wall_delta_time,
+            .cpu_time = std::chrono::duration<daxa_f32>(t1 - t0).count(),
+            .chunk_update_n = gpu_output.voxel_world.chunk_update_n,
+            .visible_chunk_update_n = gpu_output.voxel_world.visible_chunk_update_n,
+            .voxel_heap_usage = gpu_app.voxel_world.debug_gpu_heap_usage,
+            .voxel_page_count = gpu_app.voxel_world.debug_page_count,
+            .vram_usage = gpu_app.vram_usage,
+            .render_target_pool_size = gpu_app.render_target_pool.allocated_size,
+            .gpu_time = gpu_time,
+            .pass_times = std::move(pass_times),
+        });
+        if (benchmark->phase == Benchmark::Phase::DONE) {
+            finish_benchmark();
+        }
+    }
 
     ++gpu_input.frame_index;
-    device.collect_garbage();
+    {
+        CPU_PROFILE_ZONE("collect_garbage");
+        device.collect_garbage();
+    }
+    if (first_frame_phase) {
+        device.wait_idle();
+        first_frame_phase.reset();
+        startup_timer.finish(cpu_profiler, ui.data_directory);
+    }
+    cpu_profiler.next_frame();
 }
 void VoxelApp::on_mouse_move(daxa_f32 x, daxa_f32 y) {
     daxa_f32vec2 const center = {static_cast<daxa_f32>(window_size.x / 2), static_cast<daxa_f32>(window_size.y / 2)};
@@ -778,6 +1311,10 @@ void VoxelApp::on_mouse_scroll(daxa_f32 dx, daxa_f32 dy) {
     gpu_input.mouse.scroll_delta = daxa_f32vec2{gpu_input.mouse.scroll_delta.x + dx, gpu_input.mouse.scroll_delta.y + dy};
 }
 void VoxelApp::on_mouse_button(daxa_i32 button_id, daxa_i32 action) {
+    if (is_late_latching) {
+        deferred_input_events.push_back([this, button_id, action]() { on_mouse_button(button_id, action); });
+        return;
+    }
     auto &io = ImGui::GetIO();
     if (io.WantCaptureMouse) {
         return;
@@ -791,6 +1328,10 @@ void VoxelApp::on_mouse_button(daxa_i32 button_id, daxa_i32 action) {
     }
 }
 void VoxelApp::on_key(daxa_i32 key_id, daxa_i32 action) {
+    if (is_late_latching) {
+        deferred_input_events.push_back([this, key_id, action]() { on_key(key_id, action); });
+        return;
+    }
     auto &io = ImGui::GetIO();
     if (io.WantCaptureKeyboard) {
         return;
@@ -828,6 +1369,12 @@ void VoxelApp::on_key(daxa_i32 key_id, daxa_i32 action) {
     }
 }
 void VoxelApp::on_resize(daxa_u32 sx, daxa_u32 sy) {
+    if (is_late_latching) {
+        // Resizing re-records and runs a frame, which can't happen in the middle of one
+        has_deferred_resize = true;
+        deferred_resize_size = {sx, sy};
+        return;
+    }
     minimized = (sx == 0 || sy == 0);
     auto resized = sx != window_size.x || sy != window_size.y || render_res_scl != ui.render_res_scl;
     if (!minimized && resized) {
@@ -839,161 +1386,151 @@ void VoxelApp::on_resize(daxa_u32 sx, daxa_u32 sy) {
             // resize render images
             // gpu_resources.render_images.size.x = static_cast<daxa_u32>(static_cast<daxa_f32>(window_size.x) * render_res_scl);
             // gpu_resources.render_images.size.y = static_cast<daxa_u32>(static_cast<daxa_f32>(window_size.y) * render_res_scl);
-            device.wait_idle();
             gpu_app.needs_vram_calc = true;
         }
+        gpu_app.retired_objects.retire(std::move(main_task_graph));
         main_task_graph = record_main_task_graph();
         gpu_input.resize_factor = 0.0f;
         on_update();
     }
 }
 void VoxelApp::on_drop(std::span<char const *> filepaths) {
+    if (is_late_latching) {
+        deferred_input_events.push_back([this, path = std::string{filepaths[0]}]() {
+            auto const *path_ptr = path.c_str();
+            on_drop({&path_ptr, 1});
+        });
+        return;
+    }
     ui.gvox_model_path = filepaths[0];
     ui.should_upload_gvox_model = true;
 }
 
+// GpuInput is copied into the upload when the main task graph is executed, so polling right before
+// that picks up any input that arrived while the frame was being prepared. GLFW only allows polling
+// on the main thread, so this stands in for a separate input thread. Only mouse motion and scrolling
+// are latched. The other events are deferred to the next frame (see `deferred_input_events`).
+void VoxelApp::late_latch_input() {
+    is_late_latching = true;
+    glfwPollEvents();
+    is_late_latching = false;
+    input_latency_probe.sample(true);
+}
+
+void VoxelApp::update_present_mode() {
+    ui.should_update_present_mode = false;
+    constexpr auto present_modes = std::array{
+        daxa::PresentMode::IMMEDIATE,
+        daxa::PresentMode::MAILBOX,
+        daxa::PresentMode::FIFO,
+        daxa::PresentMode::FIFO_RELAXED,
+    };
+    auto mode_i = std::clamp(ui.settings.present_mode, 0, static_cast<daxa_i32>(present_modes.size()) - 1);
+    swapchain.set_present_mode(present_modes[static_cast<size_t>(mode_i)]);
+}
+
+auto VoxelApp::target_fps() const -> daxa_f32 {
+    // Battery saving used to be a flat 10ms sleep per frame, so cap it at a similar rate
+    constexpr auto BATTERY_SAVING_FPS = 60.0f;
+    auto result = ui.settings.fps_limit;
+    if (ui.settings.battery_saving_mode) {
+        result = result > 0.0f ? std::min(result, BATTERY_SAVING_FPS) : BATTERY_SAVING_FPS;
+    }
+    return result;
+}
+
 void VoxelApp::compute_image_sizes() {
     gpu_input.frame_dim.x = static_cast<daxa_u32>(static_cast<daxa_f32>(window_size.x) * render_res_scl);
     gpu_input.frame_dim.y = static_cast<daxa_u32>(static_cast<daxa_f32>(window_size.y) * render_res_scl);
     gpu_input.rounded_frame_dim = round_frame_dim(gpu_input.frame_dim);
     gpu_input.output_resolution = window_size;
+    // Dynamic resolution only ever shrinks frame_dim below this, within the same render targets
+    max_frame_dim = gpu_input.frame_dim;
+    apply_dynamic_resolution();
+}
+
+void VoxelApp::apply_dynamic_resolution() {
+    auto const scale = gpu_app.dynamic_resolution.scale;
+    gpu_input.frame_dim.x = std::max(1u, static_cast<daxa_u32>(static_cast<daxa_f32>(max_frame_dim.x) * scale));
+    gpu_input.frame_dim.y = std::max(1u, static_cast<daxa_u32>(static_cast<daxa_f32>(max_frame_dim.y) * scale));
 }
 
+// The noise is generated on a worker thread straight into staging memory, and the copy
+// is recorded into the first frame after it's done.
 void VoxelApp::update_seeded_value_noise() {
-    daxa::TaskGraph temp_task_graph = daxa::TaskGraph({
-        .device = device,
-        .name = "temp_task_graph",
-    });
-    temp_task_graph.use_persistent_image(gpu_app.task_value_noise_image);
-    temp_task_graph.add_task({
-        .attachments = {
-            daxa::inl_atch(daxa::TaskImageAccess::TRANSFER_WRITE, daxa::ImageViewType::REGULAR_2D, gpu_app.task_value_noise_image.view().view({.layer_count = 256})),
-        },
-        .task = [this](daxa::TaskInterface const &ti) {
-            auto staging_buffer = device.create_buffer({
-                .size = static_cast<daxa_u32>(256 * 256 * 256 * 1),
-                .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
-                .name = "staging_buffer",
-            });
-            auto *buffer_ptr = device.get_host_address_as<uint8_t>(staging_buffer).value();
-            std::mt19937_64 rng(std::hash<std::string>{}(ui.settings.world_seed_str));
+    if (ui.should_upload_seed_data && !seed_data_is_loading) {
+        input_recorder.record_seed_change(ui.settings.world_seed_str);
+        auto staging = gpu_app.staging_pool.acquire(device, size_t{256} * 256 * 256 * 1);
+        seed_data_future = std::async(std::launch::async, [staging, seed_str = ui.settings.world_seed_str]() {
+            CPU_PROFILE_ZONE("generate seeded value noise");
+            std::mt19937_64 rng(std::hash<std::string>{}(seed_str));
             std::uniform_int_distribution<std::mt19937::result_type> dist(0, 255);
             for (daxa_u32 i = 0; i < (256 * 256 * 256 * 1); ++i) {
-                buffer_ptr[i] = dist(rng) & 0xff;
+                staging.ptr[i] = dist(rng) & 0xff;
             }
-            ti.recorder.pipeline_barrier({
-                .dst_access = daxa::AccessConsts::TRANSFER_WRITE,
+            return staging;
+        });
+        seed_data_is_loading = true;
+        ui.should_upload_seed_data = false;
+    }
+    if (!seed_data_is_loading || seed_data_future.wait_for(0s) != std::future_status::ready) {
+        return;
+    }
+    seed_data_is_loading = false;
+    gpu_app.pending_uploads.push_back([this, staging = seed_data_future.get()](daxa::TaskInterface const &ti) {
+        gpu_app.staging_pool.release(staging);
+        for (daxa_u32 i = 0; i < 256; ++i) {
+            ti.recorder.copy_buffer_to_image({
+                .buffer = staging.buffer,
+                .buffer_offset = 256 * 256 * i,
+                .image = gpu_app.task_value_noise_image.get_state().images[0],
+                .image_slice{
+                    .base_array_layer = i,
+                    .layer_count = 1,
+                },
+                .image_extent = {256, 256, 1},
             });
-            ti.recorder.destroy_buffer_deferred(staging_buffer);
-            for (daxa_u32 i = 0; i < 256; ++i) {
-                ti.recorder.copy_buffer_to_image({
-                    .buffer = staging_buffer,
-                    .buffer_offset = 256 * 256 * i,
-                    .image = gpu_app.task_value_noise_image.get_state().images[0],
-                    .image_slice{
-                        .base_array_layer = i,
-                        .layer_count = 1,
-                    },
-                    .image_extent = {256, 256, 1},
-                });
-            }
-            gpu_app.needs_vram_calc = true;
-        },
-        .name = "upload_value_noise",
+        }
+        gpu_app.needs_vram_calc = true;
     });
-    temp_task_graph.submit({});
-    temp_task_graph.complete({});
-    temp_task_graph.execute({});
-    ui.should_upload_seed_data = false;
+    // the world has to be regenerated from the new noise
+    ui.should_run_startup = true;
 }
 
-// [Engine initializations tasks]
-//
-// Startup Task (Globals Clear):
-// Clear task_globals_buffer
-// Clear task_temp_voxel_chunks_buffer
-// Clear task_voxel_chunks_buffer
-// Clear task_voxel_malloc_pages_buffer (x3)
-//
-// GPU Task:
-// startup.comp.glsl (Run on 1 thread)
-//
-// Initialize Task:
-// init VoxelMallocPageAllocator buffer
-void VoxelApp::run_startup(daxa::TaskGraph & /*unused*/) {
-    auto temp_task_graph = daxa::TaskGraph({
-        .device = device,
-        .name = "temp_task_graph",
-    });
-
-    auto record_ctx = RecordContext{
-        .device = this->device,
-        .task_graph = temp_task_graph,
-        .pipeline_manager = &main_pipeline_manager,
-        .compute_pipelines = &this->compute_pipelines,
-        .raster_pipelines = &this->raster_pipelines,
-    };
-
-    gpu_app.record_startup(record_ctx);
-
-    temp_task_graph.submit({});
-    temp_task_graph.complete({});
-    temp_task_graph.execute({});
-
-    ui.should_run_startup = false;
-}
-
-void VoxelApp::upload_model(daxa::TaskGraph & /*unused*/) {
-    auto temp_task_graph = daxa::TaskGraph({
-        .device = device,
-        .name = "temp_task_graph",
-    });
-    temp_task_graph.use_persistent_buffer(gpu_app.task_gvox_model_buffer);
-    temp_task_graph.add_task({
-        .attachments = {
-            daxa::inl_atch(daxa::TaskBufferAccess::TRANSFER_WRITE, gpu_app.task_gvox_model_buffer),
-        },
-        .task = [this](daxa::TaskInterface const &ti) {
-            if (!gpu_app.prev_gvox_model_buffer.is_empty()) {
-                ti.recorder.destroy_buffer_deferred(gpu_app.prev_gvox_model_buffer);
-            }
-            ti.recorder.pipeline_barrier({
-                .dst_access = daxa::AccessConsts::TRANSFER_WRITE,
-            });
-            auto staging_gvox_model_buffer = device.create_buffer({
-                .size = static_cast<daxa_u32>(gvox_model_data.size),
-                .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
-                .name = "staging_gvox_model_buffer",
-            });
-            ti.recorder.destroy_buffer_deferred(staging_gvox_model_buffer);
-            char *buffer_ptr = device.get_host_address_as<char>(staging_gvox_model_buffer).value();
-            std::copy(gvox_model_data.ptr, gvox_model_data.ptr + gvox_model_data.size, buffer_ptr);
-            if (gvox_model_data.ptr != nullptr) {
-                free(gvox_model_data.ptr);
-            }
-            ti.recorder.copy_buffer_to_buffer({
-                .src_buffer = staging_gvox_model_buffer,
-                .dst_buffer = gpu_app.gpu_resources.gvox_model_buffer,
-                .size = static_cast<daxa_u32>(gvox_model_data.size),
-            });
-            ui.should_upload_gvox_model = false;
-            has_model = true;
-            gpu_app.needs_vram_calc = true;
-        },
-        .name = "upload_model",
+// Stages the loaded model and queues its copy into the next frame. Uploading a model
+// also restarts the world, which happens in that same frame.
+void VoxelApp::upload_model() {
+    auto staging = gpu_app.staging_pool.acquire(device, gvox_model_data.size);
+    std::copy(gvox_model_data.ptr, gvox_model_data.ptr + gvox_model_data.size, staging.ptr);
+    if (gvox_model_data.ptr != nullptr) {
+        free(gvox_model_data.ptr);
+    }
+    gpu_app.pending_uploads.push_back([this, staging, size = gvox_model_data.size, prev_buffer = gpu_app.prev_gvox_model_buffer](daxa::TaskInterface const &ti) {
+        if (!prev_buffer.is_empty()) {
+            ti.recorder.destroy_buffer_deferred(prev_buffer);
+        }
+        gpu_app.staging_pool.release(staging);
+        ti.recorder.copy_buffer_to_buffer({
+            .src_buffer = staging.buffer,
+            .dst_buffer = gpu_app.gpu_resources.gvox_model_buffer,
+            .size = static_cast<daxa_u32>(size),
+        });
     });
-    temp_task_graph.submit({});
-    temp_task_graph.complete({});
-    temp_task_graph.execute({});
+    gpu_app.prev_gvox_model_buffer = {};
+    ui.should_upload_gvox_model = false;
+    ui.should_run_startup = true;
+    has_model = true;
+    gpu_app.needs_vram_calc = true;
 }
 
 // [Record the command list sent to the GPU each frame]
 
 // List of tasks:
 
-// (Conditional tasks)
+// (Conditional tasks, see GpuApp::Conditions)
+// Voxel malloc realloc
 // Startup (startup.comp.glsl), run on 1 thread
-// Upload settings, Upload model, Voxel malloc realloc
+// Uploads (model, value noise, textures)
 
 // GpuInputUploadTransferTask
 // -> copy buffer from gpu_input to task_input_buffer
@@ -1028,13 +1565,16 @@ auto VoxelApp::record_main_task_graph() -> daxa::TaskGraph {
 
     compute_image_sizes();
 
-    daxa::TaskGraph result_task_graph = daxa::TaskGraph({
+    auto task_graph_info = daxa::TaskGraphInfo{
         .device = device,
-        .swapchain = swapchain,
-        .alias_transients = GVOX_ENGINE_INSTALL,
-        .permutation_condition_count = static_cast<size_t>(Conditions::COUNT),
+        .alias_transients = ui.settings.alias_transients,
+        .permutation_condition_count = static_cast<size_t>(GpuApp::Conditions::COUNT),
         .name = "main_task_graph",
-    });
+    };
+    if (!launch_options.headless) {
+        task_graph_info.swapchain = swapchain;
+    }
+    daxa::TaskGraph result_task_graph = daxa::TaskGraph(task_graph_info);
 
     result_task_graph.use_persistent_image(task_swapchain_image);
 
@@ -1044,28 +1584,62 @@ auto VoxelApp::record_main_task_graph() -> daxa::TaskGraph {
         .pipeline_manager = &main_pipeline_manager,
         .render_resolution = gpu_input.rounded_frame_dim,
         .output_resolution = gpu_input.output_resolution,
+        .tunables = ui.settings.tunables,
         .task_swapchain_image = task_swapchain_image,
         .compute_pipelines = &this->compute_pipelines,
         .raster_pipelines = &this->raster_pipelines,
+        .pipeline_variants = &this->pipeline_variants,
     };
 
     // gpu_app.task_value_noise_image.view().view({});
 
-    gpu_app.record_frame(record_ctx);
-
-    record_ctx.task_graph.add_task({
-        .attachments = {
-            daxa::inl_atch(daxa::TaskImageAccess::COLOR_ATTACHMENT, daxa::ImageViewType::REGULAR_2D, task_swapchain_image),
-        },
+    // Must come before any timed task, since it resets this frame's timestamp queries
+    gpu_app.gpu_profiler.reset_zones();
+    result_task_graph.add_task({
+        .attachments = {},
         .task = [this](daxa::TaskInterface const &ti) {
-            imgui_renderer.record_commands(ImGui::GetDrawData(), ti.recorder, swapchain_image, window_size.x, window_size.y);
+            gpu_app.gpu_profiler.begin_frame(ti.recorder);
         },
-        .name = "ImGui draw",
+        .name = "GpuProfilerBeginFrame",
     });
 
+    gpu_app.record_frame(record_ctx);
+
+    if (launch_options.headless) {
+        record_ctx.add_task({
+            .attachments = {
+                daxa::inl_atch(daxa::TaskImageAccess::TRANSFER_READ, daxa::ImageViewType::REGULAR_2D, task_swapchain_image),
+            },
+            .task = [this](daxa::TaskInterface const &ti) {
+                if (!headless_should_capture) {
+                    return;
+                }
+                ti.recorder.copy_image_to_buffer({
+                    .image = swapchain_image,
+                    .image_extent = {window_size.x, window_size.y, 1},
+                    .buffer = headless_readback_buffer,
+                });
+            },
+            .name = "HeadlessReadbackTask",
+        });
+    } else {
+        record_ctx.add_task({
+            .attachments = {
+                daxa::inl_atch(daxa::TaskImageAccess::COLOR_ATTACHMENT, daxa::ImageViewType::REGULAR_2D, task_swapchain_image),
+            },
+            .task = [this](daxa::TaskInterface const &ti) {
+                imgui_renderer.record_commands(ImGui::GetDrawData(), ti.recorder, swapchain_image, window_size.x, window_size.y);
+            },
+            .name = "ImGui draw",
+        });
+    }
+
     result_task_graph.submit({});
-    result_task_graph.present({});
+    if (!launch_options.headless) {
+        result_task_graph.present({});
+    }
     result_task_graph.complete({});
+    task_graph_view.set_graph(std::move(record_ctx.task_nodes), gpu_app.transient_infos);
 
     return result_task_graph;
 }
@@ -4,42 +4,120 @@
 #include "app_ui.hpp"
 #include "app_audio.hpp"
 #include "mesh_model.hpp"
+#include "frame_pacer.hpp"
+#include "cpu_profiler.hpp"
+#include "frame_stats.hpp"
+#include "metrics_sink.hpp"
+#include "input_latency.hpp"
+#include "benchmark.hpp"
+#include "startup_timer.hpp"
+#include "input_recording.hpp"
+#include "task_graph_view.hpp"
 
 #include <shared/app.inl>
 
 #include <chrono>
+#include <filesystem>
 #include <future>
+#include <span>
 
 struct GvoxModelData {
     size_t size = 0;
     uint8_t *ptr = nullptr;
 };
 
+// Command line options. `--headless` runs without a window, swapchain or UI, rendering the final image
+// into an offscreen target instead.
+struct LaunchOptions {
+    bool headless = false;
+    daxa_u32vec2 size = {1280, 720};
+    // Headless runs stop after `frame_n` frames or `max_seconds` seconds, whichever comes first
+    daxa_u32 frame_n = 0;
+    daxa_f32 max_seconds = 0.0f;
+    // If set, headless frames are written here as PNGs, every `output_interval` frames and on the last frame
+    std::filesystem::path output_dir{};
+    daxa_u32 output_interval = 0;
+    // Runs the given scenario, writes a report to `report_path`, and exits
+    std::filesystem::path benchmark_path{};
+    std::filesystem::path report_path = "benchmark_report.json";
+    // Records a session to `record_path`, or replays `replay_path` and exits
+    std::filesystem::path record_path{};
+    std::filesystem::path replay_path{};
+    // Appends metrics to `metrics_path` every `metrics_interval` seconds
+    std::filesystem::path metrics_path{};
+    daxa_f32 metrics_interval = 1.0f;
+    // Also writes the log to `log_path`
+    std::filesystem::path log_path{};
+    // Runs a console script once startup is done
+    std::filesystem::path exec_path{};
+
+    static auto parse(std::span<char const *const> args) -> LaunchOptions;
+};
+
 struct VoxelApp : AppWindow<VoxelApp> {
     using Clock = std::chrono::high_resolution_clock;
     Clock::time_point start = Clock::now();
     Clock::time_point prev_time;
+    StartupTimer startup_timer;
+
+    LaunchOptions launch_options;
 
     daxa::Instance daxa_instance;
     daxa::Device device;
 
     daxa::Swapchain swapchain;
     daxa::ImageId swapchain_image{};
-    daxa::TaskImage task_swapchain_image{daxa::TaskImageInfo{.swapchain_image = true}};
+    daxa::TaskImage task_swapchain_image{daxa::TaskImageInfo{.swapchain_image = !launch_options.headless}};
+    // Headless mode renders into this instead of a swapchain image
+    daxa::ImageId headless_output_image{};
+    daxa::BufferId headless_readback_buffer{};
+    bool headless_should_capture = false;
 
     AsyncPipelineManager main_pipeline_manager;
     std::unordered_map<std::string, std::shared_ptr<AsyncManagedComputePipeline>> compute_pipelines;
     std::unordered_map<std::string, std::shared_ptr<AsyncManagedRasterPipeline>> raster_pipelines;
+    std::unordered_map<std::string, std::string> pipeline_variants;
 
     AppUi ui;
     AppAudio audio;
+    FramePacer frame_pacer;
+    CpuProfiler cpu_profiler;
+    FrameStats frame_stats;
+    MetricsSink metrics_sink;
+    struct AppMetrics {
+        MetricsSink::Metric *frame_time;
+        MetricsSink::Metric *cpu_time;
+        MetricsSink::Metric *gpu_time;
+        MetricsSink::Metric *frame_n;
+        MetricsSink::Metric *stutter_n;
+        MetricsSink::Metric *chunk_update_n;
+        MetricsSink::Metric *vram_usage;
+        MetricsSink::Metric *transient_heap_size;
+        MetricsSink::Metric *render_target_pool_size;
+        MetricsSink::Metric *voxel_page_count;
+        MetricsSink::Metric *voxel_heap_usage;
+    } app_metrics{};
+    InputLatencyProbe input_latency_probe;
+    bool is_late_latching = false;
+    // Key, button and drop events that arrive during the late latch. They change pause, UI and startup
+    // state that the frame has already acted on, so they're applied before the next frame's events.
+    std::vector<std::function<void()>> deferred_input_events;
+    bool has_deferred_resize = false;
+    daxa_u32vec2 deferred_resize_size{};
     daxa::ImGuiRenderer imgui_renderer;
     GpuApp gpu_app;
+    TaskGraphView task_graph_view;
+    std::optional<Benchmark> benchmark;
+    InputRecorder input_recorder;
+    std::optional<InputReplay> input_replay;
+    InputRecordingUi input_recording_ui;
+    bool should_quit = false;
 
     std::array<daxa_f32vec2, 128> halton_offsets{};
     GpuInput &gpu_input{gpu_app.gpu_input};
     GpuOutput &gpu_output{gpu_app.gpu_output};
     daxa_f32 render_res_scl{1.0f};
+    daxa_u32vec2 max_frame_dim{};
     GvoxContext *gvox_ctx;
 
     bool has_model = false;
@@ -48,13 +126,12 @@ struct VoxelApp : AppWindow<VoxelApp> {
     bool model_is_loading = false;
     bool model_is_ready = false;
 
-    enum class Conditions {
-        COUNT,
-    };
-    std::array<bool, static_cast<size_t>(Conditions::COUNT)> condition_values{};
+    std::future<StagingBufferPool::Allocation> seed_data_future;
+    bool seed_data_is_loading = false;
+
     daxa::TaskGraph main_task_graph;
 
-    VoxelApp();
+    VoxelApp(LaunchOptions const &a_launch_options = {});
     VoxelApp(VoxelApp const &) = delete;
     VoxelApp(VoxelApp &&) = delete;
     auto operator=(VoxelApp const &) -> VoxelApp & = delete;
@@ -62,6 +139,12 @@ struct VoxelApp : AppWindow<VoxelApp> {
     ~VoxelApp();
 
     void run();
+    void run_headless();
+    void write_headless_frame(daxa_u32 frame_i);
+    auto start_benchmark(std::filesystem::path const &path) -> bool;
+    void finish_benchmark();
+    void register_console_commands();
+    void update_input_recording();
 
     auto load_gvox_data_from_parser(GvoxAdapterContext *i_ctx, GvoxAdapterContext *p_ctx, GvoxRegionRange const *region_range) -> GvoxModelData;
     auto load_gvox_data() -> GvoxModelData;
@@ -76,10 +159,13 @@ struct VoxelApp : AppWindow<VoxelApp> {
     void on_drop(std::span<char const *> filepaths);
 
     void compute_image_sizes();
+    void update_present_mode();
+    void late_latch_input();
+    auto target_fps() const -> daxa_f32;
+    void apply_dynamic_resolution();
 
     void update_seeded_value_noise();
-    void run_startup(daxa::TaskGraph &temp_task_graph);
-    void upload_model(daxa::TaskGraph &temp_task_graph);
+    void upload_model();
 
     auto record_main_task_graph() -> daxa::TaskGraph;
 };
@@ -169,7 +169,8 @@ void main() {
 
         uint simulated_particle_index = uint(particle_id) - 1;
         SimulatedVoxelParticle particle = deref(simulated_voxel_particles[simulated_particle_index]);
-        float dt = min(deref(gpu_input).delta_time, 0.01);
+        // How far the particle moved this frame, see `particle_update`
+        float dt = float(deref(gpu_input).phys_step_n) * GAME_PHYS_UPDATE_DT;
         vec3 pos = get_particle_worldspace_origin(globals, particle.pos);
         vec3 extra_vel = daxa_f32vec3(deref(globals).player.player_unit_offset - deref(globals).player.prev_unit_offset);
         vec3 prev_pos = get_particle_worldspace_origin(globals, particle.pos - particle.vel * dt + extra_vel);
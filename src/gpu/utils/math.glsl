@@ -824,8 +824,8 @@ daxa_f32vec4 apply_bilinear_custom_weights(daxa_f32vec4 s00, daxa_f32vec4 s10, d
     return r * (should_normalize ? (1.0 / dot(w, daxa_f32vec4(1.0))) : 1.0);
 }
 
-void apply_friction(daxa_BufferPtr(GpuInput) gpu_input, in out vec3 vel, vec3 friction_vec, float friction_coeff) {
-    float fac = deref(gpu_input).delta_time * friction_coeff;
+void apply_friction(float dt, in out vec3 vel, vec3 friction_vec, float friction_coeff) {
+    float fac = dt * friction_coeff;
     vec3 new_vel = vel - normalize(friction_vec) * fac;
 
     if (dot(vel, new_vel) > 0.000) {
@@ -10,11 +10,14 @@ void player_fix_chunk_offset(
     daxa_RWBufferPtr(GpuGlobals) globals_ptr) {
     PLAYER.prev_unit_offset = PLAYER.player_unit_offset;
 #if ENABLE_CHUNK_WRAPPING
-    PLAYER.player_unit_offset += daxa_i32vec3(floor(PLAYER.pos));
+    daxa_f32vec3 unit_shift = floor(PLAYER.pos);
+    PLAYER.player_unit_offset += daxa_i32vec3(unit_shift);
     PLAYER.pos = fract(PLAYER.pos);
+    PLAYER.prev_pos -= unit_shift;
 #else
     // Logic to recover when debugging, and toggling the ENABLE_CHUNK_WRAPPING define!
     PLAYER.pos += daxa_f32vec3(PLAYER.player_unit_offset);
+    PLAYER.prev_pos += daxa_f32vec3(PLAYER.player_unit_offset);
     PLAYER.player_unit_offset = daxa_i32vec3(0);
 #endif
 }
@@ -26,6 +29,7 @@ void player_startup(
     daxa_RWBufferPtr(GpuGlobals) globals_ptr) {
     PLAYER.pos = daxa_f32vec3(0.01, 0.02, 0.03);
     PLAYER.vel = daxa_f32vec3(0.0);
+    PLAYER.prev_pos = PLAYER.pos;
     // PLAYER.pos = daxa_f32vec3(150.01, 150.02, 80.03);
     // PLAYER.pos = daxa_f32vec3(66.01, 38.02, 14.01);
 
@@ -53,8 +57,17 @@ void player_perframe(
     daxa_BufferPtr(GpuInput) input_ptr,
     daxa_RWBufferPtr(GpuGlobals) globals_ptr) {
     const daxa_f32 mouse_sens = 1.0;
-
-    if (INPUT.actions[GAME_ACTION_INTERACT1] != 0) {
+    // The scripted pose replaces mouse-look and movement entirely, so held keys can't move it
+    const bool is_scripted = (INPUT.flags & GAME_FLAG_BITS_SCRIPTED_CAMERA) != 0;
+
+    if (is_scripted) {
+        PLAYER.pos = INPUT.scripted_cam_pos - daxa_f32vec3(PLAYER.player_unit_offset);
+        PLAYER.prev_pos = PLAYER.pos;
+        PLAYER.vel = daxa_f32vec3(0.0);
+        PLAYER.yaw = INPUT.scripted_cam_rot.x;
+        PLAYER.pitch = INPUT.scripted_cam_rot.y;
+        PLAYER.roll = INPUT.scripted_cam_rot.z;
+    } else if (INPUT.actions[GAME_ACTION_INTERACT1] != 0) {
         PLAYER.roll += INPUT.mouse.pos_delta.x * mouse_sens * INPUT.sensitivity * 0.001;
     } else {
         PLAYER.yaw += INPUT.mouse.pos_delta.x * mouse_sens * INPUT.sensitivity * 0.001;
@@ -96,41 +109,50 @@ void player_perframe(
             move_vec += daxa_f32vec3(0, 0, 1);
         if (INPUT.actions[GAME_ACTION_CROUCH] != 0)
             move_vec -= daxa_f32vec3(0, 0, 1);
+    }
 
-        PLAYER.vel = move_vec * applied_speed;
-        PLAYER.pos += PLAYER.vel * INPUT.delta_time;
-    } else {
-        vec3 pos = PLAYER.pos + daxa_f32vec3(PLAYER.player_unit_offset);
-        vec3 vel = PLAYER.vel;
+    // Movement runs at the fixed physics rate, as many steps as the CPU accumulated for this frame
+    const daxa_f32 dt = GAME_PHYS_UPDATE_DT;
+    const daxa_u32 move_step_n = is_scripted ? 0 : INPUT.phys_step_n;
+    for (daxa_u32 step_i = 0; step_i < move_step_n; ++step_i) {
+        PLAYER.prev_pos = PLAYER.pos;
+
+        if (is_flying) {
+            PLAYER.vel = move_vec * applied_speed;
+            PLAYER.pos += PLAYER.vel * dt;
+        } else {
+            vec3 pos = PLAYER.pos + daxa_f32vec3(PLAYER.player_unit_offset);
+            vec3 vel = PLAYER.vel;
 
-        daxa_f32vec3 nonvertical_vel = daxa_f32vec3(vel.xy, 0);
+            daxa_f32vec3 nonvertical_vel = daxa_f32vec3(vel.xy, 0);
 
-        vel += daxa_f32vec3(0, 0, -9.8) * INPUT.delta_time;
-        pos += vel * INPUT.delta_time;
+            vel += daxa_f32vec3(0, 0, -9.8) * dt;
+            pos += vel * dt;
 
-        bool is_on_ground = pos.z < 0.0;
+            bool is_on_ground = pos.z < 0.0;
 
-        if (is_on_ground) {
-            pos.z = 0.0;
-            vel.z = 0.0;
-            if (INPUT.actions[GAME_ACTION_JUMP] != 0)
-                vel += daxa_f32vec3(0, 0, 3.0);
+            if (is_on_ground) {
+                pos.z = 0.0;
+                vel.z = 0.0;
+                if (INPUT.actions[GAME_ACTION_JUMP] != 0)
+                    vel += daxa_f32vec3(0, 0, 3.0);
 
-            apply_friction(input_ptr, vel, nonvertical_vel, 8.0);
+                apply_friction(dt, vel, nonvertical_vel, 8.0);
 
-            if (dot(nonvertical_vel, nonvertical_vel) > MAX_SPEED * MAX_SPEED) {
-                vel.xy -= normalize(vel.xy) * MAX_SPEED;
+                if (dot(nonvertical_vel, nonvertical_vel) > MAX_SPEED * MAX_SPEED) {
+                    vel.xy -= normalize(vel.xy) * MAX_SPEED;
+                }
+            } else {
             }
-        } else {
-        }
 
-        if (dot(move_vec, move_vec) != 0.0) {
-            move_vec = normalize(move_vec);
-            vel += move_vec * max(applied_speed - dot(nonvertical_vel, move_vec), 0.0);
-        }
+            if (dot(move_vec, move_vec) != 0.0) {
+                move_vec = normalize(move_vec);
+                vel += move_vec * max(applied_speed - dot(nonvertical_vel, move_vec), 0.0);
+            }
 
-        PLAYER.pos = pos - daxa_f32vec3(PLAYER.player_unit_offset);
-        PLAYER.vel = vel;
+            PLAYER.pos = pos - daxa_f32vec3(PLAYER.player_unit_offset);
+            PLAYER.vel = vel;
+        }
     }
 
     player_fix_chunk_offset(input_ptr, globals_ptr);
@@ -181,8 +203,10 @@ void player_perframe(
     PLAYER.cam.view_to_sample = jitter_mat * PLAYER.cam.view_to_clip;
     PLAYER.cam.sample_to_view = PLAYER.cam.clip_to_view * inv_jitter_mat;
 
-    PLAYER.cam.view_to_world = translation_matrix(PLAYER.pos) * rotation_matrix(PLAYER.yaw, PLAYER.pitch, PLAYER.roll);
-    PLAYER.cam.world_to_view = inv_rotation_matrix(PLAYER.yaw, PLAYER.pitch, PLAYER.roll) * translation_matrix(-PLAYER.pos);
+    // The camera sits between the last two physics steps, so motion stays smooth at any frame rate
+    daxa_f32vec3 cam_pos = mix(PLAYER.prev_pos, PLAYER.pos, INPUT.phys_alpha);
+    PLAYER.cam.view_to_world = translation_matrix(cam_pos) * rotation_matrix(PLAYER.yaw, PLAYER.pitch, PLAYER.roll);
+    PLAYER.cam.world_to_view = inv_rotation_matrix(PLAYER.yaw, PLAYER.pitch, PLAYER.roll) * translation_matrix(-cam_pos);
 
     PLAYER.cam.clip_to_prev_clip =
         PLAYER.cam.prev_view_to_prev_clip *
@@ -10,42 +10,101 @@
 #define CHUNKS(i) deref(voxel_chunks[i])
 #define INDIRECT deref(globals).indirect_dispatch
 
-void try_elect(in out VoxelChunkUpdateInfo work_item, in out uint update_index) {
-    daxa_u32 prev_update_n = atomicAdd(VOXEL_WORLD.chunk_update_n, 1);
-
-    // Check if the work item can be added
-    if (prev_update_n < MAX_CHUNK_UPDATES_PER_FRAME) {
-        // Set the chunk edit dispatch z axis (64/8, 64/8, 64 x 8 x 8 / 8 = 64 x 8) = (8, 8, 512)
-        atomicAdd(INDIRECT.chunk_edit_dispatch.z, CHUNK_SIZE / 8);
-        atomicAdd(INDIRECT.subchunk_x2x4_dispatch.z, 1);
-        atomicAdd(INDIRECT.subchunk_x8up_dispatch.z, 1);
-        // Set the chunk update info
-        VOXEL_WORLD.chunk_update_infos[prev_update_n] = work_item;
-        update_index = prev_update_n + 1;
+// Chunks needing an update are elected in two stages, so that a limited per-frame budget goes to the
+// chunks the player is most likely to notice, rather than to whichever invocations win an atomic race.
+// Stage 0 finds the chunks that need an update, gives each a priority bucket and counts the chunks per
+// bucket. Stage 1 elects every chunk in the most urgent buckets that fit in the budget, and as many of
+// the bucket straddling the budget as there is room for.
+
+VoxelChunkUpdateInfo chunk_work_item(daxa_i32vec3 chunk_n, out daxa_u32 chunk_index) {
+    VoxelChunkUpdateInfo work_item;
+    work_item.i = daxa_i32vec3(gl_GlobalInvocationID.xyz) & (chunk_n - 1);
+    work_item.lod_index = gl_GlobalInvocationID.z >> LOG2_CHUNKS_PER_LEVEL_PER_AXIS;
+    work_item.chunk_offset = (VOXEL_WORLD.offset >> daxa_i32vec3(3 + work_item.lod_index));
+    work_item.brush_flags = BRUSH_FLAGS_WORLD_BRUSH;
+    work_item.brush_input = deref(globals).brush_input;
+    // (const) number of chunks in each axis
+    chunk_index = calc_chunk_index_from_worldspace(work_item.i, chunk_n) + work_item.lod_index * TOTAL_CHUNKS_PER_LOD;
+    return work_item;
+}
+
+// Leaf chunk position in world space, in chunks of the work item's LOD
+daxa_i32vec3 chunk_world_position(VoxelChunkUpdateInfo work_item, daxa_i32vec3 chunk_n) {
+    // Wrapped chunk index in leaf chunk space (0^3 - 31^3)
+    daxa_i32vec3 wrapped_chunk_i = imod3(work_item.i - imod3(work_item.chunk_offset - daxa_i32vec3(chunk_n), daxa_i32vec3(chunk_n)), daxa_i32vec3(chunk_n));
+    return work_item.chunk_offset + wrapped_chunk_i - daxa_i32vec3(chunk_n / 2);
+}
+
+#if PER_CHUNK_STAGE == 0
+
+// Whether a sphere (relative to the player's unit offset, like the camera) overlaps the camera frustum.
+// The side planes come from the rows of the world to clip matrix, and the last one rejects what's behind
+// the camera. The far plane is at infinity, so there's none to test.
+bool sphere_in_frustum(daxa_f32vec3 center, daxa_f32 radius) {
+    daxa_f32mat4x4 world_to_clip = PLAYER.cam.view_to_clip * PLAYER.cam.world_to_view;
+    daxa_f32vec4 row_x = daxa_f32vec4(world_to_clip[0][0], world_to_clip[1][0], world_to_clip[2][0], world_to_clip[3][0]);
+    daxa_f32vec4 row_y = daxa_f32vec4(world_to_clip[0][1], world_to_clip[1][1], world_to_clip[2][1], world_to_clip[3][1]);
+    daxa_f32vec4 row_w = daxa_f32vec4(world_to_clip[0][3], world_to_clip[1][3], world_to_clip[2][3], world_to_clip[3][3]);
+    daxa_f32vec4 planes[5] = daxa_f32vec4[5](row_w + row_x, row_w - row_x, row_w + row_y, row_w - row_y, row_w);
+    for (daxa_u32 i = 0; i < 5; ++i) {
+        if (dot(planes[i].xyz, center) + planes[i].w < -radius * length(planes[i].xyz)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Lower is more urgent. User edits come first, since they're what the player is looking at. An edit is
+// queued again every frame its brush is held, so one that misses the budget keeps bucket 0 rather than
+// aging out. Then chunks go by distance from the player, on a log scale. Chunks outside the camera
+// frustum count as 1.5x to 3x further away than they are, the more so the further behind the camera.
+daxa_u32 chunk_priority_bucket(VoxelChunkUpdateInfo work_item, daxa_i32vec3 chunk_n, out bool is_visible) {
+    if ((work_item.brush_flags & (BRUSH_FLAGS_USER_BRUSH_A | BRUSH_FLAGS_USER_BRUSH_B)) != 0) {
+        is_visible = true;
+        return 0;
     }
+    daxa_f32 lod0_chunk_size = daxa_f32(CHUNK_SIZE) / daxa_f32(VOXEL_SCL);
+    daxa_f32 chunk_size = lod0_chunk_size * daxa_f32(1 << work_item.lod_index);
+    daxa_f32vec3 chunk_center = (daxa_f32vec3(chunk_world_position(work_item, chunk_n)) + 0.5) * chunk_size;
+    daxa_f32vec3 player_pos = daxa_f32vec3(PLAYER.player_unit_offset) + PLAYER.pos;
+    daxa_f32vec3 to_chunk = chunk_center - player_pos;
+    daxa_f32 dist = length(to_chunk);
+    // The chunks around the player are always in view, whichever way the camera faces
+    is_visible = dist < chunk_size * 1.5 || sphere_in_frustum(chunk_center - daxa_f32vec3(PLAYER.player_unit_offset), chunk_size * 0.87);
+    daxa_f32 facing = 1.0;
+    if (!is_visible) {
+        daxa_f32vec3 view_dir = ray_dir_ws(unjittered_vrc_from_uv(globals, daxa_f32vec2(0.5)));
+        facing = min(dot(to_chunk / dist, view_dir), 0.5);
+    }
+    daxa_f32 effective_dist = dist * (2.0 - facing) / lod0_chunk_size;
+    return 1 + min(daxa_u32(log2(1.0 + effective_dist) * 4.0), CHUNK_PRIORITY_BUCKET_N - 2);
+}
+
+void queue_candidate(VoxelChunkUpdateInfo work_item, daxa_i32vec3 chunk_n, daxa_u32 chunk_index) {
+    bool is_visible;
+    daxa_u32 bucket = chunk_priority_bucket(work_item, chunk_n, is_visible);
+    atomicAdd(VOXEL_WORLD.chunk_update_n, 1);
+    atomicAdd(VOXEL_WORLD.chunk_priority_bucket_counts[bucket], 1);
+    if (is_visible) {
+        atomicAdd(VOXEL_WORLD.visible_chunk_update_n, 1);
+    }
+    CHUNKS(chunk_index).update_candidate = (work_item.brush_flags << 8) | bucket;
 }
 
 layout(local_size_x = 8, local_size_y = 8, local_size_z = 8) in;
 void main() {
     daxa_i32vec3 chunk_n = daxa_i32vec3(1 << LOG2_CHUNKS_PER_LEVEL_PER_AXIS);
 
-    VoxelChunkUpdateInfo terrain_work_item;
-    terrain_work_item.i = daxa_i32vec3(gl_GlobalInvocationID.xyz) & (chunk_n - 1);
-    terrain_work_item.lod_index = gl_GlobalInvocationID.z >> LOG2_CHUNKS_PER_LEVEL_PER_AXIS;
+    daxa_u32 chunk_index;
+    VoxelChunkUpdateInfo terrain_work_item = chunk_work_item(chunk_n, chunk_index);
 
-    daxa_i32vec3 offset = (VOXEL_WORLD.offset >> daxa_i32vec3(3 + terrain_work_item.lod_index));
+    daxa_i32vec3 offset = terrain_work_item.chunk_offset;
     daxa_i32vec3 prev_offset = (VOXEL_WORLD.prev_offset >> daxa_i32vec3(3 + terrain_work_item.lod_index));
 
-    terrain_work_item.chunk_offset = offset;
-    terrain_work_item.brush_flags = BRUSH_FLAGS_WORLD_BRUSH;
-
-    // (const) number of chunks in each axis
-    daxa_u32 chunk_index = calc_chunk_index_from_worldspace(terrain_work_item.i, chunk_n) + terrain_work_item.lod_index * TOTAL_CHUNKS_PER_LOD;
-
-    uint update_index = 0;
+    CHUNKS(chunk_index).update_candidate = 0;
 
     if ((CHUNKS(chunk_index).flags & CHUNK_FLAGS_ACCEL_GENERATED) == 0) {
-        try_elect(terrain_work_item, update_index);
+        queue_candidate(terrain_work_item, chunk_n, chunk_index);
     } else if (offset != prev_offset) {
         // invalidate chunks outside the chunk_offset
         daxa_i32vec3 diff = clamp(daxa_i32vec3(offset - prev_offset), -chunk_n, chunk_n);
@@ -67,32 +126,82 @@ void main() {
         if ((temp_chunk_i.x >= start.x && temp_chunk_i.x < end.x) ||
             (temp_chunk_i.y >= start.y && temp_chunk_i.y < end.y) ||
             (temp_chunk_i.z >= start.z && temp_chunk_i.z < end.z)) {
+            // Not electing it this frame leaves it to the branch above in later frames
             CHUNKS(chunk_index).flags &= ~CHUNK_FLAGS_ACCEL_GENERATED;
-            try_elect(terrain_work_item, update_index);
+            queue_candidate(terrain_work_item, chunk_n, chunk_index);
         }
     } else {
-        // Wrapped chunk index in leaf chunk space (0^3 - 31^3)
-        daxa_i32vec3 wrapped_chunk_i = imod3(terrain_work_item.i - imod3(terrain_work_item.chunk_offset - daxa_i32vec3(chunk_n), daxa_i32vec3(chunk_n)), daxa_i32vec3(chunk_n));
-        // Leaf chunk position in world space
-        daxa_i32vec3 world_chunk = terrain_work_item.chunk_offset + wrapped_chunk_i - daxa_i32vec3(chunk_n / 2);
-
-        terrain_work_item.brush_input = deref(globals).brush_input;
+        daxa_i32vec3 world_chunk = chunk_world_position(terrain_work_item, chunk_n);
 
         daxa_i32vec3 brush_chunk = (daxa_i32vec3(floor(deref(globals).brush_input.pos)) + deref(globals).brush_input.pos_offset) >> 3;
         bool is_near_brush = all(greaterThanEqual(world_chunk, brush_chunk - 1)) && all(lessThanEqual(world_chunk, brush_chunk + 1));
 
         if (is_near_brush && deref(gpu_input).actions[GAME_ACTION_BRUSH_A] != 0) {
             terrain_work_item.brush_flags = BRUSH_FLAGS_USER_BRUSH_A;
-            try_elect(terrain_work_item, update_index);
+            queue_candidate(terrain_work_item, chunk_n, chunk_index);
         } else if (is_near_brush && deref(gpu_input).actions[GAME_ACTION_BRUSH_B] != 0) {
             terrain_work_item.brush_flags = BRUSH_FLAGS_USER_BRUSH_B;
-            try_elect(terrain_work_item, update_index);
+            queue_candidate(terrain_work_item, chunk_n, chunk_index);
+        }
+    }
+}
+
+#endif
+
+#if PER_CHUNK_STAGE == 1
+
+void elect(in out VoxelChunkUpdateInfo work_item, in out uint update_index) {
+    daxa_u32 prev_update_n = atomicAdd(VOXEL_WORLD.chunk_elected_n, 1);
+    // Set the chunk edit dispatch z axis (64/8, 64/8, 64 x 8 x 8 / 8 = 64 x 8) = (8, 8, 512)
+    atomicAdd(INDIRECT.chunk_edit_dispatch.z, CHUNK_SIZE / 8);
+    atomicAdd(INDIRECT.subchunk_x2x4_dispatch.z, 1);
+    atomicAdd(INDIRECT.subchunk_x8up_dispatch.z, 1);
+    // Set the chunk update info
+    VOXEL_WORLD.chunk_update_infos[prev_update_n] = work_item;
+    update_index = prev_update_n + 1;
+}
+
+layout(local_size_x = 8, local_size_y = 8, local_size_z = 8) in;
+void main() {
+    daxa_i32vec3 chunk_n = daxa_i32vec3(1 << LOG2_CHUNKS_PER_LEVEL_PER_AXIS);
+
+    daxa_u32 chunk_index;
+    VoxelChunkUpdateInfo work_item = chunk_work_item(chunk_n, chunk_index);
+
+    uint update_index = 0;
+    daxa_u32 candidate = CHUNKS(chunk_index).update_candidate;
+
+    if (candidate != 0) {
+        work_item.brush_flags = candidate >> 8;
+        daxa_u32 bucket = candidate & 0xff;
+
+        // Find the bucket that straddles the budget. Everything before it fits.
+        daxa_u32 cutoff_bucket = 0;
+        daxa_u32 count_before_cutoff = 0;
+        for (; cutoff_bucket < CHUNK_PRIORITY_BUCKET_N - 1; ++cutoff_bucket) {
+            daxa_u32 bucket_count = VOXEL_WORLD.chunk_priority_bucket_counts[cutoff_bucket];
+            if (count_before_cutoff + bucket_count > deref(gpu_input).chunk_updates_per_frame) {
+                break;
+            }
+            count_before_cutoff += bucket_count;
+        }
+
+        if (bucket < cutoff_bucket) {
+            elect(work_item, update_index);
+        } else if (bucket == cutoff_bucket) {
+            // Counted separately, so these can't take the slots of the more urgent buckets
+            daxa_u32 cutoff_i = atomicAdd(VOXEL_WORLD.chunk_cutoff_elected_n, 1);
+            if (count_before_cutoff + cutoff_i < deref(gpu_input).chunk_updates_per_frame) {
+                elect(work_item, update_index);
+            }
         }
     }
 
     CHUNKS(chunk_index).update_index = update_index;
 }
 
+#endif
+
 #undef INDIRECT
 #undef CHUNKS
 #undef PLAYER
@@ -38,7 +38,15 @@ void voxel_world_perframe(
         deref(ptrs.globals).chunk_update_infos[i].i = INVALID_CHUNK_I;
     }
 
+    deref(gpu_output[deref(gpu_input).fif_index]).voxel_world.chunk_update_n = deref(ptrs.globals).chunk_update_n;
+    deref(gpu_output[deref(gpu_input).fif_index]).voxel_world.visible_chunk_update_n = deref(ptrs.globals).visible_chunk_update_n;
     deref(ptrs.globals).chunk_update_n = 0;
+    deref(ptrs.globals).visible_chunk_update_n = 0;
+    deref(ptrs.globals).chunk_elected_n = 0;
+    deref(ptrs.globals).chunk_cutoff_elected_n = 0;
+    for (daxa_u32 i = 0; i < CHUNK_PRIORITY_BUCKET_N; ++i) {
+        deref(ptrs.globals).chunk_priority_bucket_counts[i] = 0;
+    }
 
     deref(ptrs.globals).prev_offset = deref(ptrs.globals).offset;
     deref(ptrs.globals).offset = deref(globals_ptr).player.player_unit_offset;
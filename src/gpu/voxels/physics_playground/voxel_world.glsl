@@ -65,5 +65,7 @@ void voxel_world_perframe(daxa_BufferPtr(GpuInput) gpu_input, daxa_RWBufferPtr(G
     // daxa_f32vec3 offset = daxa_f32vec3(deref(ptrs.globals).offset);
     // daxa_f32vec3 ray_pos = ray_origin_ws(vrc) + offset;
 
-    deref(ptrs.globals).rigid_bodies[3].rot.y += DELTA_TIME;
+    for (daxa_u32 step_i = 0; step_i < deref(gpu_input).phys_step_n; ++step_i) {
+        deref(ptrs.globals).rigid_bodies[3].rot.y += DELTA_TIME;
+    }
 }
@@ -38,9 +38,7 @@ void particle_spawn(in out SimulatedVoxelParticle self, daxa_u32 index) {
     self.packed_voxel = pack_voxel(particle_voxel);
 }
 
-void particle_update(in out SimulatedVoxelParticle self, VoxelBufferPtrs voxels_buffer_ptrs, daxa_BufferPtr(GpuInput) gpu_input, in out bool should_place) {
-    rand_seed(gl_GlobalInvocationID.x + uint((deref(gpu_input).time) * 13741));
-
+void particle_step(in out SimulatedVoxelParticle self, VoxelBufferPtrs voxels_buffer_ptrs, float dt, in out bool should_place) {
     // if (PER_VOXEL_NORMALS != 0) {
     //     Voxel particle_voxel = unpack_voxel(self.packed_voxel);
     //     particle_voxel.normal = normalize(deref(globals).player.pos - get_particle_worldspace_pos(globals, self.pos));
@@ -55,7 +53,6 @@ void particle_update(in out SimulatedVoxelParticle self, VoxelBufferPtrs voxels_
             return;
         }
 
-        float dt = min(deref(gpu_input).delta_time, 0.01);
         self.duration_alive += dt;
 
         if ((self.flags & PARTICLE_SMOKE_FLAG) != 0) {
@@ -109,4 +106,14 @@ void particle_update(in out SimulatedVoxelParticle self, VoxelBufferPtrs voxels_
     }
 }
 
+void particle_update(in out SimulatedVoxelParticle self, VoxelBufferPtrs voxels_buffer_ptrs, daxa_BufferPtr(GpuInput) gpu_input, in out bool should_place) {
+    rand_seed(gl_GlobalInvocationID.x + uint((deref(gpu_input).time) * 13741));
+
+    // Steps at the fixed physics rate, as many steps as the player takes this frame, so particles
+    // move the same at any frame rate
+    for (daxa_u32 step_i = 0; step_i < deref(gpu_input).phys_step_n; ++step_i) {
+        particle_step(self, voxels_buffer_ptrs, GAME_PHYS_UPDATE_DT, should_place);
+    }
+}
+
 #endif
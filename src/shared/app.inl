@@ -78,9 +78,11 @@ daxa_RWBufferPtr(daxa_u32) data = push.uses.data;
 static_assert(IsVoxelWorld<VoxelWorld>);
 
 #include <minizip/unzip.h>
+#include <fstream>
+#include <cpu/startup_timer.hpp>
 
 inline void test_compute(RecordContext &record_ctx) {
-    auto test_buffer = record_ctx.task_graph.create_transient_buffer({
+    auto test_buffer = record_ctx.create_transient_buffer({
         .size = static_cast<daxa_u32>(sizeof(uint32_t) * 8 * 8 * 8 * 64 * 64 * 64),
         .name = "test_buffer",
     });
@@ -209,6 +211,18 @@ struct GpuApp : AppUi::DebugDisplayProvider {
     VoxelParticles particles;
 
     GpuResources gpu_resources;
+    StagingBufferPool staging_pool;
+    RenderTargetPool render_target_pool;
+    DynamicResolution dynamic_resolution;
+    RetiredObjects retired_objects;
+    GpuProfiler gpu_profiler;
+    std::vector<std::string> culled_passes;
+    // Latest GPU time of each task name (averaged over its instances in the frame). Culled tasks keep
+    // the time from when they last ran, which is what culling them saves.
+    std::unordered_map<std::string, daxa_f64> task_times;
+    std::vector<RecordContext::TransientInfo> transient_infos;
+    size_t transient_heap_size = 0;
+    size_t transient_unaliased_size = 0;
     daxa::BufferId prev_gvox_model_buffer{};
 
     daxa::TaskImage task_value_noise_image{{.name = "task_value_noise_image"}};
@@ -224,11 +238,29 @@ struct GpuApp : AppUi::DebugDisplayProvider {
     GpuInput gpu_input{};
     GpuOutput gpu_output{};
     std::vector<std::string> ui_strings;
+    // The tunables the current main task graph was recorded with
+    Tunables tunables{};
+
+    // Maintenance work is recorded into the main task graph behind permutation conditions,
+    // so none of it needs its own task graph or a separate submission.
+    enum class Conditions {
+        STARTUP,
+        UPLOADS,
+        DYNAMIC_BUFFERS_REALLOC,
+#if !IMMEDIATE_SKY
+        REGENERATE_SKY,
+#endif
+        COUNT,
+    };
+    std::array<bool, static_cast<size_t>(Conditions::COUNT)> condition_values{};
+    // One-shot transfers, recorded at the top of the next executed frame
+    std::vector<std::function<void(daxa::TaskInterface const &)>> pending_uploads;
 
     bool needs_vram_calc = true;
 
-    using Clock = std::chrono::high_resolution_clock;
-    Clock::time_point prev_phys_update_time = Clock::now();
+    size_t vram_usage = 0;
+    daxa_f32 phys_time_accumulator = 0.0f;
+    daxa_u64 phys_dropped_step_n = 0;
     daxa::Format swapchain_format;
 
     GpuApp(daxa::Device &device, daxa::Format a_swapchain_format)
@@ -236,6 +268,7 @@ struct GpuApp : AppUi::DebugDisplayProvider {
           gpu_resources{},
           swapchain_format{a_swapchain_format} {
 
+        gpu_profiler.create(device);
         sky.create(device);
         gpu_resources.create(device);
         voxel_world.create(device);
@@ -254,90 +287,65 @@ struct GpuApp : AppUi::DebugDisplayProvider {
         AppUi::DebugDisplay::s_instance->providers.push_back(&voxel_world);
 
         {
-            daxa::TaskGraph temp_task_graph = daxa::TaskGraph({
-                .device = device,
-                .name = "temp_task_graph",
-            });
-            temp_task_graph.use_persistent_image(task_blue_noise_vec2_image);
-            temp_task_graph.add_task({
-                .attachments = {
-                    daxa::inl_atch(daxa::TaskImageAccess::TRANSFER_WRITE, daxa::ImageViewType::REGULAR_2D, task_blue_noise_vec2_image),
-                },
-                .task = [this](daxa::TaskInterface const &ti) {
-                    auto staging_buffer = ti.device.create_buffer({
-                        .size = static_cast<daxa_u32>(128 * 128 * 4 * 64 * 1),
-                        .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
-                        .name = "staging_buffer",
-                    });
-                    auto *buffer_ptr = ti.device.get_host_address_as<uint8_t>(staging_buffer).value();
-                    auto *stbn_zip = unzOpen("assets/STBN.zip");
-                    for (auto i = 0; i < 64; ++i) {
-                        [[maybe_unused]] int err = 0;
-                        daxa_i32 size_x = 0;
-                        daxa_i32 size_y = 0;
-                        auto load_image = [&](char const *path, uint8_t *buffer_out_ptr) {
-                            err = unzLocateFile(stbn_zip, path, 1);
-                            assert(err == UNZ_OK);
-                            auto file_info = unz_file_info{};
-                            err = unzGetCurrentFileInfo(stbn_zip, &file_info, nullptr, 0, nullptr, 0, nullptr, 0);
-                            assert(err == UNZ_OK);
-                            auto file_data = std::vector<uint8_t>{};
-                            file_data.resize(file_info.uncompressed_size);
-                            err = unzOpenCurrentFile(stbn_zip);
-                            assert(err == UNZ_OK);
-                            err = unzReadCurrentFile(stbn_zip, file_data.data(), static_cast<uint32_t>(file_data.size()));
-                            assert(err == file_data.size());
-
-                            auto fi_mem = FreeImage_OpenMemory(file_data.data(), static_cast<DWORD>(file_data.size()));
-                            auto fi_file_desc = FreeImage_GetFileTypeFromMemory(fi_mem, 0);
-                            FIBITMAP *fi_bitmap = FreeImage_LoadFromMemory(fi_file_desc, fi_mem);
-                            FreeImage_CloseMemory(fi_mem);
-                            size_x = static_cast<int32_t>(FreeImage_GetWidth(fi_bitmap));
-                            size_y = static_cast<int32_t>(FreeImage_GetHeight(fi_bitmap));
-                            auto *temp_data = FreeImage_GetBits(fi_bitmap);
-                            assert(temp_data != nullptr && "Failed to load image");
-                            auto pixel_size = FreeImage_GetBPP(fi_bitmap);
-                            if (pixel_size != 32) {
-                                auto *temp = FreeImage_ConvertTo32Bits(fi_bitmap);
-                                FreeImage_Unload(fi_bitmap);
-                                fi_bitmap = temp;
-                            }
-
-                            if (temp_data != nullptr) {
-                                assert(size_x == 128 && size_y == 128);
-                                std::copy(temp_data + 0, temp_data + 128 * 128 * 4, buffer_out_ptr);
-                            }
-                            FreeImage_Unload(fi_bitmap);
-                        };
-                        auto vec2_name = std::string{"STBN/stbn_vec2_2Dx1D_128x128x64_"} + std::to_string(i) + ".png";
-                        load_image(vec2_name.c_str(), buffer_ptr + (128 * 128 * 4) * i + (128 * 128 * 4 * 64) * 0);
+            auto const phase = StartupTimer::Scope{"STBN decode"};
+            auto staging = staging_pool.acquire(device, size_t{128} * 128 * 4 * 64 * 1);
+            auto *buffer_ptr = staging.ptr;
+            auto *stbn_zip = unzOpen("assets/STBN.zip");
+            for (auto i = 0; i < 64; ++i) {
+                [[maybe_unused]] int err = 0;
+                daxa_i32 size_x = 0;
+                daxa_i32 size_y = 0;
+                auto load_image = [&](char const *path, uint8_t *buffer_out_ptr) {
+                    err = unzLocateFile(stbn_zip, path, 1);
+                    assert(err == UNZ_OK);
+                    auto file_info = unz_file_info{};
+                    err = unzGetCurrentFileInfo(stbn_zip, &file_info, nullptr, 0, nullptr, 0, nullptr, 0);
+                    assert(err == UNZ_OK);
+                    auto file_data = std::vector<uint8_t>{};
+                    file_data.resize(file_info.uncompressed_size);
+                    err = unzOpenCurrentFile(stbn_zip);
+                    assert(err == UNZ_OK);
+                    err = unzReadCurrentFile(stbn_zip, file_data.data(), static_cast<uint32_t>(file_data.size()));
+                    assert(err == file_data.size());
+
+                    auto fi_mem = FreeImage_OpenMemory(file_data.data(), static_cast<DWORD>(file_data.size()));
+                    auto fi_file_desc = FreeImage_GetFileTypeFromMemory(fi_mem, 0);
+                    FIBITMAP *fi_bitmap = FreeImage_LoadFromMemory(fi_file_desc, fi_mem);
+                    FreeImage_CloseMemory(fi_mem);
+                    size_x = static_cast<int32_t>(FreeImage_GetWidth(fi_bitmap));
+                    size_y = static_cast<int32_t>(FreeImage_GetHeight(fi_bitmap));
+                    auto *temp_data = FreeImage_GetBits(fi_bitmap);
+                    assert(temp_data != nullptr && "Failed to load image");
+                    auto pixel_size = FreeImage_GetBPP(fi_bitmap);
+                    if (pixel_size != 32) {
+                        auto *temp = FreeImage_ConvertTo32Bits(fi_bitmap);
+                        FreeImage_Unload(fi_bitmap);
+                        fi_bitmap = temp;
                     }
 
-                    ti.recorder.pipeline_barrier({
-                        .dst_access = daxa::AccessConsts::TRANSFER_WRITE,
-                    });
-                    ti.recorder.destroy_buffer_deferred(staging_buffer);
-                    ti.recorder.copy_buffer_to_image({
-                        .buffer = staging_buffer,
-                        .buffer_offset = (size_t{128} * 128 * 4 * 64) * 0,
-                        .image = task_blue_noise_vec2_image.get_state().images[0],
-                        .image_extent = {128, 128, 64},
-                    });
-                    needs_vram_calc = true;
-                },
-                .name = "upload_blue_noise",
+                    if (temp_data != nullptr) {
+                        assert(size_x == 128 && size_y == 128);
+                        std::copy(temp_data + 0, temp_data + 128 * 128 * 4, buffer_out_ptr);
+                    }
+                    FreeImage_Unload(fi_bitmap);
+                };
+                auto vec2_name = std::string{"STBN/stbn_vec2_2Dx1D_128x128x64_"} + std::to_string(i) + ".png";
+                load_image(vec2_name.c_str(), buffer_ptr + (128 * 128 * 4) * i + (128 * 128 * 4 * 64) * 0);
+            }
+
+            pending_uploads.push_back([this, staging](daxa::TaskInterface const &ti) {
+                staging_pool.release(staging);
+                ti.recorder.copy_buffer_to_image({
+                    .buffer = staging.buffer,
+                    .buffer_offset = (size_t{128} * 128 * 4 * 64) * 0,
+                    .image = task_blue_noise_vec2_image.get_state().images[0],
+                    .image_extent = {128, 128, 64},
+                });
+                needs_vram_calc = true;
             });
-            temp_task_graph.submit({});
-            temp_task_graph.complete({});
-            temp_task_graph.execute({});
         }
 
         {
-            daxa::TaskGraph temp_task_graph = daxa::TaskGraph({
-                .device = device,
-                .name = "temp_task_graph",
-            });
-
             auto texture_path = "assets/debug.png";
             auto fi_file_desc = FreeImage_GetFileType(texture_path, 0);
             FIBITMAP *fi_bitmap = FreeImage_Load(fi_file_desc, texture_path);
@@ -360,39 +368,21 @@ struct GpuApp : AppUi::DebugDisplayProvider {
                 .usage = daxa::ImageUsageFlagBits::SHADER_STORAGE | daxa::ImageUsageFlagBits::TRANSFER_DST | daxa::ImageUsageFlagBits::SHADER_SAMPLED,
                 .name = "debug_texture",
             });
-
             task_debug_texture.set_images({.images = std::array{gpu_resources.debug_texture}});
-            temp_task_graph.use_persistent_image(task_debug_texture);
-            temp_task_graph.add_task({
-                .attachments = {
-                    daxa::inl_atch(daxa::TaskImageAccess::TRANSFER_WRITE, daxa::ImageViewType::REGULAR_2D, task_debug_texture),
-                },
-                .task = [&, this](daxa::TaskInterface const &ti) {
-                    auto staging_buffer = ti.device.create_buffer({
-                        .size = size,
-                        .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
-                        .name = "staging_buffer",
-                    });
-                    auto *buffer_ptr = ti.device.get_host_address_as<uint8_t>(staging_buffer).value();
-                    std::copy(temp_data + 0, temp_data + size, buffer_ptr);
-                    FreeImage_Unload(fi_bitmap);
 
-                    ti.recorder.pipeline_barrier({
-                        .dst_access = daxa::AccessConsts::TRANSFER_WRITE,
-                    });
-                    ti.recorder.destroy_buffer_deferred(staging_buffer);
-                    ti.recorder.copy_buffer_to_image({
-                        .buffer = staging_buffer,
-                        .image = task_debug_texture.get_state().images[0],
-                        .image_extent = {static_cast<daxa_u32>(size_x), static_cast<daxa_u32>(size_y), 1},
-                    });
-                    needs_vram_calc = true;
-                },
-                .name = "upload_debug_texture",
+            auto staging = staging_pool.acquire(device, size);
+            std::copy(temp_data + 0, temp_data + size, staging.ptr);
+            FreeImage_Unload(fi_bitmap);
+
+            pending_uploads.push_back([this, staging, size_x, size_y](daxa::TaskInterface const &ti) {
+                staging_pool.release(staging);
+                ti.recorder.copy_buffer_to_image({
+                    .buffer = staging.buffer,
+                    .image = task_debug_texture.get_state().images[0],
+                    .image_extent = {static_cast<daxa_u32>(size_x), static_cast<daxa_u32>(size_y), 1},
+                });
+                needs_vram_calc = true;
             });
-            temp_task_graph.submit({});
-            temp_task_graph.complete({});
-            temp_task_graph.execute({});
         }
     }
     virtual ~GpuApp() override = default;
@@ -407,6 +397,12 @@ struct GpuApp : AppUi::DebugDisplayProvider {
             ImGui::Text("unit offs: %.2f, %.2f, %.2f", static_cast<double>(gpu_output.player_unit_offset.x), static_cast<double>(gpu_output.player_unit_offset.y), static_cast<double>(gpu_output.player_unit_offset.z));
             ImGui::TreePop();
         }
+        if (ImGui::TreeNode("Physics")) {
+            ImGui::Text("rate: %d Hz | max steps per frame: %d", GAME_PHYS_UPDATE_RATE, GAME_PHYS_MAX_STEPS_PER_FRAME);
+            ImGui::Text("steps this frame: %u | alpha: %.3f", gpu_input.phys_step_n, static_cast<double>(gpu_input.phys_alpha));
+            ImGui::Text("dropped steps: %llu", static_cast<unsigned long long>(phys_dropped_step_n));
+            ImGui::TreePop();
+        }
         if (ImGui::TreeNode("Auto-Exposure")) {
             ImGui::Text("Exposure multiple: %.2f", static_cast<double>(gpu_input.pre_exposure));
             auto hist_float = std::array<float, LUMINANCE_HISTOGRAM_BIN_COUNT>{};
@@ -432,10 +428,158 @@ struct GpuApp : AppUi::DebugDisplayProvider {
             ImGui::Text("first bin %d (%.2f) | last bin %d (%.2f)", first_bin_with_value, exp2(a), last_bin_with_value, exp2(b));
             ImGui::TreePop();
         }
+        if (ImGui::TreeNode("Pass Culling")) {
+            auto culled_counts = std::vector<std::pair<std::string, size_t>>{};
+            for (auto const &name : culled_passes) {
+                auto iter = std::find_if(culled_counts.begin(), culled_counts.end(), [&](auto const &count) { return count.first == name; });
+                if (iter == culled_counts.end()) {
+                    culled_counts.push_back({name, 1});
+                } else {
+                    ++iter->second;
+                }
+            }
+            auto saved_time = 0.0;
+            auto unmeasured_n = size_t{0};
+            for (auto const &[name, count] : culled_counts) {
+                if (auto iter = task_times.find(name); iter != task_times.end()) {
+                    saved_time += iter->second * static_cast<daxa_f64>(count);
+                } else {
+                    unmeasured_n += count;
+                }
+            }
+            ImGui::Text("culled tasks: %zu | est. GPU time saved: %.3f ms", culled_passes.size(), saved_time);
+            if (unmeasured_n != 0) {
+                ImGui::TextDisabled("%zu never ran, so they're left out of the estimate", unmeasured_n);
+            }
+            for (auto const &[name, count] : culled_counts) {
+                if (auto iter = task_times.find(name); iter != task_times.end()) {
+                    ImGui::BulletText("%s x%zu: %.3f ms", name.c_str(), count, iter->second * static_cast<daxa_f64>(count));
+                } else {
+                    ImGui::BulletText("%s x%zu: - ms", name.c_str(), count);
+                }
+            }
+            ImGui::TreePop();
+        }
+        if (ImGui::TreeNode("Transient Memory")) {
+            auto saved_size = transient_unaliased_size > transient_heap_size ? transient_unaliased_size - transient_heap_size : size_t{0};
+            ImGui::Text("heap: %.2f MB | unaliased: %.2f MB | saved: %.2f MB", static_cast<double>(transient_heap_size) / 1000000.0, static_cast<double>(transient_unaliased_size) / 1000000.0, static_cast<double>(saved_size) / 1000000.0);
+            if (ImGui::Button("Dump Report")) {
+                dump_transient_report("transient_report.txt");
+            }
+            if (ImGui::BeginTable("##transient_infos", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollY, ImVec2(0.0f, 200.0f))) {
+                ImGui::TableSetupColumn("Name");
+                ImGui::TableSetupColumn("Size (MB)");
+                ImGui::TableSetupColumn("Tasks");
+                ImGui::TableHeadersRow();
+                for (auto const &info : transient_infos) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%s", info.name.c_str());
+                    ImGui::TableNextColumn();
+                    if (info.size == 0) {
+                        ImGui::TextDisabled("unknown");
+                    } else {
+                        ImGui::Text("%.2f", static_cast<double>(info.size) / 1000000.0);
+                    }
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%u..%u", info.first_task, info.last_task);
+                }
+                ImGui::EndTable();
+            }
+            ImGui::TreePop();
+        }
+        if (ImGui::TreeNode("Dynamic Resolution")) {
+            ImGui::Text("scale: %.2f | GPU frame time: %.2f ms", static_cast<double>(dynamic_resolution.scale), static_cast<double>(dynamic_resolution.smoothed_frame_time) * 1000.0);
+            ImGui::Text("frame_dim: %u x %u", gpu_input.frame_dim.x, gpu_input.frame_dim.y);
+            ImGui::TreePop();
+        }
+        if (ImGui::TreeNode("Render Target Pool")) {
+            ImGui::Text("allocated: %.2f MB | free: %.2f MB", static_cast<double>(render_target_pool.allocated_size) / 1000000.0, static_cast<double>(render_target_pool.free_size) / 1000000.0);
+            ImGui::Text("free images: %zu | pending: %zu", render_target_pool.free_images.size(), render_target_pool.pending_images.size());
+            ImGui::Text("hits: %llu | misses: %llu | evictions: %llu", static_cast<unsigned long long>(render_target_pool.hit_n), static_cast<unsigned long long>(render_target_pool.miss_n), static_cast<unsigned long long>(render_target_pool.evict_n));
+            ImGui::TreePop();
+        }
+        if (ImGui::TreeNode("GPU Profiler")) {
+            ImGui::Text("frame: %.3f ms | zones: %zu", gpu_profiler.frame_time, gpu_profiler.zone_results.size());
+            if (ImGui::Button("Export Chrome Trace")) {
+                auto const trace_path = std::filesystem::path{"gpu_trace.json"};
+                if (gpu_profiler.write_chrome_trace(trace_path)) {
+                    AppUi::Console::s_instance->add_log(fmt::format("Wrote GPU trace to {}", std::filesystem::absolute(trace_path).string()));
+                }
+            }
+            // Timeline of the zones, scaled to the width of the window
+            auto const timeline_height = 24.0f;
+            auto const timeline_pos = ImGui::GetCursorScreenPos();
+            auto const timeline_width = std::max(ImGui::GetContentRegionAvail().x, 1.0f);
+            auto *draw_list = ImGui::GetWindowDrawList();
+            draw_list->AddRectFilled(timeline_pos, ImVec2(timeline_pos.x + timeline_width, timeline_pos.y + timeline_height), IM_COL32(32, 32, 32, 255));
+            auto const ms_to_px = gpu_profiler.frame_time > 0.0 ? static_cast<double>(timeline_width) / gpu_profiler.frame_time : 0.0;
+            for (size_t i = 0; i < gpu_profiler.zone_results.size(); ++i) {
+                auto const &zone = gpu_profiler.zone_results[i];
+                auto const x0 = timeline_pos.x + static_cast<float>(zone.start * ms_to_px);
+                auto const x1 = std::max(timeline_pos.x + static_cast<float>((zone.start + zone.duration) * ms_to_px), x0 + 1.0f);
+                auto const hue = static_cast<float>(i * 37 % 360) / 360.0f;
+                draw_list->AddRectFilled(ImVec2(x0, timeline_pos.y), ImVec2(x1, timeline_pos.y + timeline_height), ImColor::HSV(hue, 0.6f, 0.8f));
+                if (ImGui::IsMouseHoveringRect(ImVec2(x0, timeline_pos.y), ImVec2(x1, timeline_pos.y + timeline_height))) {
+                    ImGui::SetTooltip("%s: %.3f ms", zone.name.c_str(), zone.duration);
+                }
+            }
+            ImGui::Dummy(ImVec2(timeline_width, timeline_height));
+            if (ImGui::BeginTable("##gpu_zones", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollY | ImGuiTableFlags_Sortable, ImVec2(0.0f, 300.0f))) {
+                ImGui::TableSetupColumn("Name");
+                ImGui::TableSetupColumn("Start (ms)", ImGuiTableColumnFlags_DefaultSort);
+                ImGui::TableSetupColumn("Duration (ms)", ImGuiTableColumnFlags_PreferSortDescending);
+                ImGui::TableHeadersRow();
+                auto zones = gpu_profiler.zone_results;
+                if (auto *sort_specs = ImGui::TableGetSortSpecs(); sort_specs != nullptr && sort_specs->SpecsCount > 0) {
+                    auto const &spec = sort_specs->Specs[0];
+                    std::sort(zones.begin(), zones.end(), [&spec](auto const &a, auto const &b) {
+                        auto const less = spec.ColumnIndex == 0   ? a.name < b.name
+                                          : spec.ColumnIndex == 1 ? a.start < b.start
+                                                                  : a.duration < b.duration;
+                        auto const greater = spec.ColumnIndex == 0   ? b.name < a.name
+                                             : spec.ColumnIndex == 1 ? b.start < a.start
+                                                                     : b.duration < a.duration;
+                        return spec.SortDirection == ImGuiSortDirection_Ascending ? less : greater;
+                    });
+                }
+                for (auto const &zone : zones) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%s", zone.name.c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", zone.start);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", zone.duration);
+                }
+                ImGui::EndTable();
+            }
+            ImGui::TreePop();
+        }
+        if (ImGui::TreeNode("Staging Pool")) {
+            ImGui::Text("allocated: %.2f MB | free: %.2f MB", static_cast<double>(staging_pool.allocated_size) / 1000000.0, static_cast<double>(staging_pool.free_size) / 1000000.0);
+            ImGui::Text("high water: %.2f MB", static_cast<double>(staging_pool.high_water_size) / 1000000.0);
+            ImGui::Text("hits: %llu | misses: %llu", static_cast<unsigned long long>(staging_pool.hit_n), static_cast<unsigned long long>(staging_pool.miss_n));
+            ImGui::TreePop();
+        }
+    }
+
+    void dump_transient_report(std::filesystem::path const &filepath) {
+        auto f = std::ofstream(filepath);
+        f << fmt::format("heap: {} bytes\nunaliased: {} bytes\n\n", transient_heap_size, transient_unaliased_size);
+        f << "type, name, size, first_task, last_task\n";
+        for (auto const &info : transient_infos) {
+            f << fmt::format("{}, {}, {}, {}, {}\n", info.type, info.name, info.size == 0 ? std::string{"unknown"} : std::to_string(info.size), info.first_task, info.last_task);
+        }
+        AppUi::Console::s_instance->add_log(fmt::format("Wrote transient report to {}", std::filesystem::absolute(filepath).string()));
     }
 
     void destroy(daxa::Device &device) {
+        retired_objects.clear();
+        gpu_profiler.destroy();
         sky.destroy(device);
+        staging_pool.destroy(device);
+        render_target_pool.destroy(device);
         gpu_resources.destroy(device);
         voxel_world.destroy(device);
         particles.destroy(device);
@@ -503,9 +647,15 @@ struct GpuApp : AppUi::DebugDisplayProvider {
                 .size = size,
             });
             result_size += size;
+            transient_heap_size = size;
+            transient_unaliased_size = 0;
+            for (auto const &info : transient_infos) {
+                transient_unaliased_size += info.size;
+            }
         }
 
         needs_vram_calc = false;
+        vram_usage = result_size;
 
         ui_strings.push_back(fmt::format("Est. VRAM usage: {} MB", static_cast<float>(result_size) / 1000000));
     }
@@ -526,60 +676,95 @@ struct GpuApp : AppUi::DebugDisplayProvider {
         gpu_input.pre_exposure_prev = post_processor.exposure_state.pre_mult_prev;
         gpu_input.pre_exposure_delta = post_processor.exposure_state.pre_mult_delta;
 
-        if constexpr (!ENABLE_TAA) {
+        if (!tunables.enable_taa) {
             fsr2_renderer->next_frame();
             fsr2_renderer->state.delta_time = gpu_input.delta_time;
+            fsr2_renderer->state.render_size = gpu_input.frame_dim;
             gpu_input.halton_jitter = fsr2_renderer->state.jitter;
         }
 
-        auto now = Clock::now();
-        if (now - prev_phys_update_time > std::chrono::duration<float>(GAME_PHYS_UPDATE_DT)) {
+        phys_time_accumulator += gpu_input.delta_time;
+        auto phys_step_n = static_cast<daxa_u32>(phys_time_accumulator / GAME_PHYS_UPDATE_DT);
+        if (phys_step_n > GAME_PHYS_MAX_STEPS_PER_FRAME) {
+            phys_dropped_step_n += phys_step_n - GAME_PHYS_MAX_STEPS_PER_FRAME;
+            phys_step_n = GAME_PHYS_MAX_STEPS_PER_FRAME;
+            phys_time_accumulator = std::fmod(phys_time_accumulator, GAME_PHYS_UPDATE_DT);
+        } else {
+            phys_time_accumulator -= static_cast<daxa_f32>(phys_step_n) * GAME_PHYS_UPDATE_DT;
+        }
+        gpu_input.phys_step_n = phys_step_n;
+        gpu_input.phys_alpha = std::clamp(phys_time_accumulator / GAME_PHYS_UPDATE_DT, 0.0f, 1.0f);
+        if (phys_step_n != 0) {
             gpu_input.flags |= GAME_FLAG_BITS_NEEDS_PHYS_UPDATE;
-            prev_phys_update_time = now;
         }
 
         if (needs_vram_calc) {
             calc_vram_usage(device, task_graph);
         }
 
-        bool should_realloc = voxel_world.check_for_realloc(device, gpu_output.voxel_world);
-
-        if (should_realloc) {
-            dynamic_buffers_realloc(device);
-        }
+        condition_values[static_cast<size_t>(Conditions::STARTUP)] = ui.should_run_startup;
+        condition_values[static_cast<size_t>(Conditions::UPLOADS)] = !pending_uploads.empty();
+        condition_values[static_cast<size_t>(Conditions::DYNAMIC_BUFFERS_REALLOC)] = voxel_world.check_for_realloc(device, gpu_output.voxel_world);
+#if !IMMEDIATE_SKY
+        condition_values[static_cast<size_t>(Conditions::REGENERATE_SKY)] = ui.should_regenerate_sky;
+#endif
     }
 
     void end_frame(AppUi &ui) {
+        if (gpu_profiler.has_new_results) {
+            auto frame_task_times = std::unordered_map<std::string, std::pair<daxa_f64, daxa_u32>>{};
+            for (auto const &zone : gpu_profiler.zone_results) {
+                auto &[total, count] = frame_task_times[zone.name];
+                total += zone.duration;
+                ++count;
+            }
+            for (auto const &[name, time] : frame_task_times) {
+                task_times[name] = time.first / static_cast<daxa_f64>(time.second);
+            }
+        }
         gbuffer_renderer.next_frame();
         ssao_renderer.next_frame();
         post_processor.next_frame(ui.settings.auto_exposure, gpu_input.delta_time);
-        if constexpr (ENABLE_TAA) {
+        if (tunables.enable_taa) {
             taa_renderer.next_frame();
         }
         shadow_denoiser.next_frame();
     }
 
-    void dynamic_buffers_realloc(daxa::Device &device) {
-        auto temp_task_graph = daxa::TaskGraph({
-            .device = device,
-            .name = "temp_task_graph",
+    void record_uploads(RecordContext &record_ctx) {
+        record_ctx.add_task({
+            .attachments = {
+                daxa::inl_atch(daxa::TaskImageAccess::TRANSFER_WRITE, daxa::ImageViewType::REGULAR_2D, task_value_noise_image.view().view({.layer_count = 256})),
+                daxa::inl_atch(daxa::TaskImageAccess::TRANSFER_WRITE, daxa::ImageViewType::REGULAR_2D, task_blue_noise_vec2_image),
+                daxa::inl_atch(daxa::TaskImageAccess::TRANSFER_WRITE, daxa::ImageViewType::REGULAR_2D, task_debug_texture),
+                daxa::inl_atch(daxa::TaskBufferAccess::TRANSFER_WRITE, task_gvox_model_buffer),
+            },
+            .task = [this](daxa::TaskInterface const &ti) {
+                for (auto const &upload : pending_uploads) {
+                    upload(ti);
+                }
+                pending_uploads.clear();
+            },
+            .name = "Uploads",
         });
-
-        voxel_world.dynamic_buffers_realloc(temp_task_graph, needs_vram_calc);
-
-        temp_task_graph.submit({});
-        temp_task_graph.complete({});
-        temp_task_graph.execute({});
     }
 
+    // Startup Task (Globals Clear):
+    // Clear task_globals_buffer
+    // Clear task_temp_voxel_chunks_buffer
+    // Clear task_voxel_chunks_buffer
+    // Clear task_voxel_malloc_pages_buffer (x3)
+    //
+    // GPU Task:
+    // startup.comp.glsl (Run on 1 thread)
+    //
+    // Initialize Task:
+    // init VoxelMallocPageAllocator buffer
+    //
+    // Expects the persistent resources to already be in use by the task graph
     void record_startup(RecordContext &record_ctx) {
-        record_ctx.task_graph.use_persistent_buffer(task_input_buffer);
-        record_ctx.task_graph.use_persistent_buffer(task_globals_buffer);
-
-        voxel_world.use_buffers(record_ctx);
-
         voxel_world.record_startup(record_ctx);
-        record_ctx.task_graph.add_task({
+        record_ctx.add_task({
             .attachments = {
                 daxa::inl_atch(daxa::TaskBufferAccess::TRANSFER_WRITE, task_globals_buffer),
             },
@@ -610,6 +795,8 @@ struct GpuApp : AppUi::DebugDisplayProvider {
     }
 
     void record_frame(RecordContext &record_ctx) {
+        tunables = record_ctx.tunables;
+
         record_ctx.task_graph.use_persistent_image(task_value_noise_image);
         record_ctx.task_graph.use_persistent_image(task_blue_noise_vec2_image);
         record_ctx.task_graph.use_persistent_image(task_debug_texture);
@@ -628,31 +815,46 @@ struct GpuApp : AppUi::DebugDisplayProvider {
         record_ctx.task_input_buffer = task_input_buffer;
         record_ctx.task_globals_buffer = task_globals_buffer;
 
+        record_ctx.task_graph.conditional({
+            .condition_index = static_cast<daxa_u32>(Conditions::DYNAMIC_BUFFERS_REALLOC),
+            .when_true = [&]() { voxel_world.dynamic_buffers_realloc(record_ctx.task_graph, needs_vram_calc); },
+        });
+        record_ctx.task_graph.conditional({
+            .condition_index = static_cast<daxa_u32>(Conditions::STARTUP),
+            .when_true = [&]() { record_startup(record_ctx); },
+        });
+        record_ctx.task_graph.conditional({
+            .condition_index = static_cast<daxa_u32>(Conditions::UPLOADS),
+            .when_true = [&]() { record_uploads(record_ctx); },
+        });
+
 #if IMMEDIATE_SKY
         auto [sky_lut, transmittance_lut, sky_cube, ibl_cube] = generate_procedural_sky(record_ctx);
 #else
         sky.use_images(record_ctx);
+        record_ctx.task_graph.conditional({
+            .condition_index = static_cast<daxa_u32>(Conditions::REGENERATE_SKY),
+            .when_true = [&]() { sky.render(record_ctx, generate_procedural_sky(record_ctx)); },
+        });
         auto sky_cube = sky.task_sky_cube.view().view({.layer_count = 6});
         auto ibl_cube = sky.task_ibl_cube.view().view({.layer_count = 6});
 #endif
         AppUi::DebugDisplay::s_instance->passes.push_back({.name = "sky_cube", .task_image_id = sky_cube, .type = DEBUG_IMAGE_TYPE_CUBEMAP});
         AppUi::DebugDisplay::s_instance->passes.push_back({.name = "ibl_cube", .task_image_id = ibl_cube, .type = DEBUG_IMAGE_TYPE_CUBEMAP});
 
-        record_ctx.task_graph.add_task({
+        // From here until the output is picked, tasks whose outputs nothing reads are culled
+        record_ctx.begin_culling();
+
+        record_ctx.add_task({
             .attachments = {
                 daxa::inl_atch(daxa::TaskBufferAccess::TRANSFER_WRITE, task_input_buffer),
             },
             .task = [this](daxa::TaskInterface const &ti) {
-                auto staging_input_buffer = ti.device.create_buffer({
-                    .size = sizeof(GpuInput),
-                    .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
-                    .name = "staging_input_buffer",
-                });
-                ti.recorder.destroy_buffer_deferred(staging_input_buffer);
-                auto *buffer_ptr = ti.device.get_host_address_as<GpuInput>(staging_input_buffer).value();
-                *buffer_ptr = gpu_input;
+                auto staging = staging_pool.acquire(ti.device, sizeof(GpuInput));
+                staging_pool.release(staging);
+                *reinterpret_cast<GpuInput *>(staging.ptr) = gpu_input;
                 ti.recorder.copy_buffer_to_buffer({
-                    .src_buffer = staging_input_buffer,
+                    .src_buffer = staging.buffer,
                     .dst_buffer = task_input_buffer.get_state().buffers[0],
                     .size = sizeof(GpuInput),
                 });
@@ -687,17 +889,17 @@ struct GpuApp : AppUi::DebugDisplayProvider {
         auto shadow_mask = trace_shadows(record_ctx, gbuffer_depth, voxel_world.buffers);
         auto denoised_shadow_mask = shadow_denoiser.denoise_shadow_mask(record_ctx, gbuffer_depth, shadow_mask, reprojection_map);
 
-        auto rtr = record_ctx.task_graph.create_transient_image({
+        auto rtr = record_ctx.create_transient_image({
             .format = daxa::Format::R16G16B16A16_SFLOAT,
             .size = {record_ctx.render_resolution.x, record_ctx.render_resolution.y, 1},
             .name = "rtr",
         });
-        auto rtdgi = record_ctx.task_graph.create_transient_image({
+        auto rtdgi = record_ctx.create_transient_image({
             .format = daxa::Format::R16G16B16A16_SFLOAT,
             .size = {record_ctx.render_resolution.x, record_ctx.render_resolution.y, 1},
             .name = "rtdgi",
         });
-        clear_task_images(record_ctx.task_graph, std::array<daxa::TaskImageView, 2>{rtr, rtdgi});
+        clear_task_images(record_ctx, std::array<daxa::TaskImageView, 2>{rtr, rtdgi});
 
         auto debug_out_tex = light_gbuffer(
             record_ctx,
@@ -711,10 +913,17 @@ struct GpuApp : AppUi::DebugDisplayProvider {
             ibl_cube,
             sky_lut,
             transmittance_lut);
-        fsr2_renderer = std::make_unique<Fsr2Renderer>(record_ctx.device, Fsr2Info{.render_resolution = record_ctx.render_resolution, .display_resolution = record_ctx.output_resolution});
+        if (!fsr2_renderer ||
+            fsr2_renderer->info.render_resolution.x != record_ctx.render_resolution.x || fsr2_renderer->info.render_resolution.y != record_ctx.render_resolution.y ||
+            fsr2_renderer->info.display_resolution.x != record_ctx.output_resolution.x || fsr2_renderer->info.display_resolution.y != record_ctx.output_resolution.y) {
+            if (fsr2_renderer) {
+                retired_objects.retire(std::move(fsr2_renderer));
+            }
+            fsr2_renderer = std::make_unique<Fsr2Renderer>(record_ctx.device, Fsr2Info{.render_resolution = record_ctx.render_resolution, .display_resolution = record_ctx.output_resolution});
+        }
 
         auto antialiased_image = [&]() {
-            if constexpr (ENABLE_TAA) {
+            if (tunables.enable_taa) {
                 return taa_renderer.render(record_ctx, debug_out_tex, gbuffer_depth.depth.task_resources.output_resource, reprojection_map);
             } else {
                 return fsr2_renderer->upscale(record_ctx, gbuffer_depth, debug_out_tex, reprojection_map);
@@ -733,7 +942,9 @@ struct GpuApp : AppUi::DebugDisplayProvider {
             debug_pass(record_ctx, *pass_iter, record_ctx.task_swapchain_image, swapchain_format);
         }
 
-        record_ctx.task_graph.add_task({
+        culled_passes = record_ctx.cull_unused_tasks();
+
+        record_ctx.add_task({
             .attachments = {
                 daxa::inl_atch(daxa::TaskBufferAccess::TRANSFER_READ, task_output_buffer),
                 daxa::inl_atch(daxa::TaskBufferAccess::HOST_TRANSFER_WRITE, task_staging_output_buffer),
@@ -756,6 +967,7 @@ struct GpuApp : AppUi::DebugDisplayProvider {
 
         // test_compute(record_ctx);
 
+        transient_infos = std::move(record_ctx.transient_infos);
         needs_vram_calc = true;
     }
 };
@@ -27,6 +27,7 @@ struct Player {
     Camera cam;
     daxa_f32vec3 pos; // Player (mod 1) position centered around 0.5 [0-1] (in meters)
     daxa_f32vec3 vel;
+    daxa_f32vec3 prev_pos; // Position before the last physics step, relative to the same unit offset as `pos`
     daxa_f32 pitch, yaw, roll;
     daxa_f32vec3 forward, lateral;
     daxa_i32vec3 player_unit_offset;
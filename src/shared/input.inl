@@ -24,11 +24,15 @@
 
 #define GAME_FLAGS_PAUSED 0
 #define GAME_FLAGS_NEEDS_PHYS_UPDATE 1
+#define GAME_FLAGS_SCRIPTED_CAMERA 2
 #define GAME_FLAG_BITS_PAUSED (daxa_u32(1) << GAME_FLAGS_PAUSED)
 #define GAME_FLAG_BITS_NEEDS_PHYS_UPDATE (daxa_u32(1) << GAME_FLAGS_NEEDS_PHYS_UPDATE)
+#define GAME_FLAG_BITS_SCRIPTED_CAMERA (daxa_u32(1) << GAME_FLAGS_SCRIPTED_CAMERA)
 
 #define GAME_PHYS_UPDATE_RATE 64
 #define GAME_PHYS_UPDATE_DT (1.0f / GAME_PHYS_UPDATE_RATE)
+// Past this, the simulation slows down instead of taking ever longer frames to catch up
+#define GAME_PHYS_MAX_STEPS_PER_FRAME 8
 // clang-format on
 
 struct MouseInput {
@@ -54,6 +58,12 @@ struct GpuInput {
     daxa_u32 flags;
     daxa_f32 time;
     daxa_f32 delta_time;
+    daxa_u32 phys_step_n;
+    daxa_f32 phys_alpha;
+    daxa_u32 chunk_updates_per_frame;
+    // Used instead of player movement when GAME_FLAG_BITS_SCRIPTED_CAMERA is set
+    daxa_f32vec3 scripted_cam_pos;
+    daxa_f32vec3 scripted_cam_rot; // yaw, pitch, roll
     daxa_SamplerId sampler_nnc;
     daxa_SamplerId sampler_lnc;
     daxa_SamplerId sampler_llc;
@@ -65,7 +65,7 @@ inline auto blur_pyramid(RecordContext &record_ctx, daxa::TaskImageView input_im
     image_size = {(image_size.x + 1) / 2, (image_size.y + 1) / 2};
     auto mip_count = ceil_log2(std::max(image_size.x, image_size.y)) - 1;
 
-    auto output = record_ctx.task_graph.create_transient_image({
+    auto output = record_ctx.create_transient_image({
         .format = daxa::Format::B10G11R11_UFLOAT_PACK32,
         .size = {image_size.x, image_size.y, 1},
         .mip_level_count = mip_count,
@@ -119,7 +119,7 @@ inline auto rev_blur_pyramid(RecordContext &record_ctx, daxa::TaskImageView inpu
     image_size = {(image_size.x + 1) / 2, (image_size.y + 1) / 2};
     auto mip_count = ceil_log2(std::max(image_size.x, image_size.y)) - 1;
 
-    auto output = record_ctx.task_graph.create_transient_image({
+    auto output = record_ctx.create_transient_image({
         .format = daxa::Format::B10G11R11_UFLOAT_PACK32,
         .size = {image_size.x, image_size.y, 1},
         .mip_level_count = mip_count,
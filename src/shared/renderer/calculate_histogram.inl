@@ -33,12 +33,12 @@ inline auto calculate_luminance_histogram(RecordContext &record_ctx, daxa::TaskI
     auto input_mip_level = std::max(mip_count, 7u) - 7;
 
     auto hist_size = static_cast<uint32_t>(sizeof(uint32_t) * LUMINANCE_HISTOGRAM_BIN_COUNT);
-    auto tmp_histogram = record_ctx.task_graph.create_transient_buffer({
+    auto tmp_histogram = record_ctx.create_transient_buffer({
         .size = static_cast<uint32_t>(sizeof(uint32_t) * LUMINANCE_HISTOGRAM_BIN_COUNT),
         .name = "tmp_histogram",
     });
 
-    record_ctx.task_graph.add_task({
+    record_ctx.add_task({
         .attachments = {
             daxa::inl_atch(daxa::TaskBufferAccess::TRANSFER_WRITE, tmp_histogram),
         },
@@ -76,7 +76,7 @@ inline auto calculate_luminance_histogram(RecordContext &record_ctx, daxa::TaskI
         },
     });
 
-    record_ctx.task_graph.add_task({
+    record_ctx.add_task({
         .attachments = {
             daxa::inl_atch(daxa::TaskBufferAccess::TRANSFER_READ, tmp_histogram),
             daxa::inl_atch(daxa::TaskBufferAccess::TRANSFER_WRITE, dst_histogram),
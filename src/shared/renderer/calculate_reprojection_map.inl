@@ -30,7 +30,7 @@ daxa_ImageViewId dst_image_id = push.uses.dst_image_id;
 #if defined(__cplusplus)
 
 inline auto calculate_reprojection_map(RecordContext &record_ctx, GbufferDepth const &gbuffer_depth, daxa::TaskImageView velocity_image) -> daxa::TaskImageView {
-    auto reprojection_map = record_ctx.task_graph.create_transient_image({
+    auto reprojection_map = record_ctx.create_transient_image({
         .format = daxa::Format::R16G16B16A16_SFLOAT,
         .size = {record_ctx.render_resolution.x, record_ctx.render_resolution.y, 1},
         .name = "reprojection_image",
@@ -50,7 +50,8 @@ inline auto calculate_reprojection_map(RecordContext &record_ctx, GbufferDepth c
             auto const image_info = ti.device.info_image(ti.get(CalculateReprojectionMapCompute::dst_image_id).ids[0]).value();
             ti.recorder.set_pipeline(pipeline);
             set_push_constant(ti, push);
-            ti.recorder.dispatch({(image_info.size.x + 7) / 8, (image_info.size.y + 7) / 8});
+            auto const extent = active_render_extent(image_info.size);
+            ti.recorder.dispatch({(extent.x + 7) / 8, (extent.y + 7) / 8});
         },
     });
     AppUi::DebugDisplay::s_instance->passes.push_back({.name = "reprojection_map", .task_image_id = reprojection_map, .type = DEBUG_IMAGE_TYPE_DEFAULT});
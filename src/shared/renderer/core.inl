@@ -36,14 +36,14 @@ struct GbufferDepth {
 
 namespace {
     template <size_t N>
-    inline void clear_task_images(daxa::TaskGraph &task_graph, std::array<daxa::TaskImageView, N> const &task_image_views) {
+    inline auto clear_task_images_info(std::array<daxa::TaskImageView, N> const &task_image_views) -> daxa::InlineTaskInfo {
         auto uses = std::vector<daxa::TaskAttachmentInfo>{};
         auto use_count = task_image_views.size();
         uses.reserve(use_count);
         for (auto const &task_image : task_image_views) {
             uses.push_back(daxa::inl_atch(daxa::TaskImageAccess::TRANSFER_WRITE, daxa::ImageViewType::REGULAR_2D, task_image));
         }
-        task_graph.add_task({
+        return {
             .attachments = std::move(uses),
             .task = [use_count](daxa::TaskInterface const &ti) {
                 for (uint8_t i = 0; i < use_count; ++i) {
@@ -54,7 +54,15 @@ namespace {
                 }
             },
             .name = "clear images",
-        });
+        };
+    }
+    template <size_t N>
+    inline void clear_task_images(daxa::TaskGraph &task_graph, std::array<daxa::TaskImageView, N> const &task_image_views) {
+        task_graph.add_task(clear_task_images_info(task_image_views));
+    }
+    template <size_t N>
+    inline void clear_task_images(RecordContext &record_ctx, std::array<daxa::TaskImageView, N> const &task_image_views) {
+        record_ctx.add_task(clear_task_images_info(task_image_views));
     }
     template <size_t N>
     inline void clear_task_images(daxa::Device &device, std::array<daxa::TaskImage, N> const &task_images) {
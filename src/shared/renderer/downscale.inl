@@ -26,9 +26,9 @@ daxa_ImageViewId dst_image_id = push.uses.dst_image_id;
 inline auto extract_downscaled_depth(RecordContext &record_ctx, daxa::TaskImageView depth) -> daxa::TaskImageView {
     auto size = record_ctx.render_resolution;
 
-    auto output_tex = record_ctx.task_graph.create_transient_image({
+    auto output_tex = record_ctx.create_transient_image({
         .format = daxa::Format::R32_SFLOAT,
-        .size = {size.x / SHADING_SCL, size.y / SHADING_SCL, 1},
+        .size = {size.x / record_ctx.tunables.shading_scl, size.y / record_ctx.tunables.shading_scl, 1},
         .name = "downscaled_depth",
     });
 
@@ -45,7 +45,8 @@ inline auto extract_downscaled_depth(RecordContext &record_ctx, daxa::TaskImageV
             auto const image_info = ti.device.info_image(ti.get(DownscaleCompute::dst_image_id).ids[0]).value();
             ti.recorder.set_pipeline(pipeline);
             set_push_constant(ti, push);
-            ti.recorder.dispatch({(image_info.size.x + 7) / 8, (image_info.size.y + 7) / 8});
+            auto const extent = active_render_extent(image_info.size);
+            ti.recorder.dispatch({(extent.x + 7) / 8, (extent.y + 7) / 8});
         },
     });
 
@@ -55,9 +56,9 @@ inline auto extract_downscaled_depth(RecordContext &record_ctx, daxa::TaskImageV
 inline auto extract_downscaled_gbuffer_view_normal_rgba8(RecordContext &record_ctx, daxa::TaskImageView gbuffer) -> daxa::TaskImageView {
     auto size = record_ctx.render_resolution;
 
-    auto output_tex = record_ctx.task_graph.create_transient_image({
+    auto output_tex = record_ctx.create_transient_image({
         .format = daxa::Format::R8G8B8A8_SNORM,
-        .size = {size.x / SHADING_SCL, size.y / SHADING_SCL, 1},
+        .size = {size.x / record_ctx.tunables.shading_scl, size.y / record_ctx.tunables.shading_scl, 1},
         .name = "downscaled_gbuffer_view_normal",
     });
 
@@ -74,7 +75,8 @@ inline auto extract_downscaled_gbuffer_view_normal_rgba8(RecordContext &record_c
             auto const image_info = ti.device.info_image(ti.get(DownscaleCompute::dst_image_id).ids[0]).value();
             ti.recorder.set_pipeline(pipeline);
             set_push_constant(ti, push);
-            ti.recorder.dispatch({(image_info.size.x + 7) / 8, (image_info.size.y + 7) / 8});
+            auto const extent = active_render_extent(image_info.size);
+            ti.recorder.dispatch({(extent.x + 7) / 8, (extent.y + 7) / 8});
         },
     });
 
@@ -50,13 +50,13 @@ void Fsr2Renderer::next_frame() {
 }
 
 auto Fsr2Renderer::upscale(RecordContext &record_ctx, GbufferDepth const &gbuffer_depth, daxa::TaskImageView color_image, daxa::TaskImageView velocity_image) -> daxa::TaskImageView {
-    auto output_image = record_ctx.task_graph.create_transient_image({
+    auto output_image = record_ctx.create_transient_image({
         .format = daxa::Format::R16G16B16A16_SFLOAT,
         .size = {record_ctx.output_resolution.x, record_ctx.output_resolution.y, 1},
         .name = "fsr2_output_image",
     });
     auto depth_image = gbuffer_depth.depth.task_resources.output_resource.view();
-    record_ctx.task_graph.add_task({
+    record_ctx.add_task({
         .attachments = {
             daxa::inl_atch(daxa::TaskImageAccess::COMPUTE_SHADER_SAMPLED, daxa::ImageViewType::REGULAR_2D, color_image),
             daxa::inl_atch(daxa::TaskImageAccess::COMPUTE_SHADER_SAMPLED, daxa::ImageViewType::REGULAR_2D, depth_image),
@@ -133,8 +133,8 @@ auto Fsr2Renderer::upscale(RecordContext &record_ctx, GbufferDepth const &gbuffe
             dispatch_description.sharpness = state.sharpening;
             dispatch_description.frameTimeDelta = state.delta_time * 1000.0f;
             dispatch_description.preExposure = 1.0f;
-            dispatch_description.renderSize.width = color_extent.x;
-            dispatch_description.renderSize.height = color_extent.y;
+            dispatch_description.renderSize.width = state.render_size.x != 0 ? std::min(state.render_size.x, color_extent.x) : color_extent.x;
+            dispatch_description.renderSize.height = state.render_size.y != 0 ? std::min(state.render_size.y, color_extent.y) : color_extent.y;
             dispatch_description.cameraFar = state.camera_info.far_plane;
             dispatch_description.cameraNear = state.camera_info.near_plane;
             dispatch_description.cameraFovAngleVertical = state.camera_info.vertical_fov;
@@ -14,6 +14,8 @@ struct Fsr2State {
     bool should_reset = {};
     daxa_f32 delta_time = {};
     daxa_f32vec2 jitter = {};
+    // The active part of the render-resolution inputs, or the whole image when zero
+    daxa_u32vec2 render_size = {};
 
     bool should_sharpen = {};
     daxa_f32 sharpening = 0.0f;
@@ -30,7 +32,7 @@ struct Fsr2Renderer {
     daxa::Device device;
     Fsr2State state;
     Fsr2Info info;
-    size_t jitter_frame_i;
+    size_t jitter_frame_i{};
 
     FfxFsr2Context fsr_context = {};
     FfxFsr2ContextDescription context_description = {};
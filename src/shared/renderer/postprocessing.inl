@@ -107,7 +107,7 @@ inline auto light_gbuffer(
     daxa::TaskImageView sky_lut,
     daxa::TaskImageView transmittance_lut) -> daxa::TaskImageView {
 
-    auto output_image = record_ctx.task_graph.create_transient_image({
+    auto output_image = record_ctx.create_transient_image({
         .format = daxa::Format::R16G16B16A16_SFLOAT,
         .size = {record_ctx.render_resolution.x, record_ctx.render_resolution.y, 1},
         .name = "composited_image",
@@ -141,7 +141,8 @@ inline auto light_gbuffer(
             push.output_tex_size.w = 1.0f / push.output_tex_size.y;
             set_push_constant(ti, push);
             // assert((render_size.x % 8) == 0 && (render_size.y % 8) == 0);
-            ti.recorder.dispatch({(image_info.size.x + 7) / 8, (image_info.size.y + 7) / 8});
+            auto const extent = active_render_extent(image_info.size);
+            ti.recorder.dispatch({(extent.x + 7) / 8, (extent.y + 7) / 8});
         },
     });
 
@@ -333,7 +334,9 @@ struct PostProcessor {
         record_ctx.task_graph.use_persistent_buffer(task_histogram_buffer);
         auto blur_pyramid = ::blur_pyramid(record_ctx, input_image, image_size);
         calculate_luminance_histogram(record_ctx, blur_pyramid, task_histogram_buffer, image_size);
-        auto rev_blur_pyramid = ::rev_blur_pyramid(record_ctx, blur_pyramid, image_size);
+        // Nothing consumes the reverse pyramid yet, so it's culled unless pinned for debugging
+        auto rev_pyramid = ::rev_blur_pyramid(record_ctx, blur_pyramid, image_size);
+        AppUi::DebugDisplay::s_instance->passes.push_back({.name = "rev_blur_pyramid", .task_image_id = rev_pyramid, .type = DEBUG_IMAGE_TYPE_DEFAULT});
         return blur_pyramid;
     }
 };
@@ -96,7 +96,7 @@ struct ShadowDenoiser {
     auto denoise_shadow_mask(RecordContext &record_ctx, GbufferDepth const &gbuffer_depth, daxa::TaskImageView shadow_mask, daxa::TaskImageView reprojection_map) -> daxa::TaskImageView {
         auto bitpacked_shadow_mask_extent = daxa_u32vec2{(record_ctx.render_resolution.x + 7) / 8, (record_ctx.render_resolution.y + 3) / 4};
 
-        auto bitpacked_shadows_image = record_ctx.task_graph.create_transient_image({
+        auto bitpacked_shadows_image = record_ctx.create_transient_image({
             .format = daxa::Format::R32_UINT,
             .size = {bitpacked_shadow_mask_extent.x, bitpacked_shadow_mask_extent.y, 1},
             .name = "bitpacked_shadows_image",
@@ -130,7 +130,6 @@ struct ShadowDenoiser {
             },
         });
 
-        ping_pong_moments_image = PingPongImage{};
         auto [moments_image, prev_moments_image] = ping_pong_moments_image.get(
             record_ctx.device,
             {
@@ -142,7 +141,6 @@ struct ShadowDenoiser {
         record_ctx.task_graph.use_persistent_image(moments_image);
         record_ctx.task_graph.use_persistent_image(prev_moments_image);
 
-        ping_pong_accum_image = PingPongImage{};
         auto [accum_image, prev_accum_image] = ping_pong_accum_image.get(
             record_ctx.device,
             {
@@ -154,20 +152,22 @@ struct ShadowDenoiser {
         record_ctx.task_graph.use_persistent_image(accum_image);
         record_ctx.task_graph.use_persistent_image(prev_accum_image);
 
-        clear_task_images(record_ctx.device, std::array{prev_moments_image, prev_accum_image});
+        if (ping_pong_moments_image.was_recreated || ping_pong_accum_image.was_recreated) {
+            clear_task_images(record_ctx.device, std::array{prev_moments_image, prev_accum_image});
+        }
 
-        auto spatial_input_image = record_ctx.task_graph.create_transient_image({
+        auto spatial_input_image = record_ctx.create_transient_image({
             .format = daxa::Format::R16G16_SFLOAT,
             .size = {record_ctx.render_resolution.x, record_ctx.render_resolution.y, 1},
             .name = "spatial_input_image",
         });
-        auto shadow_denoise_intermediary_1 = record_ctx.task_graph.create_transient_image({
+        auto shadow_denoise_intermediary_1 = record_ctx.create_transient_image({
             .format = daxa::Format::R16G16_SFLOAT,
             .size = {record_ctx.render_resolution.x, record_ctx.render_resolution.y, 1},
             .name = "shadow_denoise_intermediary_1",
         });
 
-        auto metadata_image = record_ctx.task_graph.create_transient_image({
+        auto metadata_image = record_ctx.create_transient_image({
             .format = daxa::Format::R32_UINT,
             .size = {bitpacked_shadow_mask_extent.x, bitpacked_shadow_mask_extent.y, 1},
             .name = "metadata_image",
@@ -128,7 +128,7 @@ struct SkyRenderer {
         auto sky_cube = task_sky_cube.view().view({.layer_count = 6});
         auto ibl_cube = task_ibl_cube.view().view({.layer_count = 6});
 
-        record_ctx.task_graph.add_task({
+        record_ctx.add_task({
             .attachments = {
                 daxa::inl_atch(daxa::TaskImageAccess::TRANSFER_READ, daxa::ImageViewType::REGULAR_2D, input_sky_cube),
                 daxa::inl_atch(daxa::TaskImageAccess::TRANSFER_WRITE, daxa::ImageViewType::REGULAR_2D, sky_cube),
@@ -155,9 +155,10 @@ struct SkyRenderer {
                 daxa::TaskViewVariant{std::pair{IblCubeCompute::ibl_cube, ibl_cube}},
             },
             .callback_ = [](daxa::TaskInterface const &ti, daxa::ComputePipeline &pipeline, IblCubeComputePush &push, NoTaskInfo const &) {
+                auto const image_info = ti.device.info_image(ti.get(IblCubeCompute::ibl_cube).ids[0]).value();
                 ti.recorder.set_pipeline(pipeline);
                 set_push_constant(ti, push);
-                ti.recorder.dispatch({(IBL_CUBE_RES + 7) / 8, (IBL_CUBE_RES + 7) / 8, 6});
+                ti.recorder.dispatch({(image_info.size.x + 7) / 8, (image_info.size.y + 7) / 8, 6});
             },
         });
     }
@@ -168,19 +169,19 @@ inline auto generate_procedural_sky(RecordContext &record_ctx) -> std::array<dax
 #else
 inline auto generate_procedural_sky(RecordContext &record_ctx) -> daxa::TaskImageView {
 #endif
-    auto transmittance_lut = record_ctx.task_graph.create_transient_image({
+    auto transmittance_lut = record_ctx.create_transient_image({
         .format = daxa::Format::R16G16B16A16_SFLOAT,
-        .size = {SKY_TRANSMITTANCE_RES.x, SKY_TRANSMITTANCE_RES.y, 1},
+        .size = {record_ctx.tunables.sky_transmittance_res.x, record_ctx.tunables.sky_transmittance_res.y, 1},
         .name = "transmittance_lut",
     });
-    auto multiscattering_lut = record_ctx.task_graph.create_transient_image({
+    auto multiscattering_lut = record_ctx.create_transient_image({
         .format = daxa::Format::R16G16B16A16_SFLOAT,
-        .size = {SKY_MULTISCATTERING_RES.x, SKY_MULTISCATTERING_RES.y, 1},
+        .size = {record_ctx.tunables.sky_multiscattering_res.x, record_ctx.tunables.sky_multiscattering_res.y, 1},
         .name = "multiscattering_lut",
     });
-    auto sky_lut = record_ctx.task_graph.create_transient_image({
+    auto sky_lut = record_ctx.create_transient_image({
         .format = daxa::Format::R16G16B16A16_SFLOAT,
-        .size = {SKY_SKY_RES.x, SKY_SKY_RES.y, 1},
+        .size = {record_ctx.tunables.sky_sky_res.x, record_ctx.tunables.sky_sky_res.y, 1},
         .name = "sky_lut",
     });
 
@@ -191,9 +192,10 @@ inline auto generate_procedural_sky(RecordContext &record_ctx) -> daxa::TaskImag
             daxa::TaskViewVariant{std::pair{SkyTransmittanceCompute::transmittance_lut, transmittance_lut}},
         },
         .callback_ = [](daxa::TaskInterface const &ti, daxa::ComputePipeline &pipeline, SkyTransmittanceComputePush &push, NoTaskInfo const &) {
+            auto const image_info = ti.device.info_image(ti.get(SkyTransmittanceCompute::transmittance_lut).ids[0]).value();
             ti.recorder.set_pipeline(pipeline);
             set_push_constant(ti, push);
-            ti.recorder.dispatch({(SKY_TRANSMITTANCE_RES.x + 7) / 8, (SKY_TRANSMITTANCE_RES.y + 3) / 4});
+            ti.recorder.dispatch({(image_info.size.x + 7) / 8, (image_info.size.y + 3) / 4});
         },
     });
     record_ctx.add(ComputeTask<SkyMultiscatteringCompute, SkyMultiscatteringComputePush, NoTaskInfo>{
@@ -204,9 +206,10 @@ inline auto generate_procedural_sky(RecordContext &record_ctx) -> daxa::TaskImag
             daxa::TaskViewVariant{std::pair{SkyMultiscatteringCompute::multiscattering_lut, multiscattering_lut}},
         },
         .callback_ = [](daxa::TaskInterface const &ti, daxa::ComputePipeline &pipeline, SkyMultiscatteringComputePush &push, NoTaskInfo const &) {
+            auto const image_info = ti.device.info_image(ti.get(SkyMultiscatteringCompute::multiscattering_lut).ids[0]).value();
             ti.recorder.set_pipeline(pipeline);
             set_push_constant(ti, push);
-            ti.recorder.dispatch({SKY_MULTISCATTERING_RES.x, SKY_MULTISCATTERING_RES.y});
+            ti.recorder.dispatch({image_info.size.x, image_info.size.y});
         },
     });
     record_ctx.add(ComputeTask<SkySkyCompute, SkySkyComputePush, NoTaskInfo>{
@@ -218,9 +221,10 @@ inline auto generate_procedural_sky(RecordContext &record_ctx) -> daxa::TaskImag
             daxa::TaskViewVariant{std::pair{SkySkyCompute::sky_lut, sky_lut}},
         },
         .callback_ = [](daxa::TaskInterface const &ti, daxa::ComputePipeline &pipeline, SkySkyComputePush &push, NoTaskInfo const &) {
+            auto const image_info = ti.device.info_image(ti.get(SkySkyCompute::sky_lut).ids[0]).value();
             ti.recorder.set_pipeline(pipeline);
             set_push_constant(ti, push);
-            ti.recorder.dispatch({(SKY_SKY_RES.x + 7) / 8, (SKY_SKY_RES.y + 3) / 4});
+            ti.recorder.dispatch({(image_info.size.x + 7) / 8, (image_info.size.y + 3) / 4});
         },
     });
 
@@ -228,9 +232,9 @@ inline auto generate_procedural_sky(RecordContext &record_ctx) -> daxa::TaskImag
     AppUi::DebugDisplay::s_instance->passes.push_back({.name = "multiscattering_lut", .task_image_id = multiscattering_lut, .type = DEBUG_IMAGE_TYPE_DEFAULT});
     AppUi::DebugDisplay::s_instance->passes.push_back({.name = "sky_lut", .task_image_id = sky_lut, .type = DEBUG_IMAGE_TYPE_DEFAULT});
 
-    auto sky_cube = record_ctx.task_graph.create_transient_image({
+    auto sky_cube = record_ctx.create_transient_image({
         .format = daxa::Format::R16G16B16A16_SFLOAT,
-        .size = {SKY_CUBE_RES, SKY_CUBE_RES, 1},
+        .size = {record_ctx.tunables.sky_cube_res, record_ctx.tunables.sky_cube_res, 1},
         .array_layer_count = 6,
         .name = "procedural_sky_cube",
     });
@@ -245,9 +249,10 @@ inline auto generate_procedural_sky(RecordContext &record_ctx) -> daxa::TaskImag
             daxa::TaskViewVariant{std::pair{SkyCubeCompute::sky_cube, sky_cube}},
         },
         .callback_ = [](daxa::TaskInterface const &ti, daxa::ComputePipeline &pipeline, SkyCubeComputePush &push, NoTaskInfo const &) {
+            auto const image_info = ti.device.info_image(ti.get(SkyCubeCompute::sky_cube).ids[0]).value();
             ti.recorder.set_pipeline(pipeline);
             set_push_constant(ti, push);
-            ti.recorder.dispatch({(SKY_CUBE_RES + 7) / 8, (SKY_CUBE_RES + 7) / 8, 6});
+            ti.recorder.dispatch({(image_info.size.x + 7) / 8, (image_info.size.y + 7) / 8, 6});
         },
     });
 
@@ -255,9 +260,9 @@ inline auto generate_procedural_sky(RecordContext &record_ctx) -> daxa::TaskImag
 
 #if IMMEDIATE_SKY
 
-    auto ibl_cube = record_ctx.task_graph.create_transient_image({
+    auto ibl_cube = record_ctx.create_transient_image({
         .format = daxa::Format::R16G16B16A16_SFLOAT,
-        .size = {IBL_CUBE_RES, IBL_CUBE_RES, 1},
+        .size = {record_ctx.tunables.ibl_cube_res, record_ctx.tunables.ibl_cube_res, 1},
         .array_layer_count = 6,
         .name = "ibl_cube",
     });
@@ -270,9 +275,10 @@ inline auto generate_procedural_sky(RecordContext &record_ctx) -> daxa::TaskImag
             daxa::TaskViewVariant{std::pair{IblCubeCompute::ibl_cube, ibl_cube}},
         },
         .callback_ = [](daxa::TaskInterface const &ti, daxa::ComputePipeline &pipeline, IblCubeComputePush &push, NoTaskInfo const &) {
+            auto const image_info = ti.device.info_image(ti.get(IblCubeCompute::ibl_cube).ids[0]).value();
             ti.recorder.set_pipeline(pipeline);
             set_push_constant(ti, push);
-            ti.recorder.dispatch({(IBL_CUBE_RES + 7) / 8, (IBL_CUBE_RES + 7) / 8, 6});
+            ti.recorder.dispatch({(image_info.size.x + 7) / 8, (image_info.size.y + 7) / 8, 6});
         },
     });
 
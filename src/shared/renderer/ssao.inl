@@ -98,7 +98,6 @@ struct SsaoRenderer {
     auto render(RecordContext &record_ctx, GbufferDepth &gbuffer_depth, daxa::TaskImageView reprojection_map) -> daxa::TaskImageView {
         auto scaled_depth_image = gbuffer_depth.get_downscaled_depth(record_ctx);
         auto scaled_view_normal_image = gbuffer_depth.get_downscaled_view_normal(record_ctx);
-        ping_pong_ssao_image = PingPongImage{};
         auto [ssao_image, prev_ssao_image] = ping_pong_ssao_image.get(
             record_ctx.device,
             {
@@ -108,21 +107,23 @@ struct SsaoRenderer {
                 .name = "ssao_image",
             });
 
-        clear_task_images(record_ctx.device, std::array{prev_ssao_image});
+        if (ping_pong_ssao_image.was_recreated) {
+            clear_task_images(record_ctx.device, std::array{prev_ssao_image});
+        }
 
         record_ctx.task_graph.use_persistent_image(ssao_image);
         record_ctx.task_graph.use_persistent_image(prev_ssao_image);
-        auto ssao_image0 = record_ctx.task_graph.create_transient_image({
+        auto ssao_image0 = record_ctx.create_transient_image({
             .format = daxa::Format::R16_SFLOAT,
-            .size = {record_ctx.render_resolution.x / SHADING_SCL, record_ctx.render_resolution.y / SHADING_SCL, 1},
+            .size = {record_ctx.render_resolution.x / record_ctx.tunables.shading_scl, record_ctx.render_resolution.y / record_ctx.tunables.shading_scl, 1},
             .name = "ssao_image0",
         });
-        auto ssao_image1 = record_ctx.task_graph.create_transient_image({
+        auto ssao_image1 = record_ctx.create_transient_image({
             .format = daxa::Format::R16_SFLOAT,
-            .size = {record_ctx.render_resolution.x / SHADING_SCL, record_ctx.render_resolution.y / SHADING_SCL, 1},
+            .size = {record_ctx.render_resolution.x / record_ctx.tunables.shading_scl, record_ctx.render_resolution.y / record_ctx.tunables.shading_scl, 1},
             .name = "ssao_image1",
         });
-        auto ssao_image2 = record_ctx.task_graph.create_transient_image({
+        auto ssao_image2 = record_ctx.create_transient_image({
             .format = daxa::Format::R16_SFLOAT,
             .size = {record_ctx.render_resolution.x, record_ctx.render_resolution.y, 1},
             .name = "ssao_image2",
@@ -142,7 +143,8 @@ struct SsaoRenderer {
                 ti.recorder.set_pipeline(pipeline);
                 set_push_constant(ti, push);
                 // assert((render_size.x % 8) == 0 && (render_size.y % 8) == 0);
-                ti.recorder.dispatch({(image_info.size.x + 7) / 8, (image_info.size.y + 7) / 8});
+                auto const extent = active_render_extent(image_info.size);
+                ti.recorder.dispatch({(extent.x + 7) / 8, (extent.y + 7) / 8});
             },
         });
         record_ctx.add(ComputeTask<SsaoSpatialFilterCompute, SsaoSpatialFilterComputePush, NoTaskInfo>{
@@ -159,7 +161,8 @@ struct SsaoRenderer {
                 ti.recorder.set_pipeline(pipeline);
                 set_push_constant(ti, push);
                 // assert((render_size.x % 8) == 0 && (render_size.y % 8) == 0);
-                ti.recorder.dispatch({(image_info.size.x + 7) / 8, (image_info.size.y + 7) / 8});
+                auto const extent = active_render_extent(image_info.size);
+                ti.recorder.dispatch({(extent.x + 7) / 8, (extent.y + 7) / 8});
             },
         });
         record_ctx.add(ComputeTask<SsaoUpscaleCompute, SsaoUpscaleComputePush, NoTaskInfo>{
@@ -176,7 +179,8 @@ struct SsaoRenderer {
                 ti.recorder.set_pipeline(pipeline);
                 set_push_constant(ti, push);
                 // assert((render_size.x % 8) == 0 && (render_size.y % 8) == 0);
-                ti.recorder.dispatch({(image_info.size.x + 7) / 8, (image_info.size.y + 7) / 8});
+                auto const extent = active_render_extent(image_info.size);
+                ti.recorder.dispatch({(extent.x + 7) / 8, (extent.y + 7) / 8});
             },
         });
         record_ctx.add(ComputeTask<SsaoTemporalFilterCompute, SsaoTemporalFilterComputePush, NoTaskInfo>{
@@ -193,7 +197,8 @@ struct SsaoRenderer {
                 ti.recorder.set_pipeline(pipeline);
                 set_push_constant(ti, push);
                 // assert((render_size.x % 8) == 0 && (render_size.y % 8) == 0);
-                ti.recorder.dispatch({(image_info.size.x + 7) / 8, (image_info.size.y + 7) / 8});
+                auto const extent = active_render_extent(image_info.size);
+                ti.recorder.dispatch({(extent.x + 7) / 8, (extent.y + 7) / 8});
             },
         });
 
@@ -211,9 +211,6 @@ struct TaaRenderer {
     }
 
     auto render(RecordContext &record_ctx, daxa::TaskImageView input_image, daxa::TaskImageView depth_image, daxa::TaskImageView reprojection_map) -> daxa::TaskImageView {
-        ping_pong_taa_col_image = PingPongImage{};
-        ping_pong_taa_vel_image = PingPongImage{};
-        ping_pong_smooth_var_image = PingPongImage{};
         auto [temporal_output_tex, history_tex] = ping_pong_taa_col_image.get(
             record_ctx.device,
             {
@@ -245,12 +242,12 @@ struct TaaRenderer {
         record_ctx.task_graph.use_persistent_image(smooth_var_output_tex);
         record_ctx.task_graph.use_persistent_image(smooth_var_history_tex);
 
-        auto reprojected_history_img = record_ctx.task_graph.create_transient_image({
+        auto reprojected_history_img = record_ctx.create_transient_image({
             .format = daxa::Format::R16G16B16A16_SFLOAT,
             .size = {record_ctx.output_resolution.x, record_ctx.output_resolution.y, 1},
             .name = "reprojected_history_img",
         });
-        auto closest_velocity_img = record_ctx.task_graph.create_transient_image({
+        auto closest_velocity_img = record_ctx.create_transient_image({
             .format = daxa::Format::R16G16_SFLOAT,
             .size = {record_ctx.output_resolution.x, record_ctx.output_resolution.y, 1},
             .name = "closest_velocity_img",
@@ -294,12 +291,12 @@ struct TaaRenderer {
 
         AppUi::DebugDisplay::s_instance->passes.push_back({.name = "taa reproject", .task_image_id = reprojected_history_img, .type = DEBUG_IMAGE_TYPE_DEFAULT});
 
-        auto filtered_input_img = record_ctx.task_graph.create_transient_image({
+        auto filtered_input_img = record_ctx.create_transient_image({
             .format = daxa::Format::R16G16B16A16_SFLOAT,
             .size = {record_ctx.render_resolution.x, record_ctx.render_resolution.y, 1},
             .name = "filtered_input_img",
         });
-        auto filtered_input_deviation_img = record_ctx.task_graph.create_transient_image({
+        auto filtered_input_deviation_img = record_ctx.create_transient_image({
             .format = daxa::Format::R16G16B16A16_SFLOAT,
             .size = {record_ctx.render_resolution.x, record_ctx.render_resolution.y, 1},
             .name = "filtered_input_deviation_img",
@@ -333,7 +330,7 @@ struct TaaRenderer {
 
         AppUi::DebugDisplay::s_instance->passes.push_back({.name = "taa filter input", .task_image_id = filtered_input_deviation_img, .type = DEBUG_IMAGE_TYPE_DEFAULT});
 
-        auto filtered_history_img = record_ctx.task_graph.create_transient_image({
+        auto filtered_history_img = record_ctx.create_transient_image({
             .format = daxa::Format::R16G16B16A16_SFLOAT,
             .size = {record_ctx.render_resolution.x, record_ctx.render_resolution.y, 1},
             .name = "filtered_history_img",
@@ -366,7 +363,7 @@ struct TaaRenderer {
         AppUi::DebugDisplay::s_instance->passes.push_back({.name = "taa filter history", .task_image_id = filtered_history_img, .type = DEBUG_IMAGE_TYPE_DEFAULT});
 
         auto input_prob_img = [&]() {
-            auto input_prob_img = record_ctx.task_graph.create_transient_image({
+            auto input_prob_img = record_ctx.create_transient_image({
                 .format = daxa::Format::R16_SFLOAT,
                 .size = {record_ctx.render_resolution.x, record_ctx.render_resolution.y, 1},
                 .name = "input_prob_img",
@@ -405,7 +402,7 @@ struct TaaRenderer {
 
             AppUi::DebugDisplay::s_instance->passes.push_back({.name = "taa input prob", .task_image_id = input_prob_img, .type = DEBUG_IMAGE_TYPE_DEFAULT});
 
-            auto prob_filtered1_img = record_ctx.task_graph.create_transient_image({
+            auto prob_filtered1_img = record_ctx.create_transient_image({
                 .format = daxa::Format::R16_SFLOAT,
                 .size = {record_ctx.render_resolution.x, record_ctx.render_resolution.y, 1},
                 .name = "prob_filtered1_img",
@@ -437,7 +434,7 @@ struct TaaRenderer {
 
             AppUi::DebugDisplay::s_instance->passes.push_back({.name = "taa prob filter 1", .task_image_id = prob_filtered1_img, .type = DEBUG_IMAGE_TYPE_DEFAULT});
 
-            auto prob_filtered2_img = record_ctx.task_graph.create_transient_image({
+            auto prob_filtered2_img = record_ctx.create_transient_image({
                 .format = daxa::Format::R16_SFLOAT,
                 .size = {record_ctx.render_resolution.x, record_ctx.render_resolution.y, 1},
                 .name = "prob_filtered2_img",
@@ -472,7 +469,7 @@ struct TaaRenderer {
             return prob_filtered2_img;
         }();
 
-        auto this_frame_output_img = record_ctx.task_graph.create_transient_image({
+        auto this_frame_output_img = record_ctx.create_transient_image({
             .format = daxa::Format::R16G16B16A16_SFLOAT,
             .size = {record_ctx.output_resolution.x, record_ctx.output_resolution.y, 1},
             .name = "this_frame_output_img",
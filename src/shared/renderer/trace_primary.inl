@@ -88,12 +88,12 @@ struct GbufferRenderer {
 
     auto render(RecordContext &record_ctx, VoxelWorld::Buffers &voxel_buffers, daxa::TaskBufferView simulated_voxel_particles_buffer, daxa::TaskImageView particles_image, daxa::TaskImageView particles_depth_image)
         -> std::pair<GbufferDepth &, daxa::TaskImageView> {
-        gbuffer_depth.gbuffer = record_ctx.task_graph.create_transient_image({
+        gbuffer_depth.gbuffer = record_ctx.create_transient_image({
             .format = daxa::Format::R32G32B32A32_UINT,
             .size = {record_ctx.render_resolution.x, record_ctx.render_resolution.y, 1},
             .name = "gbuffer",
         });
-        gbuffer_depth.geometric_normal = record_ctx.task_graph.create_transient_image({
+        gbuffer_depth.geometric_normal = record_ctx.create_transient_image({
             .format = daxa::Format::A2B10G10R10_UNORM_PACK32,
             .size = {record_ctx.render_resolution.x, record_ctx.render_resolution.y, 1},
             .name = "normal",
@@ -102,7 +102,6 @@ struct GbufferRenderer {
         gbuffer_depth.downscaled_view_normal = std::nullopt;
         gbuffer_depth.downscaled_depth = std::nullopt;
 
-        gbuffer_depth.depth = PingPongImage{};
         auto [depth_image, prev_depth_image] = gbuffer_depth.depth.get(
             record_ctx.device,
             {
@@ -115,15 +114,15 @@ struct GbufferRenderer {
         record_ctx.task_graph.use_persistent_image(depth_image);
         record_ctx.task_graph.use_persistent_image(prev_depth_image);
 
-        auto velocity_image = record_ctx.task_graph.create_transient_image({
+        auto velocity_image = record_ctx.create_transient_image({
             .format = daxa::Format::R16G16B16A16_SFLOAT,
             .size = {record_ctx.render_resolution.x, record_ctx.render_resolution.y, 1},
             .name = "velocity_image",
         });
 
-        auto depth_prepass_image = record_ctx.task_graph.create_transient_image({
+        auto depth_prepass_image = record_ctx.create_transient_image({
             .format = daxa::Format::R32_SFLOAT,
-            .size = {record_ctx.render_resolution.x / PREPASS_SCL, record_ctx.render_resolution.y / PREPASS_SCL, 1},
+            .size = {record_ctx.render_resolution.x / record_ctx.tunables.prepass_scl, record_ctx.render_resolution.y / record_ctx.tunables.prepass_scl, 1},
             .name = "depth_prepass_image",
         });
 
@@ -140,7 +139,8 @@ struct GbufferRenderer {
                 ti.recorder.set_pipeline(pipeline);
                 set_push_constant(ti, push);
                 // assert((render_size.x % 8) == 0 && (render_size.y % 8) == 0);
-                ti.recorder.dispatch({(image_info.size.x + 7) / 8, (image_info.size.y + 7) / 8});
+                auto const extent = active_render_extent(image_info.size);
+                ti.recorder.dispatch({(extent.x + 7) / 8, (extent.y + 7) / 8});
             },
         });
 
@@ -163,7 +163,8 @@ struct GbufferRenderer {
                 set_push_constant(ti, push);
                 // AppUi::Console::s_instance->add_log(fmt::format("1 {}, {}", image_info.size.x, image_info.size.y));
                 // assert((render_size.x % 8) == 0 && (render_size.y % 8) == 0);
-                ti.recorder.dispatch({(image_info.size.x + 7) / 8, (image_info.size.y + 7) / 8});
+                auto const extent = active_render_extent(image_info.size);
+                ti.recorder.dispatch({(extent.x + 7) / 8, (extent.y + 7) / 8});
             },
         });
 
@@ -187,7 +188,8 @@ struct GbufferRenderer {
                 ti.recorder.set_pipeline(pipeline);
                 set_push_constant(ti, push);
                 // assert((render_size.x % 8) == 0 && (render_size.y % 8) == 0);
-                ti.recorder.dispatch({(image_info.size.x + 7) / 8, (image_info.size.y + 7) / 8});
+                auto const extent = active_render_extent(image_info.size);
+                ti.recorder.dispatch({(extent.x + 7) / 8, (extent.y + 7) / 8});
             },
         });
 
@@ -30,7 +30,7 @@ daxa_ImageViewId depth_image_id = push.uses.depth_image_id;
 #if defined(__cplusplus)
 
 inline auto trace_shadows(RecordContext &record_ctx, GbufferDepth &gbuffer_depth, VoxelWorld::Buffers &voxel_buffers) -> daxa::TaskImageView {
-    auto shadow_mask = record_ctx.task_graph.create_transient_image({
+    auto shadow_mask = record_ctx.create_transient_image({
         .format = daxa::Format::R8_UNORM,
         .size = {record_ctx.render_resolution.x, record_ctx.render_resolution.y, 1},
         .name = "shadow_mask",
@@ -52,7 +52,8 @@ inline auto trace_shadows(RecordContext &record_ctx, GbufferDepth &gbuffer_depth
             ti.recorder.set_pipeline(pipeline);
             set_push_constant(ti, push);
             // assert((render_size.x % 8) == 0 && (render_size.y % 8) == 0);
-            ti.recorder.dispatch({(image_info.size.x + 7) / 8, (image_info.size.y + 7) / 8});
+            auto const extent = active_render_extent(image_info.size);
+            ti.recorder.dispatch({(extent.x + 7) / 8, (extent.y + 7) / 8});
         },
     });
 
@@ -43,19 +43,37 @@ struct SkySettings {
     DensityProfileLayer absorption_density[2];
 };
 
+// Defaults for the runtime tunables (see cpu/tunables.hpp). The shaders that read one get the actual value as a define.
+#if !defined(SKY_TRANSMITTANCE_RES)
 #define SKY_TRANSMITTANCE_RES daxa_u32vec2(256, 64)
+#endif
+#if !defined(SKY_MULTISCATTERING_RES)
 #define SKY_MULTISCATTERING_RES daxa_u32vec2(32, 32)
+#endif
+#if !defined(SKY_SKY_RES)
 #define SKY_SKY_RES daxa_u32vec2(192, 192)
+#endif
+#if !defined(SKY_CUBE_RES)
 #define SKY_CUBE_RES 2048
+#endif
+#if !defined(IBL_CUBE_RES)
 #define IBL_CUBE_RES 16
-
-#define MAX_SIMULATED_VOXEL_PARTICLES 0 // (1 << 14)
-#define MAX_RENDERED_VOXEL_PARTICLES 0  // (1 << 14)
-
+#endif
+#if !defined(PREPASS_SCL)
 #define PREPASS_SCL 2
+#endif
+#if !defined(SHADING_SCL)
 #define SHADING_SCL 2
+#endif
+#if !defined(ENABLE_TAA)
+#define ENABLE_TAA 0
+#endif
 
-#define ENABLE_TAA false
+// Sizes the chunk update list in the voxel globals. GpuInput::chunk_updates_per_frame is how much of it is used.
+#define MAX_CHUNK_UPDATES_PER_FRAME 64
+
+#define MAX_SIMULATED_VOXEL_PARTICLES 0 // (1 << 14)
+#define MAX_RENDERED_VOXEL_PARTICLES 0  // (1 << 14)
 
 #define DEBUG_IMAGE_TYPE_DEFAULT 0
 #define DEBUG_IMAGE_TYPE_DEFAULT_UINT 1
@@ -20,8 +20,6 @@
 #define PALETTES_PER_CHUNK_AXIS (CHUNK_SIZE / PALETTE_REGION_SIZE)
 #define PALETTES_PER_CHUNK (PALETTES_PER_CHUNK_AXIS * PALETTES_PER_CHUNK_AXIS * PALETTES_PER_CHUNK_AXIS)
 
-#define MAX_CHUNK_UPDATES_PER_FRAME 64
-
 #define PALETTE_ACCELERATION_STRUCTURE_SIZE_U32S 3
 // Minimum size allocation is 76 bytes, aka 19 daxa_u32s
 // This is because a palette of size 2 has 1 bit per
@@ -191,7 +191,7 @@ struct VoxelWorld : AppUi::DebugDisplayProvider {
     }
 
     void record_startup(RecordContext &record_ctx) {
-        record_ctx.task_graph.add_task({
+        record_ctx.add_task({
             .attachments = {
                 daxa::inl_atch(daxa::TaskBufferAccess::TRANSFER_WRITE, buffers.task_voxel_globals_buffer),
                 daxa::inl_atch(daxa::TaskBufferAccess::TRANSFER_WRITE, buffers.task_voxel_chunks_buffer),
@@ -223,7 +223,7 @@ struct VoxelWorld : AppUi::DebugDisplayProvider {
             .name = "clear chunk editor",
         });
 
-        record_ctx.task_graph.add_task({
+        record_ctx.add_task({
             .attachments = {
                 daxa::inl_atch(daxa::TaskBufferAccess::TRANSFER_WRITE, buffers.voxel_malloc.task_allocator_buffer),
                 // daxa::inl_atch(daxa::TaskBufferAccess::TRANSFER_WRITE, buffers.voxel_leaf_chunk_malloc.task_allocator_buffer),
@@ -254,11 +254,9 @@ struct VoxelWorld : AppUi::DebugDisplayProvider {
         return needs_realloc;
     }
 
-    void dynamic_buffers_realloc(daxa::TaskGraph &temp_task_graph, bool &needs_vram_calc) {
-        buffers.voxel_malloc.for_each_task_buffer([&temp_task_graph](auto &task_buffer) { temp_task_graph.use_persistent_buffer(task_buffer); });
-        // buffers.voxel_leaf_chunk_malloc.for_each_task_buffer([&temp_task_graph](auto &task_buffer) { temp_task_graph.use_persistent_buffer(task_buffer); });
-        // buffers.voxel_parent_chunk_malloc.for_each_task_buffer([&temp_task_graph](auto &task_buffer) { temp_task_graph.use_persistent_buffer(task_buffer); });
-        temp_task_graph.add_task({
+    // Expects `use_buffers` to have been called on the task graph
+    void dynamic_buffers_realloc(daxa::TaskGraph &task_graph, bool &needs_vram_calc) {
+        task_graph.add_task({
             .attachments = {
                 daxa::inl_atch(daxa::TaskBufferAccess::TRANSFER_READ, buffers.voxel_malloc.task_old_element_buffer),
                 daxa::inl_atch(daxa::TaskBufferAccess::TRANSFER_WRITE, buffers.voxel_malloc.task_element_buffer),
@@ -294,25 +292,29 @@ struct VoxelWorld : AppUi::DebugDisplayProvider {
     }
 
     void record_frame(RecordContext &record_ctx, daxa::TaskBufferView task_gvox_model_buffer, daxa::TaskImageView task_value_noise_image) {
-        record_ctx.add(ComputeTask<PerChunkCompute, PerChunkComputePush, NoTaskInfo>{
-            .source = daxa::ShaderFile{"voxels/impl/voxel_world.comp.glsl"},
-            .views = std::array{
-                daxa::TaskViewVariant{std::pair{PerChunkCompute::gpu_input, record_ctx.task_input_buffer}},
-                daxa::TaskViewVariant{std::pair{PerChunkCompute::gvox_model, task_gvox_model_buffer}},
-                daxa::TaskViewVariant{std::pair{PerChunkCompute::globals, record_ctx.task_globals_buffer}},
-                daxa::TaskViewVariant{std::pair{PerChunkCompute::voxel_globals, buffers.task_voxel_globals_buffer}},
-                daxa::TaskViewVariant{std::pair{PerChunkCompute::voxel_chunks, buffers.task_voxel_chunks_buffer}},
-                daxa::TaskViewVariant{std::pair{PerChunkCompute::value_noise_texture, task_value_noise_image.view({.layer_count = 256})}},
-            },
-            .callback_ = [](daxa::TaskInterface const &ti, daxa::ComputePipeline &pipeline, PerChunkComputePush &push, NoTaskInfo const &) {
-                ti.recorder.set_pipeline(pipeline);
-                set_push_constant(ti, push);
-                auto const dispatch_size = 1 << LOG2_CHUNKS_DISPATCH_SIZE;
-                ti.recorder.dispatch({dispatch_size, dispatch_size, dispatch_size * CHUNK_LOD_LEVELS});
-            },
-        });
+        // Stage 0 scores the chunks needing an update, and stage 1 elects the most urgent ones
+        for (auto const *stage : {"0", "1"}) {
+            record_ctx.add(ComputeTask<PerChunkCompute, PerChunkComputePush, NoTaskInfo>{
+                .source = daxa::ShaderFile{"voxels/impl/voxel_world.comp.glsl"},
+                .extra_defines = {{"PER_CHUNK_STAGE", stage}},
+                .views = std::array{
+                    daxa::TaskViewVariant{std::pair{PerChunkCompute::gpu_input, record_ctx.task_input_buffer}},
+                    daxa::TaskViewVariant{std::pair{PerChunkCompute::gvox_model, task_gvox_model_buffer}},
+                    daxa::TaskViewVariant{std::pair{PerChunkCompute::globals, record_ctx.task_globals_buffer}},
+                    daxa::TaskViewVariant{std::pair{PerChunkCompute::voxel_globals, buffers.task_voxel_globals_buffer}},
+                    daxa::TaskViewVariant{std::pair{PerChunkCompute::voxel_chunks, buffers.task_voxel_chunks_buffer}},
+                    daxa::TaskViewVariant{std::pair{PerChunkCompute::value_noise_texture, task_value_noise_image.view({.layer_count = 256})}},
+                },
+                .callback_ = [](daxa::TaskInterface const &ti, daxa::ComputePipeline &pipeline, PerChunkComputePush &push, NoTaskInfo const &) {
+                    ti.recorder.set_pipeline(pipeline);
+                    set_push_constant(ti, push);
+                    auto const dispatch_size = 1 << LOG2_CHUNKS_DISPATCH_SIZE;
+                    ti.recorder.dispatch({dispatch_size, dispatch_size, dispatch_size * CHUNK_LOD_LEVELS});
+                },
+            });
+        }
 
-        auto task_temp_voxel_chunks_buffer = record_ctx.task_graph.create_transient_buffer({
+        auto task_temp_voxel_chunks_buffer = record_ctx.create_transient_buffer({
             .size = sizeof(TempVoxelChunk) * MAX_CHUNK_UPDATES_PER_FRAME,
             .name = "temp_voxel_chunks_buffer",
         });
@@ -30,6 +30,8 @@ DAXA_DECL_BUFFER_PTR(VoxelParentChunk)
 struct VoxelLeafChunk {
     daxa_u32 flags;
     daxa_u32 update_index;
+    // (brush flags << 8) | priority bucket while waiting for election, otherwise 0
+    daxa_u32 update_candidate;
     daxa_u32 uniformity_bits[3];
     // 8 bytes per 8x8x8
     VoxelMalloc_ChunkLocalPageSubAllocatorState sub_allocator_state;
@@ -66,9 +68,16 @@ struct VoxelChunkUpdateInfo {
     BrushInput brush_input;
 };
 
+// Chunk updates are elected by priority bucket, see voxel_world.comp.glsl
+#define CHUNK_PRIORITY_BUCKET_N 32
+
 struct VoxelWorldGlobals {
     VoxelChunkUpdateInfo chunk_update_infos[MAX_CHUNK_UPDATES_PER_FRAME];
-    daxa_u32 chunk_update_n; // Number of chunks to update
+    daxa_u32 chunk_update_n; // Number of chunks needing an update
+    daxa_u32 visible_chunk_update_n; // Of which are in view
+    daxa_u32 chunk_elected_n; // Number of chunks to update
+    daxa_u32 chunk_cutoff_elected_n;
+    daxa_u32 chunk_priority_bucket_counts[CHUNK_PRIORITY_BUCKET_N];
     daxa_i32vec3 prev_offset;
     daxa_i32vec3 offset;
 };
@@ -93,6 +102,8 @@ DAXA_DECL_BUFFER_PTR(VoxelWorldGlobals)
 
 struct VoxelWorldOutput {
     VoxelMallocPageAllocatorGpuOutput voxel_malloc_output;
+    daxa_u32 chunk_update_n; // Chunk updates requested in the previous frame
+    daxa_u32 visible_chunk_update_n; // Of which were for chunks in view
     // VoxelLeafChunkAllocatorGpuOutput voxel_leaf_chunk_output;
     // VoxelParentChunkAllocatorGpuOutput voxel_parent_chunk_output;
 };
@@ -115,12 +115,12 @@ struct VoxelParticles {
 
     auto render(RecordContext &record_ctx) -> std::pair<daxa::TaskImageView, daxa::TaskImageView> {
         auto format = daxa::Format::R32_UINT;
-        auto raster_color_image = record_ctx.task_graph.create_transient_image({
+        auto raster_color_image = record_ctx.create_transient_image({
             .format = format,
             .size = {record_ctx.render_resolution.x, record_ctx.render_resolution.y, 1},
             .name = "raster_color_image",
         });
-        auto raster_depth_image = record_ctx.task_graph.create_transient_image({
+        auto raster_depth_image = record_ctx.create_transient_image({
             .format = daxa::Format::D32_SFLOAT,
             .size = {record_ctx.render_resolution.x, record_ctx.render_resolution.y, 1},
             .name = "raster_depth_image",